@@ -0,0 +1,17 @@
+# LZ4 is optional. It compresses the tiles of the raw tile image format.
+# Without it, these images are stored uncompressed.
+find_path(LZ4_INCLUDE_DIR lz4.h)
+find_library(LZ4_LIBRARY NAMES lz4)
+mark_as_advanced(FORCE LZ4_INCLUDE_DIR LZ4_LIBRARY)
+
+if (LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+    message(STATUS "Found LZ4 - ${LZ4_LIBRARY}")
+    set(LZ4_FOUND TRUE)
+    add_library(lz4::lz4 UNKNOWN IMPORTED)
+    set_target_properties(lz4::lz4 PROPERTIES
+        IMPORTED_LOCATION "${LZ4_LIBRARY}"
+        INTERFACE_INCLUDE_DIRECTORIES "${LZ4_INCLUDE_DIR}")
+else ()
+    message(STATUS "LZ4 not found - tile images are stored uncompressed")
+    set(LZ4_FOUND FALSE)
+endif (LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
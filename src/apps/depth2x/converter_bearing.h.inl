@@ -12,14 +12,7 @@ bool bearing_converter<Intrinsic>::process_file(
     if (!this->_files.DIRECTION.empty()) {                                     \
         math::image<float> bearing = depth_to_bearing<direction::DIRECTION>(   \
             depth_image, this->intrinsic);                                     \
-        cv::Mat img;                                                           \
-        if (this->_files.saveAs16Bit) {                                        \
-            img = convert_bearing<float, ushort>(bearing).data();              \
-        } else {                                                               \
-            img = convert_bearing<float, uchar>(bearing).data();               \
-        }                                                                      \
-        bool success =                                                         \
-            cv::imwrite(fmt::format(this->_files.DIRECTION, idx), img);        \
+        bool success = write_bearing(bearing, this->_files.DIRECTION, idx);    \
         final_result &= success;                                               \
     }
 
@@ -32,3 +25,83 @@ bool bearing_converter<Intrinsic>::process_file(
 
     return final_result;
 }
+
+template <typename Intrinsic>
+void bearing_converter<Intrinsic>::schedule_file(
+    const math::image<float>& depth_image,
+    int                       idx,
+    tf::Subflow&              sf,
+    file_writer&              writer) const noexcept {
+    Expects(!this->_files.horizontal.empty() ||
+            !this->_files.vertical.empty() || !this->_files.diagonal.empty() ||
+            !this->_files.antidiagonal.empty());
+    using namespace sens_loc::conversion;
+
+    // The tasks run after this function returned, the frame owns their data.
+    struct frame_data {
+        math::image<float> depth;
+        math::image<float> horizontal;
+        math::image<float> vertical;
+        math::image<float> diagonal;
+        math::image<float> antidiagonal;
+    };
+    auto frame   = std::make_shared<frame_data>();
+    frame->depth = depth_image;
+
+    tf::Task join = sf.emplace([this, frame, idx, &writer]() mutable {
+        writer = [this, frame, idx] {
+            bool final_result = true;
+            if (!this->_files.horizontal.empty())
+                final_result &= write_bearing(frame->horizontal,
+                                              this->_files.horizontal, idx);
+            if (!this->_files.vertical.empty())
+                final_result &= write_bearing(frame->vertical,
+                                              this->_files.vertical, idx);
+            if (!this->_files.diagonal.empty())
+                final_result &= write_bearing(frame->diagonal,
+                                              this->_files.diagonal, idx);
+            if (!this->_files.antidiagonal.empty())
+                final_result &= write_bearing(frame->antidiagonal,
+                                              this->_files.antidiagonal, idx);
+            return final_result;
+        };
+        // The writer keeps the images alive, not the graph.
+        frame.reset();
+    });
+
+#define BEARING_SCHEDULE(DIRECTION)                                            \
+    if (!this->_files.DIRECTION.empty()) {                                     \
+        frame->DIRECTION = blank_like(depth_image);                            \
+        const tf::Task calculated =                                            \
+            par_depth_to_bearing<direction::DIRECTION>(                        \
+                frame->depth, this->intrinsic, frame->DIRECTION, sf)           \
+                .second;                                                       \
+        join.succeed(calculated);                                              \
+    }
+
+    BEARING_SCHEDULE(horizontal)
+    BEARING_SCHEDULE(vertical)
+    BEARING_SCHEDULE(diagonal)
+    BEARING_SCHEDULE(antidiagonal)
+
+#undef BEARING_SCHEDULE
+}
+
+template <typename Intrinsic>
+bool bearing_converter<Intrinsic>::write_bearing(
+    const math::image<float>& bearing,
+    const std::string&        pattern,
+    int                       idx) const noexcept {
+    using namespace sens_loc::conversion;
+
+    cv::Mat img;
+    if (this->float_output(pattern)) {
+        img = bearing.data();
+    } else if (this->_files.saveAs16Bit) {
+        img = convert_bearing<float, ushort>(bearing).data();
+    } else {
+        img = convert_bearing<float, uchar>(bearing).data();
+    }
+    return io::write_image(fmt::format(pattern, idx), img,
+                           this->_files.encoding);
+}
@@ -6,17 +6,44 @@ bool gauss_curv_converter<Intrinsic>::process_file(
 
     const auto gauss =
         depth_to_gaussian_curvature(depth_image, this->intrinsic);
+    return write_curvature(gauss, depth_image, idx);
+}
+
+template <typename Intrinsic>
+void gauss_curv_converter<Intrinsic>::schedule_file(
+    const math::image<float>& depth_image,
+    int                       idx,
+    tf::Subflow& /*sf*/,
+    file_writer& writer) const noexcept {
+    Expects(!this->_files.output.empty());
+    using namespace conversion;
+
+    writer = [this,
+              gauss = depth_to_gaussian_curvature(depth_image, this->intrinsic),
+              depth = depth_image, idx] {
+        return write_curvature(gauss, depth, idx);
+    };
+}
+
+template <typename Intrinsic>
+bool gauss_curv_converter<Intrinsic>::write_curvature(
+    const math::image<float>& gauss,
+    const math::image<float>& depth_image,
+    int                       idx) const noexcept {
     bool success;
-    if (this->_files.saveAs16Bit) {
+    if (this->float_output(this->_files.output)) {
+        success = io::write_image(fmt::format(this->_files.output, idx),
+                                  gauss.data(), this->_files.encoding);
+    } else if (this->_files.saveAs16Bit) {
         const auto converted = conversion::curvature_to_image<ushort>(
             gauss, depth_image, {lower_bound}, {upper_bound});
-        success =
-            cv::imwrite(fmt::format(this->_files.output, idx), converted.data());
+        success = io::write_image(fmt::format(this->_files.output, idx),
+                                  converted.data(), this->_files.encoding);
     } else {
         const auto converted = conversion::curvature_to_image<uchar>(
             gauss, depth_image, {lower_bound}, {upper_bound});
-        success =
-            cv::imwrite(fmt::format(this->_files.output, idx), converted.data());
+        success = io::write_image(fmt::format(this->_files.output, idx),
+                                  converted.data(), this->_files.encoding);
     }
 
     return success;
@@ -29,10 +56,39 @@ bool mean_curv_converter<Intrinsic>::process_file(
     using namespace conversion;
 
     const auto mean = depth_to_mean_curvature(depth_image, this->intrinsic);
+    return write_curvature(mean, depth_image, idx);
+}
+
+template <typename Intrinsic>
+void mean_curv_converter<Intrinsic>::schedule_file(
+    const math::image<float>& depth_image,
+    int                       idx,
+    tf::Subflow& /*sf*/,
+    file_writer& writer) const noexcept {
+    Expects(!this->_files.output.empty());
+    using namespace conversion;
+
+    writer = [this,
+              mean  = depth_to_mean_curvature(depth_image, this->intrinsic),
+              depth = depth_image, idx] {
+        return write_curvature(mean, depth, idx);
+    };
+}
+
+template <typename Intrinsic>
+bool mean_curv_converter<Intrinsic>::write_curvature(
+    const math::image<float>& mean,
+    const math::image<float>& depth_image,
+    int                       idx) const noexcept {
+    if (this->float_output(this->_files.output))
+        return io::write_image(fmt::format(this->_files.output, idx),
+                               mean.data(), this->_files.encoding);
+
     const auto converted = conversion::curvature_to_image<ushort>(
         mean, depth_image, {lower_bound}, {upper_bound});
     const bool success =
-        cv::imwrite(fmt::format(this->_files.output, idx), converted.data());
+        io::write_image(fmt::format(this->_files.output, idx),
+                        converted.data(), this->_files.encoding);
 
     return success;
 }
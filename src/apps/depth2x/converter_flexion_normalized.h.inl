@@ -4,14 +4,57 @@ bool flexion_converter_normalized<Intrinsic>::process_file(
     Expects(!this->_files.output.empty());
     using namespace conversion;
 
-    const auto flexion = depth_to_flexion_normalized(depth_image, this->intrinsic);
+    const auto flexion =
+        depth_to_flexion_normalized(depth_image, this->intrinsic);
+    return write_flexion(flexion, idx);
+}
+
+template <typename Intrinsic>
+void flexion_converter_normalized<Intrinsic>::schedule_file(
+    const math::image<float>& depth_image,
+    int                       idx,
+    tf::Subflow&              sf,
+    file_writer&              writer) const noexcept {
+    Expects(!this->_files.output.empty());
+    using namespace conversion;
+
+    // The tasks run after this function returned, the frame owns their data.
+    struct frame_data {
+        math::image<float> depth;
+        math::image<float> flexion;
+    };
+    auto frame = std::make_shared<frame_data>(
+        frame_data{depth_image, blank_like(depth_image)});
+
+    const tf::Task calculated =
+        par_depth_to_flexion_normalized(frame->depth, this->intrinsic,
+                                        frame->flexion, sf)
+            .second;
+
+    sf.emplace([this, frame, idx, &writer]() mutable {
+          writer = [this, frame, idx] {
+              return write_flexion(frame->flexion, idx);
+          };
+          // The writer keeps the images alive, not the graph.
+          frame.reset();
+      }).succeed(calculated);
+}
+
+template <typename Intrinsic>
+bool flexion_converter_normalized<Intrinsic>::write_flexion(
+    const math::image<float>& flexion, int idx) const noexcept {
+    using namespace conversion;
+
     cv::Mat img;
-    if (this->_files.saveAs16Bit) {
+    if (this->float_output(this->_files.output)) {
+        img = flexion.data();
+    } else if (this->_files.saveAs16Bit) {
         img = convert_flexion<ushort>(flexion).data();
     } else {
         img = convert_flexion<uchar>(flexion).data();
     }
-    const bool success = cv::imwrite(fmt::format(this->_files.output, idx), img);
+    const bool success = io::write_image(fmt::format(this->_files.output, idx),
+                                         img, this->_files.encoding);
 
     return success;
 }
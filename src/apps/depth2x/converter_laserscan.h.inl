@@ -2,20 +2,42 @@ template <typename Intrinsic>
 bool range_converter<Intrinsic>::process_file(
     const math::image<float>& depth_image, int idx) const noexcept {
     Expects(!this->_files.output.empty());
+    return write_range(depth_image, idx);
+}
+
+template <typename Intrinsic>
+void range_converter<Intrinsic>::schedule_file(
+    const math::image<float>& depth_image,
+    int                       idx,
+    tf::Subflow& /*sf*/,
+    file_writer& writer) const noexcept {
+    Expects(!this->_files.output.empty());
+    // The writer keeps the image alive and converts it while encoding.
+    writer = [this, range = depth_image, idx] {
+        return write_range(range, idx);
+    };
+}
+
+template <typename Intrinsic>
+bool range_converter<Intrinsic>::write_range(const math::image<float>& range,
+                                             int idx) const noexcept {
     using namespace conversion;
 
     /// The input 'depth_image' is already in range-form as its beeing
     /// preprocessed.
     cv::Mat depth;
-    if (this->_files.saveAs16Bit) {
-        depth = cv::Mat(depth_image.h(), depth_image.w(), CV_16U);
-        depth_image.data().convertTo(depth, CV_16U);
+    if (this->float_output(this->_files.output)) {
+        depth = range.data();
+    } else if (this->_files.saveAs16Bit) {
+        depth = cv::Mat(range.h(), range.w(), CV_16U);
+        range.data().convertTo(depth, CV_16U);
     } else {
-        depth = cv::Mat(depth_image.h(), depth_image.w(), CV_8U);
-        depth_image.data().convertTo(depth, CV_8U);
+        depth = cv::Mat(range.h(), range.w(), CV_8U);
+        range.data().convertTo(depth, CV_8U);
     }
     bool success =
-        cv::imwrite(fmt::format(this->_files.output, idx), depth);
+        io::write_image(fmt::format(this->_files.output, idx), depth,
+                        this->_files.encoding);
 
     return success;
 }
@@ -5,14 +5,39 @@ bool max_curve_converter<Intrinsic>::process_file(
     using namespace conversion;
 
     const auto max_curve = depth_to_max_curve(depth_image, this->intrinsic);
+    return write_max_curve(max_curve, idx);
+}
+
+template <typename Intrinsic>
+void max_curve_converter<Intrinsic>::schedule_file(
+    const math::image<float>& depth_image,
+    int                       idx,
+    tf::Subflow& /*sf*/,
+    file_writer& writer) const noexcept {
+    Expects(!this->_files.output.empty());
+    using namespace conversion;
+
+    writer = [this,
+              max_curve = depth_to_max_curve(depth_image, this->intrinsic),
+              idx] { return write_max_curve(max_curve, idx); };
+}
+
+template <typename Intrinsic>
+bool max_curve_converter<Intrinsic>::write_max_curve(
+    const math::image<float>& max_curve, int idx) const noexcept {
+    using namespace conversion;
+
     cv::Mat img;
-    if (this->_files.saveAs16Bit) {
+    if (this->float_output(this->_files.output)) {
+        img = max_curve.data();
+    } else if (this->_files.saveAs16Bit) {
         img = convert_max_curve<ushort>(max_curve).data();
     } else {
         img = convert_max_curve<uchar>(max_curve).data();
     }
     const bool success =
-        cv::imwrite(fmt::format(this->_files.output, idx), img);
+        io::write_image(fmt::format(this->_files.output, idx), img,
+                        this->_files.encoding);
 
     return success;
 }
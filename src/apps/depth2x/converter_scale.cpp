@@ -1,8 +1,8 @@
 #include "converter_scale.h"
 
 #include <fmt/core.h>
-#include <opencv2/imgcodecs.hpp>
 #include <sens_loc/conversion/depth_scaling.h>
+#include <sens_loc/io/image.h>
 
 namespace sens_loc::apps {
 
@@ -10,17 +10,35 @@ bool scale_converter::process_file(const math::image<float>& depth_image,
                                    int idx) const noexcept {
     Expects(!_files.output.empty());
     using namespace sens_loc::conversion;
-    const auto res = depth_scaling(depth_image, _scale, _offset);
+    return write_scaled(depth_scaling(depth_image, _scale, _offset), idx);
+}
+
+void scale_converter::schedule_file(const math::image<float>& depth_image,
+                                    int                       idx,
+                                    tf::Subflow& /*sf*/,
+                                    file_writer& writer) const noexcept {
+    Expects(!_files.output.empty());
+    using namespace sens_loc::conversion;
+    writer = [this, res = depth_scaling(depth_image, _scale, _offset), idx] {
+        return write_scaled(res, idx);
+    };
+}
+
+bool scale_converter::write_scaled(const math::image<float>& res,
+                                   int idx) const noexcept {
     cv::Mat depth;
-    if (this->_files.saveAs16Bit) {
-        depth = cv::Mat(depth_image.h(), depth_image.w(), CV_16U);
+    if (float_output(_files.output)) {
+        depth = res.data();
+    } else if (this->_files.saveAs16Bit) {
+        depth = cv::Mat(res.h(), res.w(), CV_16U);
         res.data().convertTo(depth, CV_16U);
     } else {
-        depth = cv::Mat(depth_image.h(), depth_image.w(), CV_8U);
+        depth = cv::Mat(res.h(), res.w(), CV_8U);
         res.data().convertTo(depth, CV_8U);
     }
 
-    bool success = cv::imwrite(fmt::format(_files.output, idx), depth);
+    bool success = io::write_image(fmt::format(_files.output, idx), depth,
+                                   _files.encoding);
 
     return success;
 }
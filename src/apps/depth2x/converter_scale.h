@@ -28,6 +28,13 @@ class scale_converter : public batch_converter {
 
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_scaled(const math::image<float>& res,
+                                    int idx) const noexcept;
 };
 /// @}
 }  // namespace sens_loc::apps
@@ -12,6 +12,10 @@
 #include <sens_loc/conversion/depth_to_flexion_angle.h>
 #include <sens_loc/conversion/depth_to_laserscan.h>
 #include <sens_loc/conversion/depth_to_max_curve.h>
+#include <sens_loc/io/image.h>
+#include <memory>
+#include <string>
+#include <taskflow/taskflow.hpp>
 #include <util/batch_converter.h>
 
 namespace sens_loc::apps {
@@ -19,6 +23,14 @@ namespace sens_loc::apps {
 /// \addtogroup conversion-driver
 /// @{
 
+/// \returns zero initialized image with the dimensions of \p depth_image,
+/// used as output for the \c conversion::par_depth_to_* functions.
+inline math::image<float> blank_like(const math::image<float>& depth_image) {
+    cv::Mat blank(depth_image.h(), depth_image.w(), CV_32F);
+    blank = 0.F;
+    return math::image<float>(std::move(blank));
+}
+
 /// Batch conversion to bearing-angle images.
 /// \sa conversion::depth_to_bearing
 template <typename Intrinsic>
@@ -43,6 +55,24 @@ class bearing_converter : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_bearing(const math::image<float>& bearing,
+                                     const std::string&        pattern,
+                                     int                       idx) const
+        noexcept;
+
+    /// All requested directions are in flight at the same time.
+    [[nodiscard]] std::size_t result_images() const noexcept override {
+        const file_patterns& f = this->_files;
+        return std::size_t(!f.horizontal.empty()) +
+               std::size_t(!f.vertical.empty()) +
+               std::size_t(!f.diagonal.empty()) +
+               std::size_t(!f.antidiagonal.empty());
+    }
 };
 #include "converter_bearing.h.inl"
 
@@ -64,6 +94,13 @@ class range_converter : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_range(const math::image<float>& range,
+                                   int idx) const noexcept;
 };
 #include "converter_laserscan.h.inl"
 
@@ -92,6 +129,18 @@ class gauss_curv_converter : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_curvature(const math::image<float>& gauss,
+                                       const math::image<float>& depth_image,
+                                       int idx) const noexcept;
+    /// The curvature and the masked image for the conversion.
+    [[nodiscard]] std::size_t result_images() const noexcept override {
+        return 2UL;
+    }
 
     double lower_bound;
     double upper_bound;
@@ -122,6 +171,18 @@ class mean_curv_converter : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_curvature(const math::image<float>& mean,
+                                       const math::image<float>& depth_image,
+                                       int idx) const noexcept;
+    /// The curvature and the masked image for the conversion.
+    [[nodiscard]] std::size_t result_images() const noexcept override {
+        return 2UL;
+    }
 
     double lower_bound;
     double upper_bound;
@@ -146,6 +207,13 @@ class max_curve_converter : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_max_curve(const math::image<float>& max_curve,
+                                       int idx) const noexcept;
 };
 #include "converter_max_curve.h.inl"
 
@@ -167,6 +235,13 @@ class flexion_converter : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_flexion(const math::image<float>& flexion,
+                                     int idx) const noexcept;
 };
 #include "converter_flexion.h.inl"
 
@@ -188,6 +263,13 @@ class flexion_converter_nxn : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_flexion(const math::image<float>& flexion,
+                                     int idx) const noexcept;
 };
 #include "converter_flexion_nxn.h.inl"
 
@@ -209,6 +291,13 @@ class flexion_converter_normalized : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_flexion(const math::image<float>& flexion,
+                                     int idx) const noexcept;
 };
 #include "converter_flexion_normalized.h.inl"
 
@@ -230,6 +319,13 @@ class flexion_converter_angle : public batch_sensor_converter<Intrinsic> {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] bool write_flexion(const math::image<float>& flexion,
+                                     int idx) const noexcept;
 };
 #include "converter_flexion_angle.h.inl"
 
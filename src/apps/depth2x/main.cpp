@@ -15,6 +15,8 @@
 #include <stdexcept>
 #include <string>
 #include <util/colored_parse.h>
+#include <util/output_options.h>
+#include <util/pipeline_options.h>
 #include <util/tool_macro.h>
 #include <util/version_printer.h>
 #include <variant>
@@ -113,7 +115,8 @@ MAIN_HEAD("Batch-conversion of depth images to various derived image-types.") {
 
     file_patterns files;
     app.add_option("-i,--input", files.input,
-                   "Input pattern for image, e.g. \"depth-{}.png\"")
+                   "Input pattern for image, e.g. \"depth-{}.png\", or a "
+                   "sequence container \"depth.slseq\"")
         ->required();
 
     string input_type = "pinhole-depth";
@@ -135,6 +138,10 @@ MAIN_HEAD("Batch-conversion of depth images to various derived image-types.") {
     app.add_option("-e,--end", end_idx, "End index of batch, inclusive")
         ->required();
 
+    pipeline_config pipeline;
+    add_pipeline_options(app, pipeline);
+    add_output_options(app, files.encoding);
+
     // Bearing angle images territory
     CLI::App* bearing_cmd = app.add_subcommand(
         "bearing", "Convert depth images into bearing angle images");
@@ -449,6 +456,6 @@ MAIN_HEAD("Batch-conversion of depth images to various derived image-types.") {
 
         UNREACHABLE("unexpected conversion");  // LCOV_EXCL_LINE
     }();
-    return c->process_batch(start_idx, end_idx) ? 0 : 1;
+    return c->process_batch(start_idx, end_idx, pipeline) ? 0 : 1;
 }
 MAIN_TAIL
@@ -1,22 +1,42 @@
 #include "batch_filter.h"
 
 #include <fmt/core.h>
-#include <opencv2/imgcodecs.hpp>
+#include <sens_loc/io/image.h>
 #include <sens_loc/preprocess/filter.h>
 
 namespace sens_loc::apps {
 
 bool batch_filter::process_file(const math::image<float>& depth_image,
                                 int                       idx) const noexcept {
+    return write_result(apply_filters(depth_image), idx);
+}
+
+void batch_filter::schedule_file(const math::image<float>& depth_image,
+                                 int                       idx,
+                                 tf::Subflow& /*sf*/,
+                                 file_writer& writer) const noexcept {
+    writer = [this, result = apply_filters(depth_image), idx] {
+        return write_result(result, idx);
+    };
+}
+
+math::image<float>
+batch_filter::apply_filters(const math::image<float>& depth_image) const
+    noexcept {
     // Thats a NO-OP because the type already matches, 'convert' short
     // circuits that.
     math::image<float> result = math::convert<float>(depth_image);
 
     std::for_each(std::begin(_operations), std::end(_operations),
                   [&](auto&& op) { result = op->filter(result); });
+    return result;
+}
 
-    const bool success = cv::imwrite(fmt::format(_files.output, idx),
-                                     math::convert<ushort>(result).data());
+bool batch_filter::write_result(const math::image<float>& result,
+                                int                       idx) const noexcept {
+    const bool success =
+        io::write_image(fmt::format(_files.output, idx),
+                        math::convert<ushort>(result).data(), _files.encoding);
     return success;
 }
 
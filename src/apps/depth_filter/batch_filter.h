@@ -23,6 +23,16 @@ class batch_filter : public batch_converter {
   private:
     [[nodiscard]] bool process_file(const math::image<float>& depth_image,
                                     int idx) const noexcept override;
+    /// Filters in the compute stage and defers the writing of the result.
+    void schedule_file(const math::image<float>& depth_image,
+                       int                       idx,
+                       tf::Subflow&              sf,
+                       file_writer&              writer) const noexcept override;
+
+    [[nodiscard]] math::image<float>
+    apply_filters(const math::image<float>& depth_image) const noexcept;
+    [[nodiscard]] bool write_result(const math::image<float>& result,
+                                    int idx) const noexcept;
 
     const std::vector<std::unique_ptr<abstract_filter>>& _operations;
 };
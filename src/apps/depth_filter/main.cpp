@@ -12,6 +12,8 @@
 #include <stdexcept>
 #include <util/batch_converter.h>
 #include <util/colored_parse.h>
+#include <util/output_options.h>
+#include <util/pipeline_options.h>
 #include <util/tool_macro.h>
 #include <util/version_printer.h>
 #include <vector>
@@ -53,7 +55,8 @@ MAIN_HEAD("Batch-processing tool to filter depth images and maps") {
 
     file_patterns files;
     app.add_option("-i,--input", files.input,
-                   "Input pattern for images to filter; e.g. \"depth-{}.png\"")
+                   "Input pattern for images to filter; e.g. \"depth-{}.png\" "
+                   "or a sequence container \"depth.slseq\"")
         ->required();
     app.add_option(
            "-o,--output", files.output,
@@ -66,6 +69,10 @@ MAIN_HEAD("Batch-processing tool to filter depth images and maps") {
     app.add_option("-e,--end", end_idx, "End index of batch, inclusive")
         ->required();
 
+    pipeline_config pipeline;
+    add_pipeline_options(app, pipeline);
+    add_output_options(app, files.encoding);
+
     CLI::App* bilateral_cmd = app.add_subcommand(
         "bilateral", "Apply the bilateral filter to the input.");
     bilateral_cmd->footer(
@@ -163,6 +170,6 @@ MAIN_HEAD("Batch-processing tool to filter depth images and maps") {
     // The final step is conversion to U16 and writing to disk.
     batch_filter process(files, commands);
 
-    return process.process_batch(start_idx, end_idx) ? 0 : 1;
+    return process.process_batch(start_idx, end_idx, pipeline) ? 0 : 1;
 }
 MAIN_TAIL
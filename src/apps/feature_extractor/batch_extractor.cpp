@@ -4,79 +4,212 @@
 #include <chrono>
 #include <fmt/core.h>
 #include <opencv2/core.hpp>
-#include <opencv2/core/persistence.hpp>
 #include <opencv2/features2d.hpp>
+#include <sens_loc/io/feature.h>
 #include <sens_loc/io/image.h>
 #include <sens_loc/math/image.h>
 #include <sens_loc/util/console.h>
 #include <taskflow/taskflow.hpp>
+#include <util/executor.h>
+#include <util/input_source.h>
 #include <util/parallel_processing.h>
 #include <utility>
 
 namespace sens_loc::apps {
 
 bool batch_extractor::process_batch(int start, int end) const noexcept {
+    // With less images than workers, some workers would idle. The spare
+    // threads are given to OpenCV to parallelize within each image instead.
+    // Tiled images are already processed by multiple workers.
+    const int  images  = std::abs(end - start) + 1;
+    const auto workers = int(shared_executor().num_workers());
+    const int  threads = cv::getNumThreads();
+    if (images < workers && !_tiles.enabled())
+        cv::setNumThreads(workers / images);
+    auto restore_threads =
+        gsl::finally([threads] { cv::setNumThreads(threads); });
+
     return parallel_indexed_file_processing(
-        start, end, [this](int idx) noexcept { return process_index(idx); });
+        start, end,
+        [this](int idx, tf::Subflow& sf, bool& success) noexcept {
+            process_index(idx, sf, success);
+        });
 }
 
-bool batch_extractor::process_index(int idx) const noexcept {
-    const std::string                 p = fmt::format(_input_pattern, idx);
-    std::optional<math::image<uchar>> f = io::load_as_8bit_gray(p);
+void batch_extractor::process_index(int          idx,
+                                    tf::Subflow& sf,
+                                    bool&        success) const noexcept {
+    std::string                       p = fmt::format(_input_pattern, idx);
+    std::optional<math::image<uchar>> f =
+        load_input_as_8bit_gray(std::string(_input_pattern), idx);
 
-    if (!f)
-        return false;
+    if (!f) {
+        success = false;
+        return;
+    }
+
+    if (!_tiles.enabled()) {
+        success = process_detector(*f, idx, p);
+        return;
+    }
 
-    return process_detector(*f, fmt::format(_ouput_pattern, idx), p);
+    try {
+        schedule_tiles(std::move(*f), idx, std::move(p), sf, success);
+    } catch (...) {
+        success = false;
+    }
+}
+
+void batch_extractor::schedule_tiles(math::image<uchar> image,
+                                     int                idx,
+                                     std::string        in_file,
+                                     tf::Subflow&       sf,
+                                     bool&              success) const {
+    // The tasks run after this function returned, the frame owns their data.
+    struct frame_data {
+        math::image<uchar>                     image;
+        std::string                            in_file;
+        std::vector<features::tile>            tiles;
+        std::vector<std::vector<cv::KeyPoint>> tile_keypoints;
+        std::vector<char>                      tile_success;
+    };
+    // Images smaller than the grid get less tiles.
+    const int rows = std::min(_tiles.rows, image.h());
+    const int cols = std::min(_tiles.cols, image.w());
+
+    auto frame   = std::make_shared<frame_data>();
+    frame->tiles = features::make_tiles(image.w(), image.h(), rows, cols,
+                                        _tiles.overlap);
+    frame->image   = std::move(image);
+    frame->in_file = std::move(in_file);
+    frame->tile_keypoints.resize(frame->tiles.size());
+    frame->tile_success.resize(frame->tiles.size(), 0);
+
+    // Only the merging owns the frame, the tiles are detected before it.
+    frame_data* data  = frame.get();
+    tf::Task    merge = sf.emplace([this, frame, idx, &success]() mutable {
+        // The graph of the batch is kept until the end, but not the image.
+        auto release = gsl::finally([&frame] { frame.reset(); });
+
+        success = std::all_of(frame->tile_success.begin(),
+                              frame->tile_success.end(),
+                              [](char s) { return s != 0; });
+        if (!success)
+            return;
+        try {
+            std::vector<cv::KeyPoint> keypoints =
+                features::merge_tiles(frame->tile_keypoints);
+            success = describe_and_write(frame->image, keypoints, idx,
+                                         frame->in_file);
+        } catch (...) {
+            success = false;
+        }
+    });
+
+    for (std::size_t t = 0; t < data->tiles.size(); ++t) {
+        sf.emplace([this, data, t]() {
+              try {
+                  data->tile_keypoints[t] =
+                      detect_tile(data->image, data->tiles[t]);
+                  data->tile_success[t] = 1;
+              } catch (...) {
+                  // OpenCV signals errors within the algorithms with
+                  // exceptions, the merge reports the failure.
+              }
+          }).precede(merge);
+    }
 }
 
 /// Applies \c detector to each image loaded from \c in_pattern, substituted
 /// with \c idx.
-/// The keypoints and descriptors are detected and written in a YAML-file
-/// in \c out_pattern, substituted with \c idx.
+/// The keypoints and descriptors are detected and written in a feature file
+/// in \c out_pattern, substituted with \c idx. The format of the file is
+/// determined by its extension. With a feature store, the features are
+/// appended to the store instead.
 bool batch_extractor::process_detector(const math::image<uchar>& image,
-                                       const std::string&        out_file,
+                                       int                       idx,
                                        const std::string&        in_file) const
     noexcept {
 
-    const auto [keypoints, descriptors] = compute_features(image);
-
     try {
-        using cv::FileNode;
-        using cv::FileStorage;
-
-        FileStorage fs{out_file, FileStorage::WRITE | FileStorage::FORMAT_YAML};
-        cv::write(fs, "source_path", in_file);
-        cv::write(fs, "keypoints", keypoints);
-        cv::write(fs, "descriptors", descriptors);
-
-        return true;
+        worker_state& state = local_state();
+        compute_features(image, state);
+        return describe_and_write(image, state.keypoints, idx, in_file);
     } catch (...) {
+        // OpenCV signals errors within the algorithms with exceptions.
         return false;
     }
 }
 
-std::pair<std::vector<cv::KeyPoint>, cv::Mat>
-batch_extractor::compute_features(const math::image<uchar>& img) const
-    noexcept {
+batch_extractor::worker_state& batch_extractor::local_state() const {
+    worker_state& state = _workers.local();
+    if (!state.initialized) {
+        state.detector    = _detector();
+        state.descriptor  = _descriptor();
+        state.initialized = true;
+    }
+    Ensures(!state.detector.empty());
+    return state;
+}
+
+void batch_extractor::compute_features(const math::image<uchar>& img,
+                                       worker_state&             state) const {
     using namespace std;
 
+    // The buffers keep their memory from the previous image of this worker,
+    // the images of a batch usually result in a similar number of features.
+    vector<cv::KeyPoint>& keypoints = state.keypoints;
+    keypoints.clear();
+
     // The image itself is the mask for feature detection.
     // That is the reason, because the pixels with 0 as value do not contain
     // any information on the geometry.
-    vector<cv::KeyPoint> keypoints;
-    _detector->detect(img.data(), keypoints, img.data());
+    state.detector->detect(img.data(), keypoints, img.data());
 
     // Removes every keypoint that is matched by the '_keypoint_filter'.
     for (auto&& f : _keypoint_filter) {
         auto new_end = f(keypoints);
         keypoints.erase(new_end, end(keypoints));
     }
+}
+
+std::vector<cv::KeyPoint>
+batch_extractor::detect_tile(const math::image<uchar>& img,
+                             const features::tile&     t) const {
+    using namespace std;
+
+    // The detector runs on a view into the image, no pixel is copied.
+    const cv::Mat        region = img.data()(t.region);
+    vector<cv::KeyPoint> keypoints;
+    local_state().detector->detect(region, keypoints, region);
+
+    features::to_image_coordinates(t, keypoints);
+    for (auto&& f : _keypoint_filter) {
+        auto new_end = f(keypoints);
+        keypoints.erase(new_end, end(keypoints));
+    }
+    if (_tiles.budget > 0UL)
+        keypoints.erase(features::partition_strongest(keypoints, _tiles.budget),
+                        end(keypoints));
+    return keypoints;
+}
+
+bool batch_extractor::describe_and_write(const math::image<uchar>& img,
+                                         std::vector<cv::KeyPoint>& keypoints,
+                                         int                        idx,
+                                         const std::string& in_file) const {
+    worker_state& state = local_state();
+
+    // 'compute' reallocates the descriptors only if their size changes.
+    if (!state.descriptor.empty())
+        state.descriptor->compute(img.data(), keypoints, state.descriptors);
+    else
+        state.descriptors.release();
 
-    cv::Mat descriptors;
-    if (!_descriptor.empty())
-        _descriptor->compute(img.data(), keypoints, descriptors);
+    if (_store != nullptr)
+        return _store->append(idx, in_file, keypoints, state.descriptors);
 
-    return make_pair(move(keypoints), move(descriptors));
+    return io::write_features(fmt::format(_ouput_pattern, idx), in_file,
+                              keypoints, state.descriptors, _codec);
 }
 }  // namespace sens_loc::apps
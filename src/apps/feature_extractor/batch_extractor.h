@@ -7,64 +7,142 @@
 #include <opencv2/features2d.hpp>
 #include <opencv2/xfeatures2d.hpp>
 #include <optional>
+#include <sens_loc/features/tiling.h>
+#include <sens_loc/io/compression.h>
+#include <sens_loc/io/feature_store.h>
 #include <sens_loc/util/correctness_util.h>
+#include <taskflow/taskflow.hpp>
+#include <util/worker_shards.h>
 
 using namespace std;
 using namespace cv;
 
 namespace sens_loc::apps {
 
+/// Split the images in a grid of overlapping tiles that are detected in
+/// parallel. Each tile keeps only its strongest keypoints, which distributes
+/// the keypoints more evenly over the image.
+/// \ingroup feature-extractor-driver
+/// \sa features::make_tiles
+struct detection_tiles {
+    int rows    = 1;
+    int cols    = 1;
+    int overlap = 32;
+    /// Maximum number of keypoints of each tile, \c 0 means unlimited.
+    std::size_t budget = 0UL;
+
+    [[nodiscard]] bool enabled() const noexcept { return rows * cols > 1; }
+};
+
 /// Helper class that visits a list of images and extracts features with the
 /// provided detectors.
 /// \ingroup feature-extractor-driver
 class batch_extractor {
   public:
     using filter_func = function<vector<KeyPoint>::iterator(vector<KeyPoint>&)>;
+    /// Creates a new instance of a configured detector or descriptor.
+    using feature_factory = function<Ptr<Feature2D>()>;
 
-    /// \param detector,descriptor Algorithms used for detection and
+    /// \param detector,descriptor Create the algorithms used for detection
+    /// and description. Each worker creates its own instances, as the OpenCV
+    /// algorithms keep internal state and must not be shared between threads.
+    /// The descriptor factory may return an empty pointer to skip the
     /// description.
     /// \param input_pattern,output_pattern Formattable string for IO.
     /// \param keypoint_filter Callable that determines if a keypoint shall be
     /// dropped from consideration. All keypoints with 'keypoint_filter(kp) ==
-    /// true' are removed.
-    batch_extractor(Ptr<Feature2D>      detector,
-                    Ptr<Feature2D>      descriptor,
-                    string_view         input_pattern,
-                    string_view         output_pattern,
-                    vector<filter_func> keypoint_filter)
+    /// true' are removed. With tiles, the filters are applied to each tile.
+    /// \param codec Compression of binary feature files.
+    /// \param store If provided, the features of all images are appended to
+    /// this feature store instead of one file per image. The caller must
+    /// finish the store after processing.
+    /// \param tiles Detect each image in tiles instead of as a whole.
+    batch_extractor(feature_factory           detector,
+                    feature_factory           descriptor,
+                    string_view               input_pattern,
+                    string_view               output_pattern,
+                    vector<filter_func>       keypoint_filter,
+                    io::block_codec           codec = io::block_codec::lz4,
+                    io::feature_store_writer* store = nullptr,
+                    detection_tiles           tiles = {})
         : _detector{move(detector)}
         , _descriptor{move(descriptor)}
         , _input_pattern{input_pattern}
         , _ouput_pattern{output_pattern}
-        , _keypoint_filter{move(keypoint_filter)} {
+        , _keypoint_filter{move(keypoint_filter)}
+        , _codec{codec}
+        , _store{store}
+        , _tiles{tiles} {
         Expects(!_input_pattern.empty());
         Expects(!_ouput_pattern.empty());
-        Expects(!_detector.empty());
+        Expects(_detector);
+        Expects(_descriptor);
+        Expects(_tiles.rows >= 1 && _tiles.cols >= 1);
+        Expects(_tiles.overlap >= 0);
     }
 
     /// Process a whole batch of files in the range [start, end].
     [[nodiscard]] bool process_batch(int start, int end) const noexcept;
 
   private:
+    /// Algorithms and buffers that are owned by one worker. The buffers keep
+    /// their capacity and are reused for the next image of the worker.
+    struct worker_state {
+        Ptr<Feature2D>   detector;
+        Ptr<Feature2D>   descriptor;
+        bool             initialized = false;
+        vector<KeyPoint> keypoints;
+        Mat              descriptors;
+    };
+
+    /// \returns the state of the calling worker, the algorithms are created
+    /// on first use
+    worker_state& local_state() const;
+
     /// Detect and describe one single index. Handles the IO as well.
-    [[nodiscard]] bool process_index(int idx) const noexcept;
+    /// The tiles of the image are spawned into \p sf.
+    void process_index(int idx, tf::Subflow& sf, bool& success) const noexcept;
+
+    /// Spawn the detection of each tile and the merging, description and
+    /// writing of the features afterwards into \p sf.
+    void schedule_tiles(math::image<uchar> image,
+                        int                idx,
+                        string             in_file,
+                        tf::Subflow&       sf,
+                        bool&              success) const;
 
     /// Do IO and handle detection down to \c compute_features.
     bool process_detector(const math::image<uchar>& image,
-                          const string&             out_file,
+                          int                       idx,
                           const string&             in_file) const noexcept;
 
-    /// Compute and filter keypoints and run the descriptor on them
-    /// afterwards.
-    [[nodiscard]] pair<vector<KeyPoint>, Mat>
-    compute_features(const math::image<uchar>& img) const noexcept;
+    /// Detect and filter the keypoints of the whole image. The keypoints are
+    /// stored in the buffer of \p state.
+    void compute_features(const math::image<uchar>& img,
+                          worker_state&             state) const;
+
+    /// Detect and filter the keypoints within the region of \p t.
+    /// \returns the keypoints of the tile in image coordinates
+    [[nodiscard]] vector<KeyPoint>
+    detect_tile(const math::image<uchar>& img, const features::tile& t) const;
+
+    /// Run the descriptor on \p keypoints and write the features of \p idx.
+    /// Keypoints that can not be described are removed.
+    [[nodiscard]] bool describe_and_write(const math::image<uchar>& img,
+                                          vector<KeyPoint>&         keypoints,
+                                          int                       idx,
+                                          const string& in_file) const;
 
+    feature_factory           _detector;
+    feature_factory           _descriptor;
+    string_view               _input_pattern;
+    string_view               _ouput_pattern;
+    vector<filter_func>       _keypoint_filter;
+    io::block_codec           _codec;
+    io::feature_store_writer* _store;
+    detection_tiles           _tiles;
 
-    mutable Ptr<Feature2D> _detector;
-    mutable Ptr<Feature2D> _descriptor;
-    string_view            _input_pattern;
-    string_view            _ouput_pattern;
-    vector<filter_func>    _keypoint_filter;
+    mutable worker_shards<worker_state> _workers;
 };
 }  // namespace sens_loc::apps
 
@@ -1,10 +1,14 @@
 #include "batch_extractor.h"
 
 #include <CLI/CLI.hpp>
+#include <map>
 #include <memory>
 #include <opencv2/core/types.hpp>
 #include <opencv2/features2d.hpp>
 #include <opencv2/xfeatures2d.hpp>
+#include <sens_loc/features/anms.h>
+#include <sens_loc/features/tiling.h>
+#include <sens_loc/io/feature_store.h>
 #include <sens_loc/util/console.h>
 #include <sens_loc/util/correctness_util.h>
 #include <sens_loc/util/overloaded.h>
@@ -286,6 +290,8 @@ MAIN_HEAD("Batch-processing tool to extract visual features") {
     // image modification is. This is necessary as "TaskFlow" does not play
     // nice with OpenCV threading and they introduce data races in the program
     // because of that.
+    // Only batches with less images than workers enable the threading within
+    // OpenCV again, see 'batch_extractor::process_batch'.
     cv::setNumThreads(0);
 
     app.require_subcommand(2);
@@ -298,16 +304,23 @@ MAIN_HEAD("Batch-processing tool to extract visual features") {
                "                  --end 100                           \\\n"
                "                  detector akaze                      \\\n"
                "                  descriptor akaze"
-               "\n");
+               "\n\n"
+               "Output files with the extension '.slfeat' are written in a "
+               "compact binary format that is much faster to load, all other "
+               "files as YAML.\n"
+               "An output with the extension '.slfseq' is a feature store "
+               "that holds the features of all images in one file.\n");
 
     string arg_input_files;
     app.add_option(
            "-i,--input", arg_input_files,
-           "Input pattern for images to filter; e.g. \"flexion-{}.png\"")
+           "Input pattern for images to filter; e.g. \"flexion-{}.png\" or "
+           "a sequence container \"flexion.slseq\"")
         ->required();
     string arg_out_path;
     app.add_option("-o,--output", arg_out_path,
-                   "Output file-pattern for the feature information")
+                   "Output file-pattern for the feature information or a "
+                   "feature store \"features.slfseq\"")
         ->required();
     int start_idx = 0;
     app.add_option("-s,--start", start_idx, "Start index of batch, inclusive")
@@ -316,6 +329,13 @@ MAIN_HEAD("Batch-processing tool to extract visual features") {
     app.add_option("-e,--end", end_idx, "End index of batch, inclusive")
         ->required();
 
+    const map<string, io::block_codec> codecs{{"lz4", io::block_codec::lz4},
+                                              {"none", io::block_codec::none}};
+    io::block_codec codec = io::block_codec::lz4;
+    app.add_option("--compression", codec,
+                   "Compression of binary '.slfeat' and '.slfseq' output")
+        ->transform(CLI::CheckedTransformer(codecs));
+
     CLI::App* detector_cmd =
         app.add_subcommand("detector", "Configure the detector");
     optional<float> keypoint_size_threshold;
@@ -331,6 +351,30 @@ MAIN_HEAD("Batch-processing tool to extract visual features") {
                              "Set a maximum number of extracted keypoints. "
                              "Filtered by response. Disabled with '0'",
                              /*defaulted=*/true);
+    unsigned int anms_count = 0U;
+    detector_cmd->add_option(
+        "--anms-count", anms_count,
+        "Keep this many keypoints with adaptive non-maximal suppression, "
+        "which selects the strongest keypoints in their neighbourhood and "
+        "spreads them over the image. Applied before '--kp-count'. "
+        "Disabled with '0'",
+        /*defaulted=*/true);
+    unsigned int tile_grid = 1U;
+    detector_cmd
+        ->add_option("--tiles", tile_grid,
+                     "Detect in a grid of N x N overlapping tiles in parallel. "
+                     "Each tile keeps its share of '--kp-count' strongest "
+                     "keypoints, which distributes them more evenly. "
+                     "Disabled with '1'",
+                     /*defaulted=*/true)
+        ->check(CLI::Range(1, 64));
+    int tile_overlap = 32;
+    detector_cmd
+        ->add_option("--tile-overlap", tile_overlap,
+                     "Overlap of neighbouring tiles in pixels, should be at "
+                     "least the border the detector ignores",
+                     /*defaulted=*/true)
+        ->check(CLI::Range(0, 1024));
     detector_cmd->require_subcommand(1);
 
     CLI::App* descriptor_cmd = app.add_subcommand(
@@ -483,28 +527,58 @@ MAIN_HEAD("Batch-processing tool to extract visual features") {
             });
         });
 
+    // With tiles, every tile keeps its share of the keypoints instead of the
+    // strongest keypoints of the whole image.
+    detection_tiles tiles;
+    tiles.rows    = int(tile_grid);
+    tiles.cols    = int(tile_grid);
+    tiles.overlap = tile_overlap;
+    if (tiles.enabled() && keypoint_count != 0U)
+        tiles.budget = max(keypoint_count / (tile_grid * tile_grid), 1U);
+
+    if (anms_count != 0U) {
+        const unsigned int c =
+            tiles.enabled() ? max(anms_count / (tile_grid * tile_grid), 1U)
+                            : anms_count;
+        filter.emplace_back([c](vector<KeyPoint>& kps) {
+            return features::partition_anms(kps, c);
+        });
+    }
+
     // Because the keypoint count limit must be a limit, this filter needs to
     // be applied last!
-    if (keypoint_count != 0U)
+    if (keypoint_count != 0U && !tiles.enabled())
         filter.emplace_back([c = keypoint_count](vector<KeyPoint>& kps) {
-            if (kps.size() > c) {
-                auto c_it = begin(kps) + c;
-                // Sort until the element 'c' by response. The range is
-                // partitioned afterwards.
-                nth_element(begin(kps), c_it, end(kps),
-                            [](const KeyPoint& kp1, const KeyPoint& kp2) {
-                                return kp1.response > kp2.response;
-                            });
-                return c_it;
-            }
-            return kps.end();
+            return features::partition_strongest(kps, c);
         });
 
-    const batch_extractor extractor(visit(argument_visitor, det_args),
-                                    visit(argument_visitor, desc_args),
-                                    arg_input_files, arg_out_path, filter);
+    optional<io::feature_store_writer> store;
+    if (io::is_feature_store_path(arg_out_path)) {
+        store = io::feature_store_writer::create(arg_out_path, start_idx,
+                                                 end_idx, codec);
+        if (!store) {
+            cerr << util::err{} << "Could not create the feature store "
+                 << arg_out_path << "!\n";
+            return 1;
+        }
+    }
 
-    const bool success = extractor.process_batch(start_idx, end_idx);
+    // Every worker creates its own detector and descriptor from the parsed
+    // arguments.
+    auto det_factory = [&argument_visitor, &det_args]() {
+        return visit(argument_visitor, det_args);
+    };
+    auto desc_factory = [&argument_visitor, &desc_args]() {
+        return visit(argument_visitor, desc_args);
+    };
+
+    const batch_extractor extractor(det_factory, desc_factory,
+                                    arg_input_files, arg_out_path, filter,
+                                    codec, store ? &*store : nullptr, tiles);
+
+    bool success = extractor.process_batch(start_idx, end_idx);
+    if (store)
+        success = store->finish() && success;
     return success ? 0 : 1;
 }
 MAIN_TAIL
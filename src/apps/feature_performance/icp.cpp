@@ -3,42 +3,74 @@
 #include <opencv2/core/hal/interface.h>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/rgbd/depth.hpp>
+#include <sens_loc/math/angle_conversion.h>
+#include <vector>
 
 namespace sens_loc::apps {
-std::pair<math::pose_t, bool>
-refine_pose(cv::rgbd::Odometry&        icp,
-            const math::image<ushort>& previous_depth,
-            const math::image<ushort>& this_depth,
-            double                     unit_factor,
-            const math::pose_t&        initial_pose) noexcept {
+cv::Ptr<cv::rgbd::Odometry> make_icp(const camera_models::pinhole<float>& i,
+                                     bool coarse_only) {
+    // Iterations on each level of the pyramid, from the finest to the
+    // coarsest level. An empty vector selects the defaults of opencv, that
+    // are '{7, 7, 7, 10}'. The coarse refinement keeps the same pyramid and
+    // iterates only on its coarsest level.
+    const std::vector<int> full_iterations{};
+    const std::vector<int> coarse_iterations{0, 0, 0, 10};
+
+    return cv::rgbd::FastICPOdometry::create(
+        cv_camera_matrix(i), /*maxDistDiff=*/0.07F,
+        /*angleThreshold=*/math::deg_to_rad(30.0F), /*sigmaDepth=*/0.04F,
+        /*sigmaSpatial=*/4.5F, /*kernelSize=*/7,
+        coarse_only ? coarse_iterations : full_iterations);
+}
+
+icp_frame prepare_icp_frame(const cv::rgbd::Odometry&  icp,
+                            const math::image<ushort>& depth,
+                            double                     unit_factor) {
     using namespace cv;
 
-    Mat prev_mask;
-    previous_depth.data().convertTo(prev_mask, CV_8UC1);
+    Mat mask;
+    Mat metric_depth;
+    depth.data().convertTo(mask, CV_8UC1);
+    depth.data().convertTo(metric_depth, CV_32F, unit_factor);
 
-    Mat this_mask;
-    this_depth.data().convertTo(this_mask, CV_8UC1);
+    icp_frame f{rgbd::OdometryFrame::create(/*image=*/Mat(), metric_depth,
+                                            mask)};
+    // The frame is the destination of the pair with its predecessor and the
+    // source of the pair with its successor.
+    icp.prepareFrameCache(f.frame, rgbd::OdometryFrame::CACHE_ALL);
+    return f;
+}
 
-    Mat cvt_prev_depth;
-    previous_depth.data().convertTo(cvt_prev_depth, CV_32F, unit_factor);
+std::pair<math::pose_t, bool>
+refine_pose(const cv::rgbd::Odometry&  icp,
+            const math::image<ushort>& previous_depth,
+            const math::image<ushort>& this_depth,
+            double                     unit_factor,
+            const math::pose_t&        initial_pose) noexcept try {
+    return refine_pose(icp,
+                       prepare_icp_frame(icp, previous_depth, unit_factor),
+                       prepare_icp_frame(icp, this_depth, unit_factor),
+                       initial_pose);
+} catch (...) { return {math::pose_t::Identity(4, 4), false}; }
 
-    Mat cvt_this_depth;
-    this_depth.data().convertTo(cvt_this_depth, CV_32F, unit_factor);
+std::pair<math::pose_t, bool>
+refine_pose(const cv::rgbd::Odometry& icp,
+            const icp_frame&          previous,
+            const icp_frame&          current,
+            const math::pose_t&       initial_pose) noexcept try {
+    using namespace cv;
 
     Mat initial = Mat::eye(4, 4, CV_64FC1);
     for (int i = 0; i < 4; ++i)
         for (int j = 0; j < 4; ++j)
             initial.at<double>(i, j) = initial_pose(i, j);
 
-    Mat        Rt;
-    const bool icp_success = icp.compute(/*srcImage=*/Mat(),
-                                         /*srcDepth=*/cvt_prev_depth,
-                                         /*srcMask=*/prev_mask,
-                                         /*dstImage=*/Mat(),
-                                         /*dstDepth=*/cvt_this_depth,
-                                         /*dstMask=*/this_mask,
-                                         /*Rt=*/Rt,
-                                         /*initRt=*/initial);
+    // The caches of prepared frames are complete, the icp does not modify
+    // the shared frames.
+    Ptr<rgbd::OdometryFrame> src = previous.frame;
+    Ptr<rgbd::OdometryFrame> dst = current.frame;
+    Mat                      Rt;
+    const bool icp_success = icp.compute(src, dst, Rt, initial);
 
     math::pose_t result_pose = math::pose_t::Identity(4, 4);
     if (icp_success) {
@@ -49,5 +81,5 @@ refine_pose(cv::rgbd::Odometry&        icp,
     }
 
     return {result_pose, icp_success};
-}
+} catch (...) { return {math::pose_t::Identity(4, 4), false}; }
 }  // namespace sens_loc::apps
@@ -1,11 +1,14 @@
 #ifndef ICP_H_UEHTV2OD
 #define ICP_H_UEHTV2OD
 
+#include <opencv2/core/mat.hpp>
 #include <sens_loc/camera_models/pinhole.h>
+#include <sens_loc/math/image.h>
 #include <sens_loc/math/pointcloud.h>
 
 namespace cv::rgbd {
 class Odometry;
+struct OdometryFrame;
 };
 
 namespace sens_loc::apps {
@@ -20,15 +23,46 @@ inline cv::Mat cv_camera_matrix(const camera_models::pinhole<Real>& i) {
     return K;
 }
 
+/// Create opencvs fast icp for the pinhole camera \p i.
+/// \param coarse_only iterate only on the coarsest level of the image
+/// pyramid. This is much faster, but the refined pose is less accurate.
+cv::Ptr<cv::rgbd::Odometry>
+make_icp(const camera_models::pinhole<float>& i, bool coarse_only = false);
+
+/// One frame in the representation the icp requires.
+/// Each frame takes part in two pairs of frames, preparing it once allows
+/// to reuse it for both.
+struct icp_frame {
+    /// Depth as \c CV_32F, scaled by the unit factor, with its mask and the
+    /// pyramids, point clouds and normals of the icp.
+    cv::Ptr<cv::rgbd::OdometryFrame> frame;
+};
+
+/// Convert the depth image \p depth and build all data that \p icp requires
+/// for the frame as source and as destination of a pair.
+/// \note the icp only reads a prepared frame, it can be shared by concurrent
+/// refinements with the same \p icp.
+icp_frame prepare_icp_frame(const cv::rgbd::Odometry&  icp,
+                            const math::image<ushort>& depth,
+                            double                     unit_factor);
+
 /// Refine the pose 'initial_pose' with opencvs icp for pinhole cameras.
 /// \returns {refined_pose, icp_successful}. If \c icp_successful is \c false
 /// \c refined_pose is the identity matrix.
 std::pair<math::pose_t, bool>
-refine_pose(cv::rgbd::Odometry&        icp,
+refine_pose(const cv::rgbd::Odometry&  icp,
             const math::image<ushort>& previous_depth,
             const math::image<ushort>& this_depth,
             double                     unit_factor,
             const math::pose_t&        initial_pose) noexcept;
+
+/// \pre both frames are prepared by \p icp
+/// \sa refine_pose, prepare_icp_frame
+std::pair<math::pose_t, bool>
+refine_pose(const cv::rgbd::Odometry& icp,
+            const icp_frame&          previous,
+            const icp_frame&          current,
+            const math::pose_t&       initial_pose) noexcept;
 }  // namespace sens_loc::apps
 
 #endif /* end of include guard: ICP_H_UEHTV2OD */
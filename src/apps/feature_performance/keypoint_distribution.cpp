@@ -1,4 +1,3 @@
-#define _LIBCPP_ENABLE_THREAD_SAFETY_ANNOTATIONS
 #include "keypoint_distribution.h"
 
 #include <boost/histogram/ostream.hpp>
@@ -12,9 +11,9 @@
 #include <sens_loc/analysis/distance.h>
 #include <sens_loc/analysis/keypoints.h>
 #include <sens_loc/io/histogram.h>
-#include <sens_loc/util/thread_analysis.h>
 #include <util/batch_visitor.h>
 #include <util/common_structures.h>
+#include <util/index_shards.h>
 #include <util/statistic_visitor.h>
 
 using namespace std;
@@ -22,37 +21,74 @@ using namespace gsl;
 
 namespace {
 
-struct keypoint_stat_data {
-    keypoint_stat_data() = default;
+using sens_loc::analysis::distance_accumulator;
+
+/// Keypoints and their distances of the images in one chunk of indices.
+/// Without exact statistics, the keypoints are accumulated into the analysis
+/// directly and neither keypoints nor distances are stored.
+struct keypoint_shard {
+    vector<cv::KeyPoint>          keypoints;
+    sens_loc::analysis::keypoints analysis;
+    distance_accumulator          minimal_distances;
+    size_t                        keypoint_count = 0UL;
+};
 
-    void insert_points(gsl::span<cv::KeyPoint> points) noexcept {
-        lock_guard l{_keypoint_mutex};
-        _global_keypoints.insert(end(_global_keypoints), begin(points),
-                                 end(points));
+/// Collect the keypoints and their distances of all images.
+struct keypoint_stat_data {
+    keypoint_stat_data(int                           first,
+                       int                           last,
+                       bool                          exact_statistics,
+                       sens_loc::analysis::keypoints analysis)
+        : _exact{exact_statistics}
+        , _shards{first, last,
+                  keypoint_shard{{},
+                                 std::move(analysis),
+                                 distance_accumulator{exact_statistics},
+                                 0UL},
+                  merge} {}
+
+    void insert_points(int idx, gsl::span<const cv::KeyPoint> points) noexcept {
+        keypoint_shard& shard = _shards.local(idx);
+        if (_exact)
+            shard.keypoints.insert(end(shard.keypoints), begin(points),
+                                   end(points));
+        else
+            shard.analysis.accumulate(points);
+        shard.keypoint_count += points.size();
     }
-    void insert_distances(gsl::span<float> distances) noexcept {
-        lock_guard l{_distance_mutex};
-        _global_minimal_distances.insert(_global_minimal_distances.end(),
-                                         begin(distances), end(distances));
+    void insert_distances(int idx, gsl::span<const float> distances) noexcept {
+        _shards.local(idx).minimal_distances.insert(distances);
     }
-
-    pair<vector<cv::KeyPoint>, vector<float>> extract() noexcept {
-        lock_guard l1{_keypoint_mutex};
-        lock_guard l2{_distance_mutex};
-
-        pair p{move(_global_keypoints), move(_global_minimal_distances)};
-        _global_keypoints         = vector<cv::KeyPoint>();
-        _global_minimal_distances = vector<float>();
-
-        return p;
+    void complete(int idx) noexcept { _shards.complete(idx); }
+
+    /// Analyze the shards of all chunks, merged in the order of the indices.
+    /// \pre all chunks are completed
+    /// \returns the analyzed keypoints, the collected distances and the
+    /// number of keypoints
+    tuple<sens_loc::analysis::keypoints, distance_accumulator, size_t>
+    extract() noexcept {
+        keypoint_shard& merged = _shards.result();
+
+        if (_exact)
+            merged.analysis.analyze(merged.keypoints);
+        else
+            merged.analysis.summarize();
+
+        return {move(merged.analysis), move(merged.minimal_distances),
+                merged.keypoint_count};
     }
 
   private:
-    mutex                                  _keypoint_mutex;
-    vector<cv::KeyPoint> _global_keypoints GUARDED_BY(_keypoint_mutex);
+    static void merge(keypoint_shard& into, keypoint_shard& from) {
+        into.keypoints.insert(end(into.keypoints), begin(from.keypoints),
+                              end(from.keypoints));
+        into.analysis.merge(from.analysis);
+        into.minimal_distances.merge(from.minimal_distances);
+        into.keypoint_count += from.keypoint_count;
+    }
 
-    mutex                                   _distance_mutex;
-    vector<float> _global_minimal_distances GUARDED_BY(_distance_mutex);
+    bool                                         _exact;
+    sens_loc::apps::index_shards<keypoint_shard> _shards;
 };
 
 /// Calculate the 2-dimensional distribution of the keypoints for a dataset.
@@ -61,89 +97,35 @@ class keypoint_distribution {
     keypoint_distribution(keypoint_stat_data& d) noexcept
         : accumulated_data{d} {}
 
-    void operator()(int /*idx*/,
+    void operator()(int                            idx,
                     optional<vector<cv::KeyPoint>> keypoints,
                     optional<cv::Mat> /*descriptors*/) noexcept {  // NOLINT
         if (keypoints->empty())
             return;
 
-        accumulated_data.insert_points(*keypoints);
+        accumulated_data.insert_points(idx, *keypoints);
 
         // Calculate the minimal distance of each keypoint to all others
-        // and insert that first into a local vector with that information
-        // and finally into the global vector with that information.
+        // and insert that into the global vector with that information.
         // This is the pixel-distance with euclidean norm.
-        // NOTE: This is an inefficient implementation if O(n^2) complexity.
-        {
-            const size_t n_points = keypoints->size();
-            if (n_points < 2)
-                return;
-
-            vector<cv::KeyPoint>& kp_ref = *keypoints;
-            vector<float>         local_minima;
-            vector<float>         local_distances;
-            local_distances.reserve(n_points);
-
-            // The upper triangle of the distance matrix needs to be calculated.
-            // The last row must be ignored and the diagonal element will be 0.
-            // Example:
-            //    ++p1++p2++p3++
-            // p1 |  0   2   4 |
-            // p2 |      0   7 |
-            // p3 |          0 |
-            // The result are 'n_points / 2' number of minimal distances.
-            // Because there will
-            for (size_t i = 1; i < n_points - 1; ++i) {
-                // loop-calculation
-                for (size_t k = i + 1; k < n_points; ++k) {
-                    const float dx = kp_ref[i].pt.x - kp_ref[k].pt.x;
-                    const float dy = kp_ref[i].pt.y - kp_ref[k].pt.y;
-                    const float d  = sqrt(dx * dx + dy * dy);
-                    Ensures(d >= 0.0F);
-                    local_distances.emplace_back(d);
-                }
-
-                Ensures(!local_distances.empty());
-
-                // Store the minimal element for statistical evaluation.
-                local_minima.emplace_back(
-                    *min_element(begin(local_distances), end(local_distances)));
-
-                // Ensure that local_distances is only allocated once.
-                local_distances.clear();
-            }
-            accumulated_data.insert_distances(local_minima);
-        }
+        vector<float> local_minima =
+            sens_loc::analysis::nearest_neighbour_distances(*keypoints);
+        if (!local_minima.empty())
+            accumulated_data.insert_distances(idx, local_minima);
     }
 
-    size_t postprocess(unsigned int            image_width,
-                       unsigned int            image_height,
-                       const optional<string>& stat_file,
+    size_t postprocess(const optional<string>& stat_file,
                        const optional<string>& response_histo,
                        const optional<string>& size_histo,
                        const optional<string>& kp_distance_histo,
                        const optional<string>& kp_distribution_histo) {
-        auto [keypoints, distances] = accumulated_data.extract();
+        auto [kp, distances, keypoint_count] = accumulated_data.extract();
 
-        if (keypoints.empty() || distances.empty())
+        if (keypoint_count == 0UL || distances.empty())
             return 0UL;
 
-        sens_loc::analysis::keypoints kp{image_width, image_height};
-
-        const auto location_bins = 200U;
-        kp.configure_distribution(location_bins);
-        kp.configure_distribution("normalized width", "normalized height");
-
-        const auto response_bins = 50U;
-        kp.configure_response(response_bins, "detector response");
-
-        const auto size_bins = 50U;
-        kp.configure_size(size_bins, "keypoint size");
-        kp.analyze(keypoints);
-
-        sort(begin(distances), end(distances));
         const auto                   dist_bins = 50UL;
-        sens_loc::analysis::distance distance_stat{distances, dist_bins,
+        sens_loc::analysis::distance distance_stat{move(distances), dist_bins,
                                                    "minimal keypoint distance"};
 
         if (stat_file) {
@@ -208,7 +190,7 @@ class keypoint_distribution {
             ofstream gnuplot_data{*kp_distribution_histo};
             gnuplot_data << sens_loc::io::to_gnuplot(kp.distribution()) << endl;
         }
-        return keypoints.size();
+        return keypoint_count;
     }
 
   private:
@@ -220,6 +202,7 @@ class keypoint_distribution {
 namespace sens_loc::apps {
 int analyze_keypoint_distribution(
     util::processing_input  in,
+    bool                    exact_statistics,
     unsigned int            image_width,
     unsigned int            image_height,
     const optional<string>& stat_file,
@@ -230,14 +213,26 @@ int analyze_keypoint_distribution(
     using visitor =
         statistic_visitor<keypoint_distribution, required_data::keypoints>;
 
-    keypoint_stat_data d;
+    analysis::keypoints kp{image_width, image_height};
+
+    const auto location_bins = 200U;
+    kp.configure_distribution(location_bins);
+    kp.configure_distribution("normalized width", "normalized height");
+
+    const auto response_bins = 50U;
+    kp.configure_response(response_bins, "detector response");
+
+    const auto size_bins = 50U;
+    kp.configure_size(size_bins, "keypoint size");
+
+    keypoint_stat_data d{in.start, in.end, exact_statistics, move(kp)};
 
-    auto f =
-        parallel_visitation(in.start, in.end, visitor{in.input_pattern, d});
+    auto f = parallel_visitation(
+        in.start, in.end, visitor{in.input_pattern, d}, default_shard_chunk,
+        [&d](int idx) noexcept { d.complete(idx); });
 
-    size_t n_elements =
-        f.postprocess(image_width, image_height, stat_file, response_histo,
-                      size_histo, kp_distance_histo, kp_distribution_histo);
+    size_t n_elements = f.postprocess(stat_file, response_histo, size_histo,
+                                      kp_distance_histo, kp_distribution_histo);
 
     return n_elements > 0UL ? 0 : 1;
 }
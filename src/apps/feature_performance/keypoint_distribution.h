@@ -7,8 +7,13 @@
 
 namespace sens_loc::apps {
 
+/// Analyze the distribution, size and response of the keypoints and the
+/// distance of each keypoint to its nearest neighbour.
+/// \param exact_statistics store all keypoints and distances for exact
+/// quantiles instead of approximating them in constant memory
 int analyze_keypoint_distribution(
     util::processing_input            in,
+    bool                              exact_statistics,
     unsigned int                      image_width,
     unsigned int                      image_height,
     const std::optional<std::string>& stat_file,
@@ -8,23 +8,32 @@
 
 namespace sens_loc::apps {
 
+/// Backproject the keypoints \c kps with their depth into a pointcloud in
+/// the coordinate frame of \c c.
+/// \returns point 'i' in column 'i' for the keypoint at position 'i'
 template <template <typename> typename Model = sens_loc::camera_models::pinhole,
           typename Real                      = float>
-math::pointcloud<Real>
+math::pointcloud_soa<Real>
 keypoints_to_pointcloud(const std::vector<cv::KeyPoint>& kps,
                         const math::image<ushort>&       depth_image,
                         const Model<Real>&               c,
                         float                            unit_factor) noexcept {
-    using camera_models::keypoint_to_coords;
-    math::imagepoints<Real> pts   = keypoint_to_coords(kps);
-    math::pointcloud<Real>  c_pts = project_to_sphere(c, pts);
-
-    for (std::size_t i = 0; i < c_pts.size(); ++i) {
-        auto orig_depth = depth_image.at(pts[i]);
-        auto t_d        = unit_factor * gsl::narrow_cast<float>(orig_depth);
-        c_pts[i]        = t_d * c_pts[i];
+    const auto n = gsl::narrow_cast<Eigen::Index>(kps.size());
+
+    math::imagepoints_soa<Real>           pts(2, n);
+    Eigen::Array<Real, 1, Eigen::Dynamic> depth(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        const cv::Point2f& pt = kps[gsl::narrow_cast<std::size_t>(i)].pt;
+        pts(0, i)             = pt.x;
+        pts(1, i)             = pt.y;
+
+        auto orig_depth = depth_image.at(math::pixel_coord<Real>(pt.x, pt.y));
+        depth(i)        = unit_factor * gsl::narrow_cast<float>(orig_depth);
     }
 
+    math::pointcloud_soa<Real> c_pts = project_to_sphere(c, pts);
+    c_pts.array().rowwise() *= depth;
+
     return c_pts;
 }
 
@@ -36,12 +45,14 @@ keypoints_to_pointcloud(const std::vector<cv::KeyPoint>& kps,
 template <template <typename> typename Model = sens_loc::camera_models::pinhole,
           typename Real                      = float>
 math::imagepoints<Real>
-project_to_other_camera(const math::pose_t&           pose,
-                        const math::pointcloud<Real>& points_in_other_frame,
-                        const Model<Real>&            c) noexcept {
-    math::pointcloud<Real>  transformed   = pose * points_in_other_frame;
-    math::imagepoints<Real> backprojected = project_to_image(c, transformed);
-    return backprojected;
+project_to_other_camera(const math::pose_t&               pose,
+                        const math::pointcloud_soa<Real>& points_in_other_frame,
+                        const Model<Real>&                c) noexcept {
+    math::pointcloud_soa<Real> transformed =
+        math::transform(pose, points_in_other_frame);
+    math::imagepoints_soa<Real> backprojected =
+        project_to_image(c, transformed);
+    return math::to_aos(backprojected);
 }
 
 }  // namespace sens_loc::apps
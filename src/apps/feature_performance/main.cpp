@@ -6,6 +6,8 @@
 #include <CLI/CLI.hpp>
 #include <boost/histogram.hpp>
 #include <opencv2/core/base.hpp>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <sens_loc/io/pose.h>
 #include <sens_loc/util/console.h>
 #include <sens_loc/util/correctness_util.h>
 #include <stdexcept>
@@ -30,6 +32,30 @@ static cv::NormTypes str_to_norm(std::string_view n) {
     UNREACHABLE("unexpected norm type");  // LCOV_EXCL_LINE
 }
 
+static sens_loc::analysis::match_strategy
+str_to_strategy(std::string_view s) {
+    using sens_loc::analysis::match_strategy;
+    if (s == "nearest")
+        return match_strategy::nearest;
+    if (s == "crosscheck")
+        return match_strategy::crosscheck;
+    if (s == "ratio")
+        return match_strategy::ratio;
+    if (s == "ratio-crosscheck")
+        return match_strategy::ratio_crosscheck;
+    UNREACHABLE("unexpected match strategy");  // LCOV_EXCL_LINE
+}
+
+static sens_loc::io::trajectory_format
+str_to_trajectory_format(std::string_view s) {
+    using sens_loc::io::trajectory_format;
+    if (s == "tum")
+        return trajectory_format::tum;
+    if (s == "kitti")
+        return trajectory_format::kitti;
+    UNREACHABLE("unexpected trajectory format");  // LCOV_EXCL_LINE
+}
+
 MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
     // Explicitly disable threading from OpenCV functions, as the
     // parallelization is done at a higher level.
@@ -44,7 +70,8 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
 
     string feature_file_input_pattern;
     app.add_option("-i,--input", feature_file_input_pattern,
-                   "Define file-pattern for the feature files to be plotted")
+                   "Define file-pattern for the feature files to be plotted "
+                   "or a feature store \"features.slfseq\"")
         ->required();
     int start_idx = 0;
     app.add_option("-s,--start", start_idx, "Start index for processing.")
@@ -56,6 +83,12 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
     app.add_option(
         "-o,--output", statistics_file,
         "Write the result of the analysis into a yaml-file instead to stdout");
+    bool exact_statistics = false;
+    app.add_flag("--exact-statistics", exact_statistics,
+                 "Store all values to calculate exact medians, decentils and "
+                 "histograms. By default these are approximated with a "
+                 "quantile sketch in constant memory, whose rank error is "
+                 "below 1.65%.");
 
     CLI::App* cmd_keypoint_dist = app.add_subcommand(
         "keypoint-distribution",
@@ -113,9 +146,81 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
                          {"L1", "L2", "L2SQR", "HAMMING", "HAMMING2"},
                          "Set the norm that shall be used as distance measure",
                          /*defaulted=*/true);
+    string       strategy_name = "crosscheck";
+    const string strategy_help =
+        "Filter for the nearest neighbours: 'nearest' accepts all, "
+        "'crosscheck' requires mutual nearest neighbours, 'ratio' applies "
+        "the ratio test and 'ratio-crosscheck' both";
+    CLI::Option* strategy_opt = cmd_matcher->add_set(
+        "--match-strategy", strategy_name,
+        {"nearest", "crosscheck", "ratio", "ratio-crosscheck"}, strategy_help,
+        /*defaulted=*/true);
     bool no_crosscheck = false;
-    cmd_matcher->add_flag("--no-crosscheck", no_crosscheck,
-                          "Disable crosschecking");
+    cmd_matcher
+        ->add_flag("--no-crosscheck", no_crosscheck,
+                   "Disable crosschecking, same as '--match-strategy nearest'")
+        ->excludes(strategy_opt);
+    float match_ratio = analysis::default_match_ratio;
+    const string ratio_help =
+        "Maximum ratio between the distance of the nearest and the second "
+        "nearest neighbour for the ratio test";
+    cmd_matcher
+        ->add_option("--match-ratio", match_ratio, ratio_help,
+                     /*defaulted=*/true)
+        ->check(CLI::Range(0.01F, 1.0F));
+    string matcher_name = "exact";
+    cmd_matcher->add_set("--matcher", matcher_name, {"exact", "ann"},
+                         "Compare all descriptors or match approximately with "
+                         "an index per frame, multi-probe LSH for binary and "
+                         "HNSW for float descriptors",
+                         /*defaulted=*/true);
+    analysis::ann_parameters ann_parameters;
+    cmd_matcher
+        ->add_option("--lsh-tables", ann_parameters.lsh_tables,
+                     "Number of hash tables for approximate matching",
+                     /*defaulted=*/true)
+        ->check(CLI::Range(1, 64));
+    cmd_matcher
+        ->add_option("--lsh-key-bits", ann_parameters.lsh_key_bits,
+                     "Number of descriptor bits per hash key",
+                     /*defaulted=*/true)
+        ->check(CLI::Range(1, 32));
+    cmd_matcher
+        ->add_option("--lsh-probe-level", ann_parameters.lsh_probe_level,
+                     "Probe the buckets whose keys differ in up to this many "
+                     "bits",
+                     /*defaulted=*/true)
+        ->check(CLI::Range(0, 2));
+    cmd_matcher
+        ->add_option("--hnsw-links", ann_parameters.hnsw_links,
+                     "Number of links per node in the HNSW graph",
+                     /*defaulted=*/true)
+        ->check(CLI::Range(2, 256));
+    cmd_matcher
+        ->add_option("--hnsw-ef-construction",
+                     ann_parameters.hnsw_ef_construction,
+                     "Size of the candidate list while building the graph",
+                     /*defaulted=*/true)
+        ->check(CLI::PositiveNumber);
+    cmd_matcher
+        ->add_option("--hnsw-ef-search", ann_parameters.hnsw_ef_search,
+                     "Size of the candidate list for each query",
+                     /*defaulted=*/true)
+        ->check(CLI::PositiveNumber);
+    int ann_recall_sample = 0;
+    cmd_matcher
+        ->add_option("--ann-recall-sample", ann_recall_sample,
+                     "Match every n-th frame exactly as well and report the "
+                     "recall of the approximate matching, 0 disables it",
+                     /*defaulted=*/true)
+        ->check(CLI::NonNegativeNumber);
+    vector<int> match_gaps{1};
+    cmd_matcher
+        ->add_option("--gap", match_gaps,
+                     "Match each frame with the frame 'gap' indices before it, "
+                     "multiple gaps are analyzed in one run",
+                     /*defaulted=*/true)
+        ->check(CLI::PositiveNumber);
     optional<string> match_output;
     CLI::Option*     match_output_opt = cmd_matcher->add_option(
         "--match-output", match_output,
@@ -141,13 +246,44 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
     string depth_image_path;
     cmd_rec_perf
         ->add_option("--depth-image", depth_image_path,
-                     "File pattern for the original depth images")
+                     "File pattern for the original depth images or a "
+                     "sequence container")
         ->required();
-    string pose_file_pattern;
+    string       pose_file_pattern;
+    CLI::Option* pose_file_opt = cmd_rec_perf->add_option(
+        "--pose-file", pose_file_pattern,
+        "File pattern for the poses of each camera-idx.");
+    optional<string> trajectory_file;
+    CLI::Option*     trajectory_opt =
+        cmd_rec_perf
+            ->add_option("--trajectory", trajectory_file,
+                         "Single file with the poses of the whole sequence, "
+                         "one pose per line. Alternative to '--pose-file'.")
+            ->excludes(pose_file_opt);
+    string trajectory_format_name = "tum";
     cmd_rec_perf
-        ->add_option("--pose-file", pose_file_pattern,
-                     "File pattern for the poses of each camera-idx.")
-        ->required();
+        ->add_set("--trajectory-format", trajectory_format_name,
+                  {"tum", "kitti"},
+                  "Format of the trajectory: 'timestamp tx ty tz qx qy qz qw' "
+                  "(tum) or the row-major 3x4 matrix (kitti)",
+                  /*defaulted=*/true)
+        ->needs(trajectory_opt);
+    optional<string> frame_timestamps_file;
+    CLI::Option*     frame_timestamps_opt =
+        cmd_rec_perf
+            ->add_option("--frame-timestamps", frame_timestamps_file,
+                         "Timestamps of the depth images in the first column, "
+                         "e.g. 'depth.txt'. Each frame gets the pose closest "
+                         "in time instead of the pose in line 'idx'.")
+            ->needs(trajectory_opt);
+    double max_time_difference = 0.02;
+    cmd_rec_perf
+        ->add_option("--max-time-difference", max_time_difference,
+                     "Maximal difference in seconds between the timestamps "
+                     "of a frame and its pose",
+                     /*defaulted=*/true)
+        ->needs(frame_timestamps_opt)
+        ->check(CLI::Range(0.0, 1.0));
     string intrinsic_file;
     cmd_rec_perf
         ->add_option("--intrinsic", intrinsic_file,
@@ -164,12 +300,24 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
                           {"L1", "L2", "L2SQR", "HAMMING", "HAMMING2"},
                           "Set the norm that shall be used as distance measure",
                           /*defaulted=*/true);
+    cmd_rec_perf->add_set(
+        "--match-strategy", strategy_name,
+        {"nearest", "crosscheck", "ratio", "ratio-crosscheck"}, strategy_help,
+        /*defaulted=*/true);
+    cmd_rec_perf
+        ->add_option("--match-ratio", match_ratio, ratio_help,
+                     /*defaulted=*/true)
+        ->check(CLI::Range(0.01F, 1.0F));
     float keypoint_distance_threshold = 3.0F;
     cmd_rec_perf->add_option("--keypoint-distance-threshold",
                              keypoint_distance_threshold,
                              "Threshold for the reprojection error of "
                              "keypoints to be considered a correspondence",
                              /*defaulted=*/true);
+    bool icp_coarse_only = false;
+    cmd_rec_perf->add_flag("--icp-coarse-only", icp_coarse_only,
+                           "Refine the relative poses only on the coarsest "
+                           "ICP level for a fast approximation");
     optional<string> backproject_pattern;
     CLI::Option*     backproject_opt = cmd_rec_perf->add_option(
         "--backprojection", backproject_pattern,
@@ -259,28 +407,52 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
     util::processing_input in{feature_file_input_pattern, start_idx, end_idx};
 
     if (*cmd_min_dist) {
-        return analyze_min_distance(in, str_to_norm(norm_name), statistics_file,
+        return analyze_min_distance(in, exact_statistics,
+                                    str_to_norm(norm_name), statistics_file,
                                     min_distance_histo);
     }
 
     if (*cmd_keypoint_dist)
         return analyze_keypoint_distribution(
-            in, image_width, image_height, statistics_file, response_histo,
-            size_histo, kp_distance_histo, kp_distribution_histo);
+            in, exact_statistics, image_width, image_height, statistics_file,
+            response_histo, size_histo, kp_distance_histo,
+            kp_distribution_histo);
 
-    if (*cmd_matcher)
-        return analyze_matching(in, str_to_norm(norm_name), !no_crosscheck,
+    if (*cmd_matcher) {
+        const analysis::match_strategy strategy =
+            no_crosscheck ? analysis::match_strategy::nearest
+                          : str_to_strategy(strategy_name);
+        optional<ann_matching> ann;
+        if (matcher_name == "ann")
+            ann = ann_matching{ann_parameters, ann_recall_sample};
+        return analyze_matching(in, exact_statistics, str_to_norm(norm_name),
+                                strategy, match_ratio, ann, match_gaps,
                                 statistics_file, matched_distance_histo,
                                 match_output, original_images);
+    }
 
     if (*cmd_rec_perf) {
+        if (pose_file_pattern.empty() && !trajectory_file) {
+            cerr << util::err{}
+                 << "Provide the poses either with '--pose-file' or "
+                    "'--trajectory'!\n";
+            return 1;
+        }
         recognition_analysis_input rec_in{
             /*depth_image_pattern=*/depth_image_path,
             /*pose_file_pattern=*/pose_file_pattern,
+            /*trajectory_file=*/trajectory_file,
+            /*trajectory_format=*/
+            str_to_trajectory_format(trajectory_format_name),
+            /*frame_timestamps_file=*/frame_timestamps_file,
+            /*max_time_difference=*/max_time_difference,
             /*intrinsic_file=*/intrinsic_file,
             /*mask_file=*/mask_file,
             /*matching_norm=*/str_to_norm(norm_name),
-            /*keypoint_distance_threshold=*/keypoint_distance_threshold};
+            /*match_strategy=*/str_to_strategy(strategy_name),
+            /*match_ratio=*/match_ratio,
+            /*keypoint_distance_threshold=*/keypoint_distance_threshold,
+            /*icp_coarse_only=*/icp_coarse_only};
         recognition_analysis_output_options out_opts{
             /*backproject_pattern=*/backproject_pattern,
             /*original_files=*/original_images,
@@ -297,7 +469,8 @@ MAIN_HEAD("Determine Statistical Characteristica of the Descriptors") {
                                    gsl::narrow<int>(fn_strength));
         backproject_style fp_style(fp_rgb[0], fp_rgb[1], fp_rgb[2],
                                    gsl::narrow<int>(fp_strength));
-        return analyze_recognition_performance(in, rec_in, out_opts,
+        return analyze_recognition_performance(in, exact_statistics, rec_in,
+                                               out_opts,
                                                {tp_style, fn_style, fp_style});
     }
 
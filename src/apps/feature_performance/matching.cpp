@@ -1,4 +1,3 @@
-#define _LIBCPP_ENABLE_THREAD_SAFETY_ANNOTATIONS
 #include "matching.h"
 
 #include <boost/histogram/ostream.hpp>
@@ -6,18 +5,24 @@
 #include <fstream>
 #include <gsl/gsl>
 #include <iterator>
+#include <map>
+#include <memory>
 #include <opencv2/core/base.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/features2d.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <sens_loc/analysis/ann_index.h>
+#include <sens_loc/analysis/descriptor_matching.h>
 #include <sens_loc/analysis/distance.h>
 #include <sens_loc/io/histogram.h>
 #include <sens_loc/io/image.h>
 #include <sens_loc/util/console.h>
-#include <sens_loc/util/thread_analysis.h>
 #include <util/batch_visitor.h>
+#include <util/frame_cache.h>
+#include <util/index_shards.h>
+#include <util/input_source.h>
 #include <util/statistic_visitor.h>
 
 using namespace cv;
@@ -26,96 +31,174 @@ using namespace gsl;
 
 namespace {
 
+using sens_loc::analysis::distance_accumulator;
+
+/// Match distances of the frames in one chunk of indices.
+struct match_shard {
+    distance_accumulator minimal_distances;
+    int64_t              total_descriptors = 0L;
+};
+
+/// Match distances of all frames for one gap, collected per chunk of indices.
 struct descriptor_stat_data {
-    descriptor_stat_data() = default;
+    descriptor_stat_data(int first, int last, bool exact_statistics)
+        : _shards{first, last,
+                  match_shard{distance_accumulator{exact_statistics}, 0L},
+                  [](match_shard& into, match_shard& from) {
+                      into.minimal_distances.merge(from.minimal_distances);
+                      into.total_descriptors += from.total_descriptors;
+                  }} {}
 
-    void insert_matches(gsl::span<DMatch> matches,
+    void insert_matches(int               idx,
+                        gsl::span<DMatch> matches,
                         int               descriptor_count) noexcept {
-        lock_guard l{_mutex};
-        transform(begin(matches), end(matches),
-                  back_inserter(_global_minimal_distances),
-                  [](const DMatch& m) { return m.distance; });
-        _total_descriptors += descriptor_count;
+        match_shard& shard = _shards.local(idx);
+        for (const DMatch& m : matches)
+            shard.minimal_distances.insert(m.distance);
+        shard.total_descriptors += descriptor_count;
     }
+    void complete(int idx) noexcept { _shards.complete(idx); }
 
-    pair<vector<float>, int64_t> extract() noexcept {
-        lock_guard                   l{_mutex};
-        pair<vector<float>, int64_t> p{move(_global_minimal_distances),
-                                       _total_descriptors};
-        _global_minimal_distances = vector<float>();
-        _total_descriptors        = 0UL;
-        return p;
+    /// \returns the match distances and the number of descriptors of all
+    /// chunks, merged in the order of the indices
+    /// \pre all chunks are completed
+    pair<distance_accumulator, int64_t> extract() noexcept {
+        match_shard& merged = _shards.result();
+        return {move(merged.minimal_distances), merged.total_descriptors};
     }
 
   private:
-    mutex                                   _mutex;
-    vector<float> _global_minimal_distances GUARDED_BY(_mutex);
-    int64_t _total_descriptors              GUARDED_BY(_mutex) = 0L;
+    sens_loc::apps::index_shards<match_shard> _shards;
 };
 
+/// Number of exact matches, that were found by the approximate matching as
+/// well.
+struct ann_recall_data {
+    ann_recall_data(int first, int last)
+        : _shards{first, last, recall_counts{},
+                  [](recall_counts& into, recall_counts& from) {
+                      into.pairs += from.pairs;
+                      into.exact += from.exact;
+                      into.found += from.found;
+                  }} {}
+
+    void insert(int                   idx,
+                const vector<DMatch>& exact,
+                const vector<DMatch>& approximate) noexcept {
+        // Both are ordered by the query index.
+        size_t found = 0UL;
+        auto   it    = begin(approximate);
+        for (const DMatch& m : exact) {
+            while (it != end(approximate) && it->queryIdx < m.queryIdx)
+                ++it;
+            if (it != end(approximate) && it->queryIdx == m.queryIdx &&
+                it->trainIdx == m.trainIdx)
+                ++found;
+        }
+        recall_counts& counts = _shards.local(idx);
+        ++counts.pairs;
+        counts.exact += exact.size();
+        counts.found += found;
+    }
+    void complete(int idx) noexcept { _shards.complete(idx); }
+
+    /// \pre all chunks are completed
+    void print() {
+        const recall_counts& total = _shards.result();
+        if (total.pairs == 0UL)
+            return;
+        auto s = sens_loc::synced();
+        std::cerr << sens_loc::util::info{} << "Approximate matching found "
+                  << total.found << " of " << total.exact
+                  << " exact matches ("
+                  << (total.exact > 0UL ? 100.0 * double(total.found) /
+                                              double(total.exact)
+                                        : 100.0)
+                  << "% recall) in " << total.pairs << " sampled pairs\n";
+    }
+
+  private:
+    struct recall_counts {
+        size_t pairs = 0UL;
+        size_t exact = 0UL;
+        size_t found = 0UL;
+    };
+    sens_loc::apps::index_shards<recall_counts> _shards;
+};
+
+/// Keypoints and descriptors of one frame, shared by all pairs that contain
+/// the frame.
+struct feature_frame {
+    vector<KeyPoint> keypoints;
+    Mat              descriptors;
+
+    /// Only built for approximate matching.
+    optional<sens_loc::analysis::ann_index> index;
+};
+using feature_cache = sens_loc::apps::frame_cache<feature_frame>;
+
 class matching {
   public:
-    matching(descriptor_stat_data& accumulated_data,
-             NormTypes             norm_to_use,
-             bool                  crosscheck,
-             string_view           input_pattern,
-             optional<string_view> output_pattern,
-             optional<string_view> original_files) noexcept
+    matching(map<int, descriptor_stat_data>&        accumulated_data,
+             feature_cache&                         cache,
+             ann_recall_data&                       recall,
+             NormTypes                              norm_to_use,
+             sens_loc::analysis::match_strategy     strategy,
+             float                                  match_ratio,
+             optional<sens_loc::apps::ann_matching> ann,
+             vector<int>                            gaps,
+             int                                    first_idx,
+             optional<string_view>                  output_pattern,
+             optional<string_view>                  original_files) noexcept
         : accumulated_data{accumulated_data}
-        , matcher{BFMatcher::create(norm_to_use, crosscheck)}
-        , input_pattern{input_pattern}
+        , cache{cache}
+        , recall{recall}
+        , norm{norm_to_use}
+        , strategy{strategy}
+        , match_ratio{match_ratio}
+        , ann{move(ann)}
+        , gaps{move(gaps)}
+        , first_idx{first_idx}
         , output_pattern{output_pattern}
         , original_images{original_files} {
         // XOR is true if both operands have the same value.
         Expects(!(output_pattern.has_value() ^ original_images.has_value()) &&
                 "Either both or none are set");
+        Expects(!this->gaps.empty());
     }
 
     void operator()(int idx,
                     optional<vector<KeyPoint>> /*keypoints*/,  // NOLINT
-                    optional<Mat> descriptors) noexcept {
-        Expects(descriptors.has_value());
-        if (descriptors->rows == 0)
-            return;
-
+                    optional<Mat> /*descriptors*/) noexcept {
         try {
-            const int         previous_idx = idx - 1;
-            const FileStorage previous_img = sens_loc::io::open_feature_file(
-                fmt::format(input_pattern, previous_idx));
-            Mat previous_descriptors =
-                sens_loc::io::load_descriptors(previous_img);
-
-            vector<DMatch> matches;
-            matcher->match(*descriptors, previous_descriptors, matches);
-            accumulated_data.insert_matches(matches, descriptors->rows);
-
-            // Plot the matching between the descriptors of the previous and the
-            // current frame.
-            if (output_pattern) {
-                const vector<KeyPoint> previous_keypoints =
-                    sens_loc::io::load_keypoints(previous_img);
-
-                const FileStorage this_feature =
-                    sens_loc::io::open_feature_file(
-                        fmt::format(input_pattern, idx));
-                const vector<KeyPoint> this_keypoints =
-                    sens_loc::io::load_keypoints(this_feature);
-
-                const string img_p1 = fmt::format(*original_images, idx - 1);
-                const string img_p2 = fmt::format(*original_images, idx);
-                auto         img1   = sens_loc::io::load_as_8bit_gray(img_p1);
-                auto         img2   = sens_loc::io::load_as_8bit_gray(img_p2);
-
-                if (!img1 || !img2)
-                    return;
-
-                Mat out_img;
-                drawMatches(img2->data(), this_keypoints, img1->data(),
-                            previous_keypoints, matches, out_img,
-                            Scalar(0, 0, 255), Scalar(255, 0, 0));
-
-                const string output = fmt::format(*output_pattern, idx);
-                imwrite(output, out_img);
+            // All frames are loaded through the cache, that shares them
+            // between the pairs 'idx - gap' and 'idx'.
+            const shared_ptr<const feature_frame> current = cache.get(idx);
+            if (current->descriptors.rows == 0)
+                return;
+
+            for (const int gap : gaps) {
+                const int previous_idx = idx - gap;
+                // The first frames of the batch have no partner for larger
+                // gaps.
+                if (previous_idx < first_idx)
+                    continue;
+                const shared_ptr<const feature_frame> previous =
+                    cache.get(previous_idx);
+
+                vector<DMatch> matches = match(*current, *previous);
+                if (ann && ann->recall_sample > 0 &&
+                    idx % ann->recall_sample == 0)
+                    recall.insert(idx, exact_match(*current, *previous),
+                                  matches);
+                accumulated_data.at(gap).insert_matches(
+                    idx, matches, current->descriptors.rows);
+
+                // Plot the matching between the descriptors of the previous
+                // and the current frame, only for the first gap.
+                if (output_pattern && gap == gaps.front())
+                    plot_matches(idx, previous_idx, *current, *previous,
+                                 matches);
             }
         } catch (...) {
             std::cerr << sens_loc::util::err{}
@@ -124,85 +207,207 @@ class matching {
         }
     }
 
+    vector<DMatch> exact_match(const feature_frame& query,
+                               const feature_frame& train) const {
+        return sens_loc::analysis::match_descriptors(
+            query.descriptors, train.descriptors, norm, strategy, match_ratio);
+    }
+    vector<DMatch> match(const feature_frame& query,
+                         const feature_frame& train) const {
+        if (!ann)
+            return exact_match(query, train);
+        return sens_loc::analysis::match_descriptors(*query.index, *train.index,
+                                                     strategy, match_ratio);
+    }
+
     size_t postprocess(const optional<string>& stat_file,
                        const optional<string>& matched_distance_histo) {
-        auto [distances, total_descriptors] = accumulated_data.extract();
-        if (distances.empty())
-            return 0UL;
-
-        sort(begin(distances), end(distances));
-        const auto                   dist_bins = 25;
-        sens_loc::analysis::distance distance_stat{distances, dist_bins};
+        // With multiple gaps, the results are labeled by their gap.
+        const bool multiple_gaps = gaps.size() > 1UL;
 
+        optional<cv::FileStorage> stat_out;
         if (stat_file) {
-            cv::FileStorage stat_out{*stat_file,
-                                     cv::FileStorage::WRITE |
-                                         cv::FileStorage::FORMAT_YAML};
-            stat_out.writeComment(
+            stat_out.emplace(*stat_file, cv::FileStorage::WRITE |
+                                             cv::FileStorage::FORMAT_YAML);
+            stat_out->writeComment(
                 "The following values contain the results of the statistical "
                 "analysis for descriptor distance to the closest descriptor "
                 "after matching");
-            write(stat_out, "match_distance", distance_stat.get_statistic());
-            stat_out.release();
-        } else {
-            cout << "==== Match Distances\n"
-                 << "total count:    " << total_descriptors << "\n"
-                 << "matched count:  " << distances.size() << "\n"
-                 << "matched/total:  "
-                 << narrow_cast<double>(distances.size()) /
-                        narrow_cast<double>(total_descriptors)
-                 << "\n"
-                 << "min:            " << distance_stat.min() << "\n"
-                 << "max:            " << distance_stat.max() << "\n"
-                 << "median:         " << distance_stat.median() << "\n"
-                 << "mean:           " << distance_stat.mean() << "\n"
-                 << "Variance:       " << distance_stat.variance() << "\n"
-                 << "StdDev:         " << distance_stat.stddev() << "\n"
-                 << "Skewness:       " << distance_stat.skewness() << "\n";
         }
-        if (matched_distance_histo) {
-            std::ofstream gnuplot_data{*matched_distance_histo};
-            gnuplot_data << sens_loc::io::to_gnuplot(distance_stat.histogram())
-                         << std::endl;
-        } else {
-            cout << distance_stat.histogram() << "\n";
+        optional<std::ofstream> gnuplot_data;
+        if (matched_distance_histo)
+            gnuplot_data.emplace(*matched_distance_histo);
+
+        size_t n_elements = 0UL;
+        for (const int gap : gaps) {
+            auto [distances, total_descriptors] =
+                accumulated_data.at(gap).extract();
+            if (distances.empty())
+                continue;
+            const size_t matched = distances.count();
+            n_elements += matched;
+
+            const auto                   dist_bins = 25;
+            sens_loc::analysis::distance distance_stat{move(distances),
+                                                       dist_bins};
+
+            if (stat_out) {
+                write(*stat_out,
+                      multiple_gaps ? fmt::format("match_distance_gap_{}", gap)
+                                    : string("match_distance"),
+                      distance_stat.get_statistic());
+            } else {
+                cout << "==== Match Distances";
+                if (multiple_gaps)
+                    cout << " (gap " << gap << ")";
+                cout << "\n"
+                     << "total count:    " << total_descriptors << "\n"
+                     << "matched count:  " << matched << "\n"
+                     << "matched/total:  "
+                     << narrow_cast<double>(matched) /
+                            narrow_cast<double>(total_descriptors)
+                     << "\n"
+                     << "min:            " << distance_stat.min() << "\n"
+                     << "max:            " << distance_stat.max() << "\n"
+                     << "median:         " << distance_stat.median() << "\n"
+                     << "mean:           " << distance_stat.mean() << "\n"
+                     << "Variance:       " << distance_stat.variance() << "\n"
+                     << "StdDev:         " << distance_stat.stddev() << "\n"
+                     << "Skewness:       " << distance_stat.skewness() << "\n";
+            }
+            if (gnuplot_data) {
+                // Each gap is a separate data block, selected with 'index'
+                // in gnuplot.
+                if (multiple_gaps)
+                    *gnuplot_data << "# gap " << gap << "\n";
+                *gnuplot_data
+                    << sens_loc::io::to_gnuplot(distance_stat.histogram())
+                    << std::endl;
+                if (multiple_gaps)
+                    *gnuplot_data << "\n\n";
+            } else {
+                cout << distance_stat.histogram() << "\n";
+            }
         }
-        return distances.size();
+        if (stat_out)
+            stat_out->release();
+        return n_elements;
     }
 
   private:
-    descriptor_stat_data& accumulated_data;
+    void plot_matches(int                   idx,
+                      int                   previous_idx,
+                      const feature_frame&  current,
+                      const feature_frame&  previous,
+                      const vector<DMatch>& matches) const {
+        const string originals{*original_images};
+        auto         img1 =
+            sens_loc::apps::load_input_as_8bit_gray(originals, previous_idx);
+        auto img2 = sens_loc::apps::load_input_as_8bit_gray(originals, idx);
+
+        if (!img1 || !img2)
+            return;
+
+        Mat out_img;
+        drawMatches(img2->data(), current.keypoints, img1->data(),
+                    previous.keypoints, matches, out_img, Scalar(0, 0, 255),
+                    Scalar(255, 0, 0));
+
+        const string output = fmt::format(*output_pattern, idx);
+        imwrite(output, out_img);
+    }
+
+    map<int, descriptor_stat_data>& accumulated_data;
+    feature_cache&                  cache;
+    ann_recall_data&                recall;
 
-    Ptr<BFMatcher>        matcher;
-    string_view           input_pattern;
-    optional<string_view> output_pattern;
-    optional<string_view> original_images;
+    NormTypes                              norm;
+    sens_loc::analysis::match_strategy     strategy;
+    float                                  match_ratio;
+    optional<sens_loc::apps::ann_matching> ann;
+    vector<int>                            gaps;
+    int                                    first_idx;
+    optional<string_view>                  output_pattern;
+    optional<string_view>                  original_images;
 };
 }  // namespace
 
 namespace sens_loc::apps {
-int analyze_matching(util::processing_input       in,
-                     NormTypes                    norm_to_use,
-                     bool                         crosscheck,
-                     const optional<string>&      stat_file,
-                     const optional<string>&      matched_distance_histo,
-                     const optional<string_view>& output_pattern,
-                     const optional<string_view>& original_files) {
-    Expects(in.start < in.end && "Matching requires at least 2 images");
-    using visitor = statistic_visitor<matching, required_data::descriptors>;
-    descriptor_stat_data data;
+int analyze_matching(util::processing_input        in,
+                     bool                          exact_statistics,
+                     NormTypes                     norm_to_use,
+                     analysis::match_strategy      strategy,
+                     float                         match_ratio,
+                     const optional<ann_matching>& ann,
+                     vector<int>                   gaps,
+                     const optional<string>&       stat_file,
+                     const optional<string>&       matched_distance_histo,
+                     const optional<string_view>&  output_pattern,
+                     const optional<string_view>&  original_files) {
+    Expects(!gaps.empty());
+    sort(begin(gaps), end(gaps));
+    gaps.erase(unique(begin(gaps), end(gaps)), end(gaps));
+    Expects(gaps.front() > 0);
+    Expects(in.start + gaps.front() <= in.end &&
+            "Matching requires at least 2 images");
+
+    // Frames are matched "backwards" with the frame 'gap' indices before
+    // them.
+    const int first = in.start + gaps.front();
+
+    map<int, descriptor_stat_data> data;
+    for (const int gap : gaps)
+        data.try_emplace(gap, first, in.end, exact_statistics);
+
+    // The keypoints are only required for plotting.
+    const bool plot = output_pattern.has_value();
+    // Each worker needs the frames back to the largest gap, the additional
+    // slots absorb the out-of-order scheduling of the indices.
+    const size_t capacity =
+        shared_executor().num_workers() * (gaps.back() + 2UL);
+    // The index is built once per frame and shared by all pairs, too.
+    auto load_frame = [input = string(in.input_pattern), plot, norm_to_use,
+                       ann](int idx) {
+        const auto    f = open_features(input, idx);
+        feature_frame frame;
+        if (plot)
+            frame.keypoints = io::load_keypoints(f);
+        frame.descriptors = io::load_descriptors(f);
+        if (ann)
+            frame.index.emplace(frame.descriptors, norm_to_use,
+                                ann->parameters);
+        return frame;
+    };
+    feature_cache   cache{load_frame, capacity};
+    ann_recall_data recall{first, in.end};
+
+    using visitor = statistic_visitor<matching, required_data::none>;
     auto analysis_v = visitor{/*input_pattern=*/in.input_pattern,
                               /*accumulated_data=*/data,
+                              /*cache=*/cache,
+                              /*recall=*/recall,
                               /*norm_to_use=*/norm_to_use,
-                              /*crosscheck=*/crosscheck,
-                              /*input_pattern=*/in.input_pattern,
+                              /*strategy=*/strategy,
+                              /*match_ratio=*/match_ratio,
+                              /*ann=*/ann,
+                              /*gaps=*/gaps,
+                              /*first_idx=*/in.start,
                               /*output_pattern=*/output_pattern,
                               /*original_files=*/original_files};
 
-    auto f = parallel_visitation(
-        in.start + 1,  // Because two consecutive images are matched, the first
-                       // index is skipped. This requires "backwards" matching.
-        in.end, analysis_v);
+    auto f = parallel_visitation(first, in.end, analysis_v, default_shard_chunk,
+                                 [&data, &recall](int idx) noexcept {
+                                     for (auto& [gap, gap_data] : data)
+                                         gap_data.complete(idx);
+                                     recall.complete(idx);
+                                 });
+    {
+        auto s = synced();
+        std::cerr << util::info{} << "Loaded " << cache.misses()
+                  << " feature files for "
+                  << cache.hits() + cache.misses() << " requests\n";
+    }
+    recall.print();
     size_t n_elements = f.postprocess(stat_file, matched_distance_histo);
 
     return n_elements > 0UL ? 0 : 1;
@@ -3,15 +3,38 @@
 
 #include <opencv2/core/base.hpp>
 #include <optional>
+#include <sens_loc/analysis/ann_index.h>
+#include <sens_loc/analysis/descriptor_matching.h>
 #include <string_view>
 #include <util/common_structures.h>
+#include <vector>
 
 namespace sens_loc::apps {
-int analyze_matching(util::processing_input            in,
-                     cv::NormTypes                     norm_to_use,
-                     bool                              crosscheck,
-                     const std::optional<std::string>& stat_file,
-                     const std::optional<std::string>& matched_distance_histo,
+/// Configuration of the approximate matching in \c analyze_matching.
+struct ann_matching {
+    analysis::ann_parameters parameters;
+    /// Every n-th frame is matched exactly as well to measure the recall of
+    /// the approximate matches, \c 0 disables the measurement.
+    int recall_sample = 0;
+};
+
+/// Match the descriptors of each frame with the frames \p gaps indices
+/// before it and analyze the distances of the matches for each gap.
+/// Each feature file is loaded only once for all gaps.
+/// If \p ann is set, the descriptors are matched approximately with an
+/// index per frame.
+/// If \p exact_statistics is set, all match distances are stored for exact
+/// quantiles instead of approximating them in constant memory.
+/// \sa analysis::match_descriptors for \p strategy and \p match_ratio
+int analyze_matching(util::processing_input             in,
+                     bool                               exact_statistics,
+                     cv::NormTypes                      norm_to_use,
+                     analysis::match_strategy           strategy,
+                     float                              match_ratio,
+                     const std::optional<ann_matching>& ann,
+                     std::vector<int>                   gaps,
+                     const std::optional<std::string>&  stat_file,
+                     const std::optional<std::string>&  matched_distance_histo,
                      const std::optional<std::string_view>& output_pattern,
                      const std::optional<std::string_view>& original_files);
 }  // namespace sens_loc::apps
@@ -1,4 +1,3 @@
-#define _LIBCPP_ENABLE_THREAD_SAFETY_ANNOTATIONS
 #include "min_dist.h"
 
 #include <algorithm>
@@ -10,62 +9,51 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <mutex>
 #include <opencv2/core/base.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/persistence.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <optional>
+#include <sens_loc/analysis/descriptor_distance.h>
 #include <sens_loc/analysis/distance.h>
 #include <sens_loc/io/histogram.h>
 #include <sens_loc/util/correctness_util.h>
-#include <sens_loc/util/thread_analysis.h>
 #include <stdexcept>
 #include <string_view>
 #include <util/batch_visitor.h>
 #include <util/common_structures.h>
+#include <util/index_shards.h>
 #include <util/statistic_visitor.h>
 
 using namespace std;
 
 namespace {
 
-template <cv::NormTypes NT>
-struct element_access {
-    using type                 = float;
-    static constexpr int dtype = CV_32F;
-};
-template <>
-struct element_access<cv::NormTypes::NORM_HAMMING> {
-    using type                 = int;
-    static constexpr int dtype = CV_32S;
-};
-template <>
-struct element_access<cv::NormTypes::NORM_HAMMING2> {
-    using type                 = int;
-    static constexpr int dtype = CV_32S;
-};
+using sens_loc::analysis::distance_accumulator;
 
+/// Minimal distances of all images, collected per chunk of indices.
 struct distance_stat_data {
-    distance_stat_data() = default;
+    distance_stat_data(int first, int last, bool exact_statistics)
+        : _min_distances{first, last, distance_accumulator{exact_statistics},
+                         [](distance_accumulator& into,
+                            distance_accumulator& from) { into.merge(from); }} {
+    }
 
-    void insert_distances(gsl::span<float> distances) noexcept {
-        lock_guard l{_process_mutex};
-        _global_min_distances.insert(end(_global_min_distances),
-                                     begin(distances), end(distances));
+    void insert_distances(int idx, gsl::span<const float> distances) noexcept {
+        _min_distances.local(idx).insert(distances);
     }
+    void complete(int idx) noexcept { _min_distances.complete(idx); }
 
-    vector<float> extract() noexcept {
-        lock_guard    l{_process_mutex};
-        vector<float> r       = move(_global_min_distances);
-        _global_min_distances = vector<float>();
-        return r;
+    /// \returns the distances of all chunks, merged in the order of the
+    /// indices
+    /// \pre all chunks are completed
+    distance_accumulator extract() noexcept {
+        return move(_min_distances.result());
     };
 
   private:
-    mutex                               _process_mutex;
-    vector<float> _global_min_distances GUARDED_BY(_process_mutex);
+    sens_loc::apps::index_shards<distance_accumulator> _min_distances;
 };
 
 /// Calculate the minimal distance between descriptors within one image
@@ -74,43 +62,24 @@ struct distance_stat_data {
 template <cv::NormTypes NT>
 class min_descriptor_distance {
   public:
-    static const int data_type = element_access<NT>::dtype;
-    using access_type          = typename element_access<NT>::type;
-
     min_descriptor_distance(distance_stat_data& data)
         : accumulated_data{data} {}
 
-    void operator()(int /*idx*/,
+    void operator()(int                            idx,
                     optional<vector<cv::KeyPoint>> keypoints,  // NOLINT
                     optional<cv::Mat>              descriptors) noexcept {
         Expects(!keypoints.has_value());
         Expects(descriptors.has_value());
 
-        if (descriptors->rows == 0)
-            return;
-
-        cv::Mat distances;
-        cv::batchDistance(*descriptors, *descriptors, distances, data_type,
-                          cv::noArray(),
-                          /*normType=*/NT);
-
         // Calculate the minimal distances within that image.
-        vector<float> local_min_distances;
-        local_min_distances.reserve(distances.rows);
-        for (decltype(distances.rows) row = 0; row < distances.rows; ++row) {
-            // Make the distance to itself maximal, as that is known to
-            // be zero and needs to be ignored.
-            distances.at<access_type>(row, row) =
-                numeric_limits<access_type>::max();
-
-            cv::Mat r = distances.row(row);
-            auto    d = gsl::narrow<float>(
-                *min_element(r.begin<access_type>(), r.end<access_type>()));
-
-            local_min_distances.push_back(d);
-        }
+        // The images are processed in parallel, so the rows of one image are
+        // processed sequentially.
+        vector<float> local_min_distances =
+            sens_loc::analysis::min_descriptor_distances(*descriptors, NT);
+        if (local_min_distances.empty())
+            return;
 
-        accumulated_data.insert_distances(local_min_distances);
+        accumulated_data.insert_distances(idx, local_min_distances);
     }
 
     /// Postprocess the findings of the minimal distances for each image to
@@ -118,14 +87,13 @@ class min_descriptor_distance {
     /// and should only be called once.
     size_t postprocess(const optional<string>& stat_file,
                        const optional<string>& min_dist_histo) noexcept {
-        // Lock the mutex, just in case. This method is not expected to be
-        // run in parallel, but it could.
-        vector<float> global_distances = accumulated_data.extract();
+        distance_accumulator global_distances = accumulated_data.extract();
+        const size_t n_elements = global_distances.count();
 
-        sort(begin(global_distances), end(global_distances));
         const auto                   bins = 25UL;
         sens_loc::analysis::distance distance_stat{
-            global_distances, bins, "Minimal Intra Image Descriptor Distances"};
+            move(global_distances), bins,
+            "Minimal Intra Image Descriptor Distances"};
 
         if (stat_file) {
             cv::FileStorage stat_out{*stat_file,
@@ -153,7 +121,7 @@ class min_descriptor_distance {
         } else {
             cout << distance_stat.histogram() << "\n";
         }
-        return global_distances.size();
+        return n_elements;
     }
 
   private:
@@ -163,6 +131,7 @@ class min_descriptor_distance {
 
 template <cv::NormTypes NT>
 int analyze_min_distance_impl(sens_loc::util::processing_input in,
+                              bool                             exact_statistics,
                               const optional<string>&          stat_file,
                               const optional<string>&          min_dist_histo) {
     using namespace sens_loc::apps;
@@ -170,9 +139,10 @@ int analyze_min_distance_impl(sens_loc::util::processing_input in,
     using visitor = statistic_visitor<min_descriptor_distance<NT>,
                                       required_data::descriptors>;
 
-    distance_stat_data data;
-    auto               f =
-        parallel_visitation(in.start, in.end, visitor{in.input_pattern, data});
+    distance_stat_data data{in.start, in.end, exact_statistics};
+    auto f = parallel_visitation(
+        in.start, in.end, visitor{in.input_pattern, data}, default_shard_chunk,
+        [&data](int idx) noexcept { data.complete(idx); });
 
     size_t n_elements = f.postprocess(stat_file, min_dist_histo);
 
@@ -182,6 +152,7 @@ int analyze_min_distance_impl(sens_loc::util::processing_input in,
 
 namespace sens_loc::apps {
 int analyze_min_distance(util::processing_input  in,
+                         bool                    exact_statistics,
                          cv::NormTypes           norm_to_use,
                          const optional<string>& stat_file,
                          const optional<string>& min_dist_histo) {
@@ -189,7 +160,7 @@ int analyze_min_distance(util::processing_input  in,
 #define SWITCH_CV_NORM(NORM_NAME)                                              \
     if (norm_to_use == cv::NormTypes::NORM_##NORM_NAME)                        \
         return analyze_min_distance_impl<cv::NormTypes::NORM_##NORM_NAME>(     \
-            in, stat_file, min_dist_histo);
+            in, exact_statistics, stat_file, min_dist_histo);
     SWITCH_CV_NORM(L1)
     SWITCH_CV_NORM(L2)
     SWITCH_CV_NORM(L2SQR)
@@ -7,7 +7,12 @@
 #include <util/common_structures.h>
 
 namespace sens_loc::apps {
+/// Analyze the minimal distance of each descriptor to the other descriptors
+/// of the same image.
+/// \param exact_statistics store all distances for exact quantiles instead
+/// of approximating them in constant memory
 int analyze_min_distance(util::processing_input            in,
+                         bool                              exact_statistics,
                          cv::NormTypes                     norm_to_use,
                          const std::optional<std::string>& stat_file,
                          const std::optional<std::string>& min_dist_histo);
@@ -1,4 +1,3 @@
-#define _LIBCPP_ENABLE_THREAD_SAFETY_ANNOTATIONS
 #include "recognition_performance.h"
 
 #include "icp.h"
@@ -14,6 +13,7 @@
 #include <opencv2/features2d.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/rgbd/depth.hpp>
+#include <sens_loc/analysis/descriptor_matching.h>
 #include <sens_loc/analysis/distance.h>
 #include <sens_loc/analysis/match.h>
 #include <sens_loc/analysis/recognition_performance.h>
@@ -28,8 +28,10 @@
 #include <sens_loc/math/pointcloud.h>
 #include <sens_loc/plot/backprojection.h>
 #include <sens_loc/util/console.h>
-#include <sens_loc/util/thread_analysis.h>
 #include <util/batch_visitor.h>
+#include <util/frame_cache.h>
+#include <util/index_shards.h>
+#include <util/input_source.h>
 #include <util/statistic_visitor.h>
 
 using namespace std;
@@ -39,40 +41,127 @@ using namespace cv;
 
 namespace {
 
+/// Provides the absolute pose of each frame, either from one pose file per
+/// frame or from a trajectory of the whole sequence.
+///
+/// A trajectory is read once on construction and each pose is then looked
+/// up by the frame index.
+class pose_source {
+  public:
+    /// Load the poses of the frames \p first to \p last, inclusive, if the
+    /// \p input provides a trajectory.
+    pose_source(const apps::recognition_analysis_input& input,
+                int                                     first,
+                int                                     last) noexcept(false)
+        : _pose_file_pattern{input.pose_file_pattern}
+        , _first{first} {
+        Expects(first <= last);
+        if (!input.trajectory_file)
+            return;
+
+        ifstream                 trajectory{string(*input.trajectory_file)};
+        optional<io::trajectory> t =
+            io::load_trajectory(trajectory, input.trajectory_format);
+        if (!t) {
+            ostringstream oss;
+            oss << "Trajectory " << *input.trajectory_file
+                << " could not be loaded!";
+            throw invalid_argument{oss.str()};
+        }
+        const auto n_frames = gsl::narrow<size_t>(last - first + 1);
+
+        if (!input.frame_timestamps_file) {
+            if (t->poses.size() <= gsl::narrow<size_t>(last)) {
+                ostringstream oss;
+                oss << "Trajectory " << *input.trajectory_file << " has only "
+                    << t->poses.size() << " poses!";
+                throw invalid_argument{oss.str()};
+            }
+            const auto begin = t->poses.begin() + first;
+            _poses.assign(begin, begin + gsl::narrow<long>(n_frames));
+            return;
+        }
+
+        ifstream timestamp_file{string(*input.frame_timestamps_file)};
+        optional<vector<double>> times = io::load_timestamps(timestamp_file);
+        if (!times || times->size() <= gsl::narrow<size_t>(last)) {
+            ostringstream oss;
+            oss << "Timestamps " << *input.frame_timestamps_file
+                << " could not be loaded or miss frames!";
+            throw invalid_argument{oss.str()};
+        }
+        const span<const double> frame_times{*times};
+        optional<vector<math::pose_t>> poses = io::associate_poses(
+            *t, frame_times.subspan(first, gsl::narrow<long>(n_frames)),
+            input.max_time_difference);
+        if (!poses) {
+            ostringstream oss;
+            oss << "Not every frame has a pose in " << *input.trajectory_file
+                << " within " << input.max_time_difference << " seconds!";
+            throw invalid_argument{oss.str()};
+        }
+        _poses = move(*poses);
+    }
+
+    [[nodiscard]] math::pose_t pose(int idx) const noexcept(false) {
+        if (!_poses.empty())
+            return _poses.at(gsl::narrow<size_t>(idx - _first));
+
+        const string           pose_path = fmt::format(_pose_file_pattern, idx);
+        ifstream               pose_file{pose_path};
+        optional<math::pose_t> pose = io::load_pose(pose_file);
+        if (!pose) {
+            ostringstream oss;
+            oss << "Could not load pose from " << pose_path << "!";
+            throw runtime_error{oss.str()};
+        }
+        return *pose;
+    }
+
+  private:
+    string_view          _pose_file_pattern;
+    int                  _first;
+    vector<math::pose_t> _poses;
+};
+
 /// Capsulate all required data for back-and-forth projection as well
 /// as precision-recall computation.
+/// Each frame is required for the pairs with both of its neighbours, the
+/// data is loaded once and shared through a \c frame_cache.
 struct reprojection_data {
     vector<cv::KeyPoint> keypoints;
     cv::Mat              descriptors;
     math::image<ushort>  depth_image;
     math::pose_t         absolute_pose;
-
-    reprojection_data(string_view feature_path,
-                      string_view depth_path,
-                      string_view pose_path) noexcept(false) {
-        const FileStorage fs = io::open_feature_file(string(feature_path));
-        keypoints            = io::load_keypoints(fs);
-        descriptors          = io::load_descriptors(fs);
+    apps::icp_frame      icp;
+
+    /// Prepare the frame for the ICP, if \p icp_odometry is provided.
+    reprojection_data(string_view           feature_input,
+                      string_view           depth_input,
+                      int                   idx,
+                      math::pose_t          pose,
+                      double                unit_factor,
+                      const rgbd::Odometry* icp_odometry) noexcept(false)
+        : absolute_pose{move(pose)} {
+        const auto fs = apps::open_features(string(feature_input), idx);
+        keypoints     = io::load_keypoints(fs);
+        descriptors   = io::load_descriptors(fs);
 
         optional<math::image<ushort>> d_img =
-            io::load_image<ushort>(string(depth_path), IMREAD_UNCHANGED);
+            apps::load_input<ushort>(string(depth_input), idx);
         if (!d_img) {
             ostringstream oss;
-            oss << "Could not load depth image from " << depth_path << "!";
+            oss << "Could not load depth image " << idx << " from "
+                << depth_input << "!";
             throw runtime_error{oss.str()};
         }
         depth_image = move(*d_img);
-
-        ifstream               pose_file{string(pose_path)};
-        optional<math::pose_t> pose = io::load_pose(pose_file);
-        if (!pose) {
-            ostringstream oss;
-            oss << "Could not load pose from " << pose_path << "!";
-            throw runtime_error{oss.str()};
-        }
-        absolute_pose = move(*pose);
+        if (icp_odometry != nullptr)
+            icp = apps::prepare_icp_frame(*icp_odometry, depth_image,
+                                          unit_factor);
     }
 };
+using frame_data_cache = apps::frame_cache<reprojection_data>;
 
 size_t mask_backprojection(const math::image<uchar>& mask,
                            math::imagepoints_t&      points) noexcept {
@@ -88,37 +177,52 @@ size_t mask_backprojection(const math::image<uchar>& mask,
     return counter;
 }
 
+/// Results of the frames in one chunk of indices.
+struct recognition_shard {
+    analysis::distance_accumulator  selected_elements_distance;
+    analysis::recognition_statistic stats;
+    int64_t                         totally_masked = 0L;
+};
+
+/// Results of all frames, collected per chunk of indices.
 struct recognition_data {
-    recognition_data() = default;
+    recognition_data(int first, int last, bool exact_statistics)
+        : _shards{first, last, empty_shard(exact_statistics), merge} {}
 
-    void insert_recognition(span<float>                         distances,
+    void insert_recognition(int                                 idx,
+                            span<const float>                   distances,
                             const analysis::element_categories& classification,
                             size_t masked_points) noexcept {
-        lock_guard l{_mutex};
-
-        _selected_elements_distance.insert(_selected_elements_distance.end(),
-                                           begin(distances), end(distances));
-        _stats.account(classification);
-        _totally_masked += narrow<int>(masked_points);
+        recognition_shard& shard = _shards.local(idx);
+        shard.selected_elements_distance.insert(distances);
+        shard.stats.account(classification);
+        shard.totally_masked += narrow<int>(masked_points);
     }
+    void complete(int idx) noexcept { _shards.complete(idx); }
 
-    tuple<vector<float>, analysis::recognition_statistic, int64_t>
+    /// \returns the results of all chunks, merged in the order of the indices
+    /// \pre all chunks are completed
+    tuple<analysis::distance_accumulator,
+          analysis::recognition_statistic,
+          int64_t>
     extract() noexcept {
-        lock_guard l{_mutex};
-        tuple<vector<float>, analysis::recognition_statistic, int64_t> t{
-            move(_selected_elements_distance), move(_stats), _totally_masked};
-
-        _selected_elements_distance = vector<float>();
-        _stats                      = analysis::recognition_statistic();
-        _totally_masked             = 0L;
-        return t;
+        recognition_shard& merged = _shards.result();
+        return {move(merged.selected_elements_distance), move(merged.stats),
+                merged.totally_masked};
     }
 
   private:
-    mutex                                     _mutex;
-    vector<float> _selected_elements_distance GUARDED_BY(_mutex);
-    analysis::recognition_statistic _stats    GUARDED_BY(_mutex);
-    int64_t _totally_masked                   GUARDED_BY(_mutex) = 0L;
+    [[nodiscard]] static recognition_shard empty_shard(bool exact_statistics) {
+        return {analysis::distance_accumulator{exact_statistics},
+                analysis::recognition_statistic{exact_statistics}, 0L};
+    }
+    static void merge(recognition_shard& into, recognition_shard& from) {
+        into.selected_elements_distance.merge(from.selected_elements_distance);
+        into.stats.merge(from.stats);
+        into.totally_masked += from.totally_masked;
+    }
+
+    apps::index_shards<recognition_shard> _shards;
 };
 
 template <template <typename> typename Model = sens_loc::camera_models::pinhole,
@@ -130,18 +234,20 @@ class prec_recall_analysis {
         const apps::recognition_analysis_input&          input,
         const apps::recognition_analysis_output_options& output_options,
         recognition_data&                                accumulated_data,
+        frame_data_cache&                                frames,
+        Ptr<rgbd::Odometry>&                             icp,
         const apps::backproject_config&                  backproject_config)
         : _feature_file_pattern{feature_file_pattern}
+        , _frames{frames}
         , _input{input}
         , _output_options{output_options}
-        , _matcher{cv::BFMatcher::create(_input.matching_norm,
-                                         /*crosscheck=*/true)}
+        , _icp{icp}
         , _mask{nullopt}
         , _accumulated_data{accumulated_data}
         , _backprojection_config{backproject_config} {
         Expects(!_feature_file_pattern.empty());
         Expects(!_input.depth_image_pattern.empty());
-        Expects(!_input.pose_file_pattern.empty());
+        Expects(!_input.pose_file_pattern.empty() || _input.trajectory_file);
         Expects(!_input.intrinsic_file.empty());
 
         ifstream intrinsic{string(_input.intrinsic_file)};
@@ -187,8 +293,7 @@ class prec_recall_analysis {
 
         if constexpr (is_same_v<decltype(_intrinsic),
                                 camera_models::pinhole<Real>>) {
-            _icp = rgbd::FastICPOdometry::create(
-                apps::cv_camera_matrix(_intrinsic));
+            _icp = apps::make_icp(_intrinsic, _input.icp_coarse_only);
         }
     }
 
@@ -205,13 +310,11 @@ class prec_recall_analysis {
         using namespace math;
         using namespace apps;
 
-        reprojection_data prev{
-            fmt::format(_feature_file_pattern, previous_idx),
-            fmt::format(_input.depth_image_pattern, previous_idx),
-            fmt::format(_input.pose_file_pattern, previous_idx)};
-        reprojection_data curr{fmt::format(_feature_file_pattern, idx),
-                               fmt::format(_input.depth_image_pattern, idx),
-                               fmt::format(_input.pose_file_pattern, idx)};
+        const shared_ptr<const reprojection_data> prev_data =
+            _frames.get(previous_idx);
+        const shared_ptr<const reprojection_data> curr_data = _frames.get(idx);
+        const reprojection_data&                  prev      = *prev_data;
+        const reprojection_data&                  curr      = *curr_data;
 
         if (prev.keypoints.empty() || curr.keypoints.empty())
             return;
@@ -222,8 +325,7 @@ class prec_recall_analysis {
         // Refine that pose with an ICP if possible.
         if (_icp) {
             auto [icp_pose, icp_success] =
-                refine_pose(*_icp, prev.depth_image, curr.depth_image,
-                            _input.unit_factor, rel_pose);
+                refine_pose(*_icp, prev.icp, curr.icp, rel_pose);
             if (icp_success) {
                 rel_pose = icp_pose;
             } else {
@@ -234,7 +336,7 @@ class prec_recall_analysis {
         }
 
         // == get keypoints as world points
-        pointcloud_t prev_points = keypoints_to_pointcloud(
+        pointcloud_soa_t prev_points = keypoints_to_pointcloud(
             prev.keypoints, prev.depth_image, _intrinsic, _input.unit_factor);
 
         imagepoints_t prev_in_img =
@@ -248,11 +350,12 @@ class prec_recall_analysis {
             _mask ? mask_backprojection(*_mask, prev_in_img) : 0UL;
         Expects(prev_in_img.size() == prev.keypoints.size());
 
-        // == Match the keypoints with cross-checking.
-        vector<DMatch> matches;
+        // == Match the keypoints, by default with cross-checking.
         // QueryDescriptors: first argument
         // TrainDescriptors: second argument
-        _matcher->match(curr.descriptors, prev.descriptors, matches);
+        const vector<DMatch> matches = analysis::match_descriptors(
+            curr.descriptors, prev.descriptors, _input.matching_norm,
+            _input.match_strategy, _input.match_ratio);
 
         using analysis::element_categories;
         using camera_models::keypoint_to_coords;
@@ -267,10 +370,9 @@ class prec_recall_analysis {
             classification.true_positives, curr_keypoints, prev_in_img);
 
         if (_output_options.backproject_pattern) {
-            string orig_f_name =
-                fmt::format(*_output_options.original_files, idx);
             optional<math::image<uchar>> orig_img =
-                io::load_as_8bit_gray(orig_f_name);
+                apps::load_input_as_8bit_gray(*_output_options.original_files,
+                                              idx);
 
             if (orig_img) {
                 // Plot false positives with orange distance line
@@ -312,13 +414,13 @@ class prec_recall_analysis {
             } else {
                 auto s = synced();
                 cerr << util::warn{} << "Original file for index '" << idx
-                     << "' ('" << orig_f_name
+                     << "' ('" << *_output_options.original_files
                      << "') could not be loaded for backprojection plot!\n";
             }
         }
 
         auto distances = pointwise_distance(t_p_t, t_p_o);
-        _accumulated_data.insert_recognition(distances, classification,
+        _accumulated_data.insert_recognition(idx, distances, classification,
                                              masked_points);
     } catch (const exception& e) {
         auto s = synced();
@@ -334,9 +436,8 @@ class prec_recall_analysis {
         if (classification.total_elements() == 0L)
             return 0UL;
 
-        sort(begin(distances), end(distances));
         const auto         dist_bins = 20;
-        analysis::distance distance_stat{distances, dist_bins,
+        analysis::distance distance_stat{move(distances), dist_bins,
                                          "backprojection error pixels"};
 
         if (_output_options.stat_file) {
@@ -457,12 +558,13 @@ class prec_recall_analysis {
 
   private:
     std::string_view                                 _feature_file_pattern;
+    frame_data_cache&                                _frames;
     const apps::recognition_analysis_input&          _input;
     const apps::recognition_analysis_output_options& _output_options;
 
     Model<Real>                  _intrinsic;
-    Ptr<rgbd::Odometry>          _icp;
-    Ptr<BFMatcher>               _matcher;
+    /// Shared with the frame loader, that prepares the frames for the icp.
+    Ptr<rgbd::Odometry>&         _icp;
     optional<math::image<uchar>> _mask;
     recognition_data&            _accumulated_data;
 
@@ -473,6 +575,7 @@ class prec_recall_analysis {
 namespace sens_loc::apps {
 int analyze_recognition_performance(
     util::processing_input                     in,
+    bool                                       exact_statistics,
     const recognition_analysis_input&          required_data,
     const recognition_analysis_output_options& output_options,
     const backproject_config&                  backproject_config) {
@@ -484,17 +587,45 @@ int analyze_recognition_performance(
     using visitor =
         statistic_visitor<prec_recall_analysis<>, required_data::none>;
 
-    recognition_data accumulator;
+    recognition_data accumulator{in.start + 1, in.end, exact_statistics};
+
+    // Each frame is used as current frame and as previous frame of its
+    // successor and evicted after both. The capacity only bounds the frames
+    // at the borders of the sequence and the out-of-order scheduling.
+    // The ICP is created by the analysis, once the intrinsic is known, and
+    // frames are loaded only afterwards. Each frame prepares its pyramids for
+    // the ICP once and is then refined against both of its neighbours.
+    Ptr<rgbd::Odometry> icp;
+    const pose_source   poses{required_data, in.start, in.end};
+    const size_t        capacity = shared_executor().num_workers() * 3UL;
+    auto                load_frame =
+        [feature_input = string(in.input_pattern), &required_data, &poses,
+         &icp](int idx) {
+            return reprojection_data{
+                feature_input, required_data.depth_image_pattern, idx,
+                poses.pose(idx), required_data.unit_factor, icp.get()};
+        };
+    frame_data_cache frames{load_frame, capacity, /*uses=*/2UL};
+
     // The odd-looking double arguments comes from the genericity of the
     // statistic-visitation. The first argument goes to \c statistic_visitor
     // and the second one to \c prec_recall_analysis
-    auto analysis_v =
-        visitor{in.input_pattern, in.input_pattern, required_data,
-                output_options,   accumulator,      backproject_config};
+    auto analysis_v = visitor{in.input_pattern, in.input_pattern,
+                              required_data,    output_options,
+                              accumulator,      frames,
+                              icp,              backproject_config};
 
     // Consecutive images are matched and analysed, therefore the first
     // index must be skipped.
-    auto   f          = parallel_visitation(in.start + 1, in.end, analysis_v);
+    auto f = parallel_visitation(
+        in.start + 1, in.end, analysis_v, default_shard_chunk,
+        [&accumulator](int idx) noexcept { accumulator.complete(idx); });
+    {
+        auto s = synced();
+        std::cerr << util::info{} << "Loaded " << frames.misses()
+                  << " frames for " << frames.hits() + frames.misses()
+                  << " requests\n";
+    }
     size_t n_elements = f.postprocess();
 
     return n_elements > 0L ? 0 : 1;
@@ -6,6 +6,8 @@
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgproc.hpp>
 #include <optional>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <sens_loc/io/pose.h>
 #include <string_view>
 #include <util/common_structures.h>
 
@@ -39,12 +41,27 @@ struct backproject_config {
 };
 
 struct recognition_analysis_input {
-    std::string_view                depth_image_pattern;
-    std::string_view                pose_file_pattern;
+    std::string_view depth_image_pattern;
+    /// File pattern with one pose per frame, empty if the poses are loaded
+    /// from \c trajectory_file.
+    std::string_view pose_file_pattern;
+    /// Single file with the poses of the whole sequence, that is read once
+    /// before the analysis.
+    std::optional<std::string_view> trajectory_file;
+    io::trajectory_format           trajectory_format;
+    /// Timestamps of the depth images. Each frame gets the pose that is
+    /// closest in time, otherwise the pose of line 'idx' is used.
+    std::optional<std::string_view> frame_timestamps_file;
+    double                          max_time_difference;
     std::string_view                intrinsic_file;
     std::optional<std::string_view> mask_file;
     cv::NormTypes                   matching_norm;
+    analysis::match_strategy        match_strategy;
+    float                           match_ratio;
     float                           keypoint_distance_threshold;
+    /// Refine the relative poses only on the coarsest level of the ICP
+    /// pyramid, which is faster but less accurate.
+    bool icp_coarse_only;
 
     /// Unit-Conversion for the ICP of kinect images. No other depth images
     /// are treated with ICP, so this is dirty set to a constant.
@@ -63,8 +80,13 @@ struct recognition_analysis_output_options {
     std::optional<std::string> false_positive_distance_histo;
 };
 
+/// Analyze how well the matched keypoints correspond to the keypoints that
+/// are backprojected with the true poses.
+/// \param exact_statistics store all distances for exact quantiles instead
+/// of approximating them in constant memory
 int analyze_recognition_performance(
     util::processing_input                     in,
+    bool                                       exact_statistics,
     const recognition_analysis_input&          required_data,
     const recognition_analysis_output_options& output_options,
     const backproject_config&                  backproject_config);
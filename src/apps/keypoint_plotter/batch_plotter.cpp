@@ -1,13 +1,14 @@
 #include "batch_plotter.h"
 
+#include "util/input_source.h"
 #include "util/parallel_processing.h"
 
 #include <fmt/core.h>
 #include <opencv2/core/mat.hpp>
-#include <opencv2/core/persistence.hpp>
 #include <opencv2/features2d.hpp>
-#include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <sens_loc/io/feature.h>
+#include <sens_loc/io/image.h>
 
 namespace sens_loc::apps {
 bool batch_plotter::process_batch(int start, int end) const noexcept {
@@ -18,26 +19,15 @@ bool batch_plotter::process_batch(int start, int end) const noexcept {
 
 bool batch_plotter::process_index(int idx) const noexcept {
     try {
-        using cv::FileNode;
-        using cv::FileStorage;
-        using cv::read;
-
-        const std::string input_file = fmt::format(_feature_file_pattern, idx);
-
-        const FileStorage fs{input_file,
-                             FileStorage::READ | FileStorage::FORMAT_YAML};
-
-        // if 'keypoints'-key does not exist give an error.
-        const FileNode            keypoints_node = fs["keypoints"];
-        std::vector<cv::KeyPoint> keypoints;
-        read(keypoints_node, keypoints);
+        // The descriptors are not required for plotting and are not loaded.
+        const io::feature_file fs =
+            open_features(std::string(_feature_file_pattern), idx);
+        const std::vector<cv::KeyPoint> keypoints = fs.keypoints();
 
         if (keypoints.empty())
             return false;
 
-        std::string    original_image;
-        const FileNode file_path_node = fs["source_path"];
-        read(file_path_node, original_image, "");
+        std::string original_image = fs.source_path();
 
         if (_target_image_file_pattern || original_image.empty()) {
             // If the feature file does not contain a path to file the features
@@ -51,8 +41,11 @@ bool batch_plotter::process_index(int idx) const noexcept {
         }
         Ensures(!original_image.empty());
 
+        // Frames of a sequence container are addressed by the index.
         const cv::Mat source_image =
-            cv::imread(original_image, cv::IMREAD_UNCHANGED);
+            io::is_sequence_path(original_image)
+                ? read_input(original_image, idx)
+                : io::read_image(original_image, cv::IMREAD_UNCHANGED);
         if (source_image.empty())
             return false;
 
@@ -78,7 +71,8 @@ bool batch_plotter::process_index(int idx) const noexcept {
                               cv::DrawMatchesFlags::DRAW_OVER_OUTIMG);
 
         const std::string output_file = fmt::format(_ouput_file_pattern, idx);
-        const bool write_success = cv::imwrite(output_file, converted_source);
+        const bool        write_success =
+            io::write_image(output_file, converted_source, _encoding);
 
         return write_success;
     } catch (const std::exception& e) {
@@ -3,6 +3,7 @@
 
 #include <gsl/gsl>
 #include <optional>
+#include <sens_loc/io/image.h>
 #include <sens_loc/util/correctness_util.h>
 #include <string_view>
 
@@ -63,11 +64,13 @@ class batch_plotter {
     batch_plotter(std::string_view                feature_file_pattern,
                   std::string_view                output_file_pattern,
                   feature_color                   color,
-                  std::optional<std::string_view> target_image_file_pattern)
+                  std::optional<std::string_view> target_image_file_pattern,
+                  const io::write_options&        encoding = {})
         : _feature_file_pattern{feature_file_pattern}
         , _ouput_file_pattern{output_file_pattern}
         , _color{color}
-        , _target_image_file_pattern{target_image_file_pattern} {
+        , _target_image_file_pattern{target_image_file_pattern}
+        , _encoding{encoding} {
         Expects(!_feature_file_pattern.empty());
         Expects(!_ouput_file_pattern.empty());
         if (_target_image_file_pattern)
@@ -97,6 +100,9 @@ class batch_plotter {
     /// for plotting. This is the case for plotting multiple feature keypoints
     /// or if the path to the file is incorrect.
     std::optional<std::string_view> _target_image_file_pattern;
+
+    /// Encoder settings for the output images.
+    io::write_options _encoding;
 };
 }  // namespace sens_loc::apps
 
@@ -6,6 +6,7 @@
 #include <stdexcept>
 #include <string>
 #include <util/colored_parse.h>
+#include <util/output_options.h>
 #include <util/tool_macro.h>
 #include <util/version_printer.h>
 #include <vector>
@@ -27,7 +28,8 @@ MAIN_HEAD("Batch-processing tool to plot keypoints and matches") {
 
     string feature_file_input_pattern;
     app.add_option("-i,--input", feature_file_input_pattern,
-                   "Define file-pattern for the feature files to be plotted")
+                   "Define file-pattern for the feature files to be plotted "
+                   "or a feature store \"features.slfseq\"")
         ->required();
 
     optional<string> original_image_input_pattern;
@@ -55,6 +57,9 @@ MAIN_HEAD("Batch-processing tool to plot keypoints and matches") {
                 "Define the color that shall be used for keypoint plotting",
                 /*defaulted=*/true);
 
+    io::write_options encoding;
+    add_output_options(app, encoding);
+
     COLORED_APP_PARSE(app, argc, argv);
 
     // Explicitly disable threading from OpenCV functions, as the
@@ -66,7 +71,8 @@ MAIN_HEAD("Batch-processing tool to plot keypoints and matches") {
     cv::setNumThreads(0);
 
     batch_plotter plotter(feature_file_input_pattern, output_pattern,
-                          str_to_color(color), original_image_input_pattern);
+                          str_to_color(color), original_image_input_pattern,
+                          encoding);
 
     return plotter.process_batch(start_idx, end_idx) ? 0 : 1;
 }
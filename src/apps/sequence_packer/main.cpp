@@ -0,0 +1,131 @@
+#include <CLI/CLI.hpp>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <rang.hpp>
+#include <sens_loc/io/compression.h>
+#include <sens_loc/io/sequence.h>
+#include <sens_loc/util/console.h>
+#include <string>
+#include <util/colored_parse.h>
+#include <util/input_source.h>
+#include <util/pipeline.h>
+#include <util/pipeline_options.h>
+#include <util/tool_macro.h>
+#include <util/version_printer.h>
+
+/// \defgroup sequence-packer-driver depth sequence container creation
+///
+/// Code that packs a sequence of image files into one container.
+
+/// Parallelized driver that packs image files into a sequence container.
+/// \sa sens_loc::io::depth_sequence
+/// \ingroup sequence-packer-driver
+/// \returns 0 if all images could be packed, 1 otherwise
+MAIN_HEAD("Pack a sequence of images into one memory-mapped container") {
+    app.footer("\n\n"
+               "An example invocation of the tool is:\n"
+               "\n"
+               "sequence_packer --input depth_{:04d}.png \\\n"
+               "                --output depth.slseq \\\n"
+               "                --calibration intrinsic.txt \\\n"
+               "                --start 0 --end 100\n"
+               "\n"
+               "The container can be used instead of the file pattern as "
+               "'--input' of the other tools.\n");
+
+    string input_pattern;
+    app.add_option("-i,--input", input_pattern,
+                   "Input pattern for the images, e.g. \"depth-{}.png\", or "
+                   "another sequence container")
+        ->required();
+    string output_file;
+    app.add_option("-o,--output", output_file,
+                   "Sequence container to create, e.g. \"depth.slseq\"")
+        ->required()
+        ->check([](const string& path) {
+            return io::is_sequence_path(path)
+                       ? string{}
+                       : string{"The container needs the extension .slseq"};
+        });
+    optional<string> calibration_file;
+    app.add_option("-c,--calibration", calibration_file,
+                   "File with the intrinsic calibration of the camera, that "
+                   "is stored in the container")
+        ->check(CLI::ExistingFile);
+
+    int start_idx = 0;
+    app.add_option("-s,--start", start_idx, "Start index of batch, inclusive")
+        ->required();
+    int end_idx = 0;
+    app.add_option("-e,--end", end_idx, "End index of batch, inclusive")
+        ->required();
+
+    const map<string, io::block_codec> codecs{{"lz4", io::block_codec::lz4},
+                                              {"none", io::block_codec::none}};
+    io::block_codec codec = io::block_codec::lz4;
+    app.add_option("--compression", codec,
+                   "Compression of the frames, uncompressed frames are read "
+                   "without any copy")
+        ->transform(CLI::CheckedTransformer(codecs));
+
+    pipeline_config pipeline;
+    add_pipeline_options(app, pipeline);
+
+    COLORED_APP_PARSE(app, argc, argv);
+
+    cv::setNumThreads(0);
+
+    if (start_idx > end_idx)
+        swap(start_idx, end_idx);
+
+    string intrinsic;
+    if (calibration_file) {
+        ifstream calibration{*calibration_file};
+        intrinsic.assign(istreambuf_iterator<char>(calibration),
+                         istreambuf_iterator<char>());
+    }
+
+    optional<io::sequence_writer> sequence = io::sequence_writer::create(
+        output_file, start_idx, end_idx, intrinsic, codec);
+    if (!sequence) {
+        cerr << util::err{} << "Could not create the container "
+             << rang::style::bold << output_file << rang::style::reset
+             << "!\n";
+        return 1;
+    }
+    if (codec == io::block_codec::lz4 && !io::lz4_available())
+        cerr << util::warn{}
+             << "Built without LZ4, the frames are stored uncompressed.\n";
+
+    // The writer stage appends the frames in any order, the container
+    // itself is not thread-safe.
+    mutex      append_mutex;
+    const bool packed = pipelined_file_processing(
+        start_idx, end_idx,
+        [&input_pattern](int idx) noexcept -> optional<cv::Mat> {
+            cv::Mat frame = read_input(input_pattern, idx);
+            if (frame.empty())
+                return nullopt;
+            return frame;
+        },
+        [&](int idx, const cv::Mat& frame, tf::Subflow& /*sf*/,
+            file_writer& writer) noexcept {
+            writer = [&, idx, frame] {
+                lock_guard guard{append_mutex};
+                return sequence->append(idx, frame);
+            };
+        },
+        pipeline);
+
+    if (!sequence->finish()) {
+        cerr << util::err{} << "Could not finish the container "
+             << rang::style::bold << output_file << rang::style::reset
+             << "!\n";
+        return 1;
+    }
+    return packed ? 0 : 1;
+}
+MAIN_TAIL
@@ -1,30 +1,23 @@
 #include "batch_converter.h"
 
-#include "parallel_processing.h"
+#include "input_source.h"
+#include "pipeline.h"
 
-#include <fmt/core.h>
 #include <gsl/gsl>
-#include <sens_loc/io/image.h>
 #include <sens_loc/math/image.h>
 
 namespace sens_loc::apps {
 
-bool batch_converter::process_index(int idx) const noexcept {
+std::optional<math::image<float>>
+batch_converter::load_index(int idx) const noexcept {
     Expects(!_files.input.empty());
-    const std::string input_file = fmt::format(_files.input, idx);
     std::optional<math::image<ushort>> depth_image =
-        io::load_image<ushort>(input_file, cv::IMREAD_UNCHANGED);
+        load_input<ushort>(_files.input, idx);
 
     if (!depth_image)
-        return false;
-
-    std::optional<math::image<float>> pp_image =
-        this->preprocess_depth(*depth_image);
-
-    if (!pp_image)
-        return false;
+        return std::nullopt;
 
-    return this->process_file(*pp_image, idx);
+    return this->preprocess_depth(*depth_image);
 }
 
 std::optional<math::image<float>>
@@ -33,10 +26,26 @@ batch_converter::preprocess_depth(const math::image<ushort>& depth_image) const
     return math::convert<float>(depth_image);
 }
 
-bool batch_converter::process_batch(int start, int end) const noexcept {
-    return parallel_indexed_file_processing(
+void batch_converter::schedule_file(const math::image<float>& depth_image,
+                                    int                       idx,
+                                    tf::Subflow& /*sf*/,
+                                    file_writer& writer) const noexcept {
+    const bool success = this->process_file(depth_image, idx);
+    writer             = [success] { return success; };
+}
+
+bool batch_converter::process_batch(int                    start,
+                                    int                    end,
+                                    const pipeline_config& config) const
+    noexcept {
+    return pipelined_file_processing(
         start, end,
-        [this](int idx) noexcept -> bool { return this->process_index(idx); });
+        [this](int idx) noexcept { return this->load_index(idx); },
+        [this](int idx, const math::image<float>& depth_image, tf::Subflow& sf,
+               file_writer& writer) noexcept {
+            this->schedule_file(depth_image, idx, sf, writer);
+        },
+        config, frame_footprint());
 }
 
 }  // namespace sens_loc::apps
@@ -1,14 +1,20 @@
 #ifndef BATCH_CONVERTER_H_XDIRBPHG
 #define BATCH_CONVERTER_H_XDIRBPHG
 
+#include "pipeline.h"
+
+#include <cstddef>
+#include <gsl/gsl>
 #include <optional>
 #include <sens_loc/camera_models/concepts.h>
 #include <sens_loc/conversion/depth_to_laserscan.h>
+#include <sens_loc/io/image.h>
 #include <sens_loc/math/image.h>
 #include <sens_loc/util/correctness_util.h>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <taskflow/taskflow.hpp>
 #include <type_traits>
 
 namespace sens_loc {
@@ -63,6 +69,8 @@ struct file_patterns {
     bool saveAs16Bit;          ///< Bit depth of output image, 1 = 16bit, 0 = 8bit
     std::string neighbors;     ///< Only relevant for flexion images, output for
                                ///< images with nxn neighborhood.
+
+    io::write_options encoding;  ///< Encoder settings for the output images.
 };
 
 /// Just local helper for batch conversion tasks over a given index range.
@@ -81,32 +89,54 @@ class batch_converter {
     batch_converter& operator=(batch_converter&&)      = default;
 
     /// Process the whole batch calling 'process_file' for each index.
-    /// \note This function does parallel batch processing.
+    /// \param config stages of the pipeline and the memory budget for all
+    /// files that are processed concurrently
+    /// \note This function does parallel batch processing. Loading,
+    /// conversion and writing of the files are pipelined.
     /// \note As a high level function it catches all exceptions and provides
     /// human readable error message to std-out.
     /// \returns 'false' if any of the indices fails.
-    [[nodiscard]] bool process_batch(int start, int end) const noexcept;
+    /// \sa frame_footprint
+    /// \sa pipelined_file_processing
+    [[nodiscard]] bool process_batch(int                    start,
+                                     int                    end,
+                                     const pipeline_config& config = {}) const
+        noexcept;
+
+    /// Estimate the memory in bytes that processing one file requires.
+    /// \returns \c 0 if the footprint is unknown, these files are not
+    /// restricted by a memory budget.
+    [[nodiscard]] virtual std::size_t frame_footprint() const noexcept {
+        return 0UL;
+    }
 
     virtual ~batch_converter() = default;
 
   protected:
+    /// \returns \c true if \p pattern stores floating point images. The
+    /// results are written without scaling to the integer range then.
+    [[nodiscard]] static bool
+    float_output(const std::string& pattern) noexcept {
+        return io::format_from_path(pattern) == io::image_format::pfm;
+    }
+
     file_patterns _files;  ///< File patterns that shall be processed.
 
   private:
-    /// Function that does the management-tasks for the conversion job, like
-    /// file-io and error handling.
+    /// Function that does the loading-tasks for the conversion job.
     ///
     /// The function opens the \c _files.input file after index substitution
     /// and reads it as an 16-bit, single channel grayscale image.
-    /// If it does not succeed, it returns \c false.
+    /// The image is then preprocessed for the conversion.
     ///
-    /// On success it calls \p process_file which implements the actual
-    /// conversion in each subclass.
+    /// The actual conversion of the loaded image is implemented by
+    /// \p schedule_file in each subclass.
     ///
-    /// \sa process_file
+    /// \sa preprocess_depth
     /// \pre \p _files.input is not empty
-    /// \returns \c true on success, otherwise \c false.
-    [[nodiscard]] bool process_index(int idx) const noexcept;
+    /// \returns \c std::nullopt if loading or preprocessing fails.
+    [[nodiscard]] std::optional<math::image<float>> load_index(int idx) const
+        noexcept;
 
     /// Function to potentially convert orthographic images into range images.
     /// \returns \c cv::Mat with proper input data for the conversion process.
@@ -119,6 +149,20 @@ class batch_converter {
     [[nodiscard]] virtual bool
     process_file(const math::image<float>& depth_image,
                  int                       idx) const noexcept = 0;
+
+    /// Method to process exactly one file with parallel work for that file.
+    /// The conversion is spawned as tasks into \p sf, which share the workers
+    /// with the processing of the other files. Storing the results is
+    /// deferred to \p writer, that is executed by the writer stage.
+    /// The default implementation calls the sequential \c process_file and
+    /// does not defer the writing.
+    /// \note \p depth_image is only valid during the call. Spawned tasks
+    /// must own the data they need.
+    /// \post \p writer is set by the last spawned task
+    virtual void schedule_file(const math::image<float>& depth_image,
+                               int                       idx,
+                               tf::Subflow&              sf,
+                               file_writer&              writer) const noexcept;
 };
 
 /// This class provides common data and depth-image conversion for all
@@ -139,7 +183,23 @@ class batch_sensor_converter : public batch_converter {
     batch_sensor_converter& operator=(batch_sensor_converter&&)      = default;
     ~batch_sensor_converter() override                               = default;
 
+    /// The footprint consists of the 16-bit input image, the range image
+    /// and the \c result_images() in floating-point and converted 16-bit.
+    [[nodiscard]] std::size_t frame_footprint() const noexcept override {
+        const auto pixels = gsl::narrow_cast<std::size_t>(intrinsic.w()) *
+                            gsl::narrow_cast<std::size_t>(intrinsic.h());
+        return pixels *
+               (sizeof(ushort) + sizeof(float) +
+                result_images() * (sizeof(float) + sizeof(ushort)));
+    }
+
   protected:
+    /// Number of result images of one file, that exist at the same time.
+    [[nodiscard]] virtual std::size_t result_images() const noexcept {
+        return 1UL;
+    }
+
+
     /// pinhole-camera-model parameters used in the whole conversion.
     Intrinsic intrinsic;
     /// Discriminate input type of the images.
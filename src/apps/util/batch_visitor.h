@@ -1,7 +1,11 @@
 #ifndef BATCH_VISITOR_H_WIWKQDOS
 #define BATCH_VISITOR_H_WIWKQDOS
 
+#include "executor.h"
+
+#include <algorithm>
 #include <chrono>
+#include <gsl/gsl>
 #include <iomanip>
 #include <sens_loc/util/progress_bar_observer.h>
 #include <system_error>
@@ -12,24 +16,48 @@ namespace sens_loc::apps {
 
 /// General purpose function to execute a specific visitor in parallel
 /// in order to determine some statistical insight.
+/// The visitation runs on the \c shared_executor.
 /// \tparam Functor Apply this functor for each index.
 /// \param start,end inclusive range of integers for the files to be accessed.
 /// \param f functor that is applied for each index
-template <typename Functor>
-Functor parallel_visitation(int start, int end, Functor&& f) noexcept {
+/// \param chunk number of consecutive indices that one task processes
+/// sequentially in ascending order
+/// \param chunk_done is called with the first index of each chunk after all
+/// indices of the chunk are processed
+/// \sa index_shards
+template <typename Functor, typename ChunkDone>
+Functor parallel_visitation(int         start,
+                            int         end,
+                            Functor&&   f,
+                            int         chunk,
+                            ChunkDone&& chunk_done) noexcept {
     static_assert(std::is_nothrow_invocable_r_v<void, Functor, int>,
                   "Functor needs to be noexcept callable with an 'int' and "
                   "return nothing!");
+    static_assert(std::is_nothrow_invocable_r_v<void, ChunkDone, int>,
+                  "ChunkDone needs to be noexcept callable with an 'int' and "
+                  "return nothing!");
 
     if (start > end)
         std::swap(start, end);
+    Expects(chunk > 0);
 
-    tf::Executor executor;
+    tf::Executor& executor = shared_executor();
 
-    int total_tasks = end - start + 1;
+    int total_tasks = (end - start + chunk) / chunk;
     executor.make_observer<util::progress_bar_observer>(total_tasks);
+    auto remove_observer =
+        gsl::finally([&executor] { executor.remove_observer(); });
     tf::Taskflow tf;
-    tf.parallel_for(start, end + 1, 1, std::forward<Functor>(f));
+    for (int first = start; first <= end; first += chunk) {
+        const int last = std::min(first + chunk - 1, end);
+        // Each task works on its own copy of the functor.
+        tf.emplace([f, &chunk_done, first, last]() mutable noexcept {
+            for (int idx = first; idx <= last; ++idx)
+                f(idx);
+            chunk_done(first);
+        });
+    }
     const auto before = std::chrono::steady_clock::now();
     executor.run(tf).wait();
     const auto after = std::chrono::steady_clock::now();
@@ -51,6 +79,15 @@ Functor parallel_visitation(int start, int end, Functor&& f) noexcept {
     return std::forward<Functor>(f);
 }
 
+/// Visitation without a notification for the completed chunks.
+/// \sa parallel_visitation
+template <typename Functor>
+Functor
+parallel_visitation(int start, int end, Functor&& f, int chunk = 1) noexcept {
+    return parallel_visitation(start, end, std::forward<Functor>(f), chunk,
+                               [](int /*first*/) noexcept {});
+}
+
 }  // namespace sens_loc::apps
 
 #endif /* end of include guard: BATCH_VISITOR_H_WIWKQDOS */
@@ -0,0 +1,107 @@
+#ifndef BOUNDED_QUEUE_H_J8DK2MVA
+#define BOUNDED_QUEUE_H_J8DK2MVA
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <gsl/gsl>
+#include <mutex>
+#include <optional>
+
+namespace sens_loc::apps {
+
+/// Blocking FIFO-queue with a fixed capacity to connect the stages of a
+/// pipeline. A full queue blocks the producer, an empty queue the consumer.
+/// After \c close the consumers drain the remaining elements.
+template <typename T>
+class bounded_queue {
+  public:
+    explicit bounded_queue(std::size_t capacity)
+        : _capacity{capacity} {
+        Expects(capacity > 0UL);
+    }
+
+    bounded_queue(const bounded_queue&) = delete;
+    bounded_queue(bounded_queue&&)      = delete;
+    bounded_queue& operator=(const bounded_queue&) = delete;
+    bounded_queue& operator=(bounded_queue&&) = delete;
+    ~bounded_queue()                          = default;
+
+    /// Append \p element, blocks while the queue is full.
+    /// \returns \c false if the queue is closed, \p element is dropped then.
+    bool push(T element) {
+        {
+            std::unique_lock lock{_mutex};
+            _not_full.wait(lock, [this] {
+                return _closed || _elements.size() < _capacity;
+            });
+            if (_closed)
+                return false;
+            _elements.emplace_back(std::move(element));
+        }
+        _not_empty.notify_one();
+        return true;
+    }
+
+    /// Append \p element even if the queue is full. Producers that must not
+    /// block, e.g. workers of an executor, use this and leave the bound to
+    /// \c wait_not_full of another thread.
+    /// \returns \c false if the queue is closed, \p element is dropped then.
+    bool push_unbounded(T element) {
+        {
+            std::lock_guard lock{_mutex};
+            if (_closed)
+                return false;
+            _elements.emplace_back(std::move(element));
+        }
+        _not_empty.notify_one();
+        return true;
+    }
+
+    /// Block until the queue has capacity for another element or is closed.
+    void wait_not_full() {
+        std::unique_lock lock{_mutex};
+        _not_full.wait(lock, [this] {
+            return _closed || _elements.size() < _capacity;
+        });
+    }
+
+    /// Remove the oldest element, blocks while the queue is empty.
+    /// \returns \c std::nullopt once the queue is closed and drained.
+    std::optional<T> pop() {
+        std::optional<T> element;
+        {
+            std::unique_lock lock{_mutex};
+            _not_empty.wait(lock,
+                            [this] { return _closed || !_elements.empty(); });
+            if (_elements.empty())
+                return std::nullopt;
+            element.emplace(std::move(_elements.front()));
+            _elements.pop_front();
+        }
+        _not_full.notify_one();
+        return element;
+    }
+
+    /// Wake up all waiting threads and reject further elements.
+    void close() noexcept {
+        {
+            std::lock_guard lock{_mutex};
+            _closed = true;
+        }
+        _not_full.notify_all();
+        _not_empty.notify_all();
+    }
+
+  private:
+    const std::size_t       _capacity;
+    bool                    _closed = false;
+    std::deque<T>           _elements;
+    std::mutex              _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+};
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: BOUNDED_QUEUE_H_J8DK2MVA */
@@ -0,0 +1,31 @@
+#include "executor.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sens_loc::apps {
+
+namespace {
+unsigned int                  requested_threads = 0;
+std::once_flag                executor_created;
+std::unique_ptr<tf::Executor> executor;
+}  // namespace
+
+void configure_shared_executor(unsigned int threads) noexcept {
+    requested_threads = threads;
+}
+
+tf::Executor& shared_executor() {
+    std::call_once(executor_created, [] {
+        const unsigned int workers =
+            requested_threads > 0U
+                ? requested_threads
+                : std::max(1U, std::thread::hardware_concurrency());
+        executor = std::make_unique<tf::Executor>(workers);
+    });
+    return *executor;
+}
+
+}  // namespace sens_loc::apps
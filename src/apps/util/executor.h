@@ -0,0 +1,26 @@
+#ifndef EXECUTOR_H_PZ7QNW2C
+#define EXECUTOR_H_PZ7QNW2C
+
+#include <taskflow/taskflow.hpp>
+
+namespace sens_loc::apps {
+
+/// Set the number of worker threads for the process-wide executor.
+/// This is the callback for the \c -j,--threads option of every tool.
+/// \param threads number of workers, \c 0 means one worker per hardware thread
+/// \pre called before the first call to \c shared_executor, otherwise the
+/// setting has no effect.
+void configure_shared_executor(unsigned int threads) noexcept;
+
+/// Access the single executor that schedules all parallel work of the tool.
+///
+/// Processing multiple files and the parallel conversion within one file
+/// (e.g. \c conversion::par_depth_to_flexion in a \c tf::Subflow) share the
+/// same workers. The scheduler balances both levels of parallelism and the
+/// machine is not oversubscribed.
+/// \note The executor is created on first use.
+tf::Executor& shared_executor();
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: EXECUTOR_H_PZ7QNW2C */
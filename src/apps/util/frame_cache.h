@@ -0,0 +1,131 @@
+#ifndef FRAME_CACHE_H_P5ZQ8MEX
+#define FRAME_CACHE_H_P5ZQ8MEX
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <gsl/gsl>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sens_loc/util/thread_analysis.h>
+#include <unordered_map>
+#include <utility>
+
+namespace sens_loc::apps {
+
+/// Thread-safe least-recently-used cache for data that is loaded per frame
+/// index, e.g. the features of the neighbouring frames in pairwise analyses.
+///
+/// A frame is loaded on the first request by the \c loader and shared with
+/// all later requests until it is evicted. Concurrent requests for a frame
+/// that is still loading wait for that load instead of loading it again.
+/// If the number of requests for each frame is known in advance, e.g. each
+/// frame is needed by itself and by its successor, a frame is evicted as soon
+/// as it was requested that often.
+/// \tparam Value data of one frame, returned as shared and immutable value
+template <typename Value>
+class frame_cache {
+  public:
+    using loader_type = std::function<Value(int)>;
+
+    /// \param loader loads the data of one frame, failures are signaled by
+    /// exceptions
+    /// \param capacity maximum number of cached frames
+    /// \param uses number of requests after which a frame is not required
+    /// anymore and evicted, \c 0 evicts frames only if the cache is full
+    frame_cache(loader_type loader,
+                std::size_t capacity,
+                std::size_t uses = 0UL)
+        : _loader{std::move(loader)}
+        , _capacity{capacity}
+        , _uses{uses} {
+        Expects(_capacity > 0UL);
+    }
+
+    /// \returns the data of frame \p idx, loading it if it is not cached
+    /// \throws the exception of the loader, failed loads are not cached
+    std::shared_ptr<const Value> get(int idx) {
+        std::promise<std::shared_ptr<const Value>> promise;
+        entry_type                                  entry;
+        bool                                        load = false;
+        {
+            std::lock_guard l{_mutex};
+            auto            it = _entries.find(idx);
+            if (it != _entries.end()) {
+                entry = it->second.value;
+                ++_hits;
+                if (++it->second.requests == _uses) {
+                    _order.erase(it->second.position);
+                    _entries.erase(it);
+                } else {
+                    _order.splice(_order.begin(), _order, it->second.position);
+                }
+            } else {
+                entry = promise.get_future().share();
+                load  = true;
+                ++_misses;
+                if (_uses != 1UL) {
+                    _order.push_front(idx);
+                    _entries.emplace(idx,
+                                     cache_entry{entry, _order.begin(), 1UL});
+                }
+                // Evicted frames stay valid for their current users.
+                while (_entries.size() > _capacity) {
+                    _entries.erase(_order.back());
+                    _order.pop_back();
+                }
+            }
+        }
+
+        if (load) {
+            try {
+                promise.set_value(std::make_shared<const Value>(_loader(idx)));
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+                std::lock_guard l{_mutex};
+                auto            it = _entries.find(idx);
+                if (it != _entries.end()) {
+                    _order.erase(it->second.position);
+                    _entries.erase(it);
+                }
+            }
+        }
+        return entry.get();
+    }
+
+    /// Number of requests that were served from the cache.
+    [[nodiscard]] std::size_t hits() const noexcept {
+        std::lock_guard l{_mutex};
+        return _hits;
+    }
+    /// Number of requests that required loading the frame.
+    [[nodiscard]] std::size_t misses() const noexcept {
+        std::lock_guard l{_mutex};
+        return _misses;
+    }
+
+  private:
+    using entry_type = std::shared_future<std::shared_ptr<const Value>>;
+    struct cache_entry {
+        entry_type               value;
+        std::list<int>::iterator position;
+        std::size_t              requests;
+    };
+
+    loader_type _loader;
+    std::size_t _capacity;
+    std::size_t _uses;
+
+    mutable std::mutex _mutex;
+    /// Frame indices, the most recently used first.
+    std::list<int> _order GUARDED_BY(_mutex);
+    std::unordered_map<int, cache_entry> _entries GUARDED_BY(_mutex);
+    std::size_t _hits GUARDED_BY(_mutex)   = 0UL;
+    std::size_t _misses GUARDED_BY(_mutex) = 0UL;
+};
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: FRAME_CACHE_H_P5ZQ8MEX */
@@ -0,0 +1,123 @@
+#ifndef INDEX_SHARDS_H_P6TDM4JC
+#define INDEX_SHARDS_H_P6TDM4JC
+
+#include <functional>
+#include <gsl/gsl>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace sens_loc::apps {
+
+/// Number of consecutive indices that share one shard and one task of
+/// \c parallel_visitation.
+constexpr int default_shard_chunk = 8;
+
+/// One instance of \c T for each chunk of consecutive frame indices that is
+/// currently processed.
+///
+/// Analyses that accumulate results of many frames in parallel insert into
+/// the shard of the frame index. The visitation must process the indices of
+/// one chunk sequentially and in ascending order and signal the end of each
+/// chunk with \c complete, which \c parallel_visitation does with the same
+/// \c chunk. A shard is then only written by one task at a time.
+/// Completed shards are merged into the result in the order of the indices as
+/// soon as all earlier chunks are completed. Therefore even results that
+/// depend on the order of insertion, like sketched quantiles, are the same
+/// for every run, while only the running and the out-of-order chunks are kept
+/// in memory.
+/// \sa parallel_visitation
+template <typename T>
+class index_shards {
+  public:
+    /// Merge the second argument into the first one.
+    using merge_function = std::function<void(T&, T&)>;
+
+    /// \param first,last inclusive range of the indices, \p first must be the
+    /// first index of the visitation to align the chunks with its tasks
+    /// \param prototype every shard and the result start as a copy of it
+    /// \param merge combines a completed shard into the result
+    /// \param chunk number of consecutive indices per shard
+    index_shards(int            first,
+                 int            last,
+                 T              prototype,
+                 merge_function merge,
+                 int            chunk = default_shard_chunk)
+        : _first{first}
+        , _last{last}
+        , _chunk{chunk}
+        , _prototype{std::move(prototype)}
+        , _merge{std::move(merge)}
+        , _result{_prototype} {
+        Expects(first <= last);
+        Expects(chunk > 0);
+        Expects(_merge);
+    }
+
+    /// \returns the shard that contains \p idx
+    /// \pre \p idx is within the range of the shards and its chunk is not
+    /// completed
+    T& local(int idx) noexcept {
+        Expects(idx >= _first && idx <= _last);
+        std::lock_guard guard{_pending_mutex};
+        Expects(chunk_of(idx) >= _next_chunk);
+        // 'std::map' does not move its elements, the reference stays valid
+        // while other chunks are inserted or merged.
+        return _pending.try_emplace(chunk_of(idx), _prototype)
+            .first->second.value;
+    }
+
+    /// Signal that all indices of the chunk containing \p idx are processed.
+    /// The chunk and all directly following completed chunks are merged into
+    /// the result.
+    void complete(int idx) noexcept {
+        Expects(idx >= _first && idx <= _last);
+        std::lock_guard guard{_pending_mutex};
+        _pending.try_emplace(chunk_of(idx), _prototype)
+            .first->second.completed = true;
+
+        while (!_pending.empty()) {
+            auto next = _pending.begin();
+            if (next->first != _next_chunk || !next->second.completed)
+                break;
+            _merge(_result, next->second.value);
+            _pending.erase(next);
+            ++_next_chunk;
+        }
+    }
+
+    /// \returns the merged result of all chunks
+    /// \pre all chunks are completed and there are no concurrent accesses
+    T& result() noexcept {
+        Expects(_next_chunk == chunk_of(_last) + 1);
+        return _result;
+    }
+
+  private:
+    [[nodiscard]] int chunk_of(int idx) const noexcept {
+        return (idx - _first) / _chunk;
+    }
+
+    struct shard {
+        explicit shard(const T& prototype)
+            : value{prototype} {}
+
+        T    value;
+        bool completed = false;
+    };
+
+    int            _first;
+    int            _last;
+    int            _chunk;
+    T              _prototype;
+    merge_function _merge;
+
+    std::mutex           _pending_mutex;
+    int                  _next_chunk = 0;
+    std::map<int, shard> _pending;
+    T                    _result;
+};
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: INDEX_SHARDS_H_P6TDM4JC */
@@ -0,0 +1,75 @@
+#include "input_source.h"
+
+#include <fmt/core.h>
+#include <map>
+#include <mutex>
+#include <sens_loc/io/image.h>
+
+namespace sens_loc::apps {
+
+namespace {
+/// Open the container \p path of type \c Container once per process.
+template <typename Container>
+std::shared_ptr<const Container> shared_open(const std::string& path) noexcept {
+    static std::mutex m;
+    static std::map<std::string, std::shared_ptr<const Container>> opened;
+
+    try {
+        std::lock_guard guard{m};
+        auto            it = opened.find(path);
+        if (it != opened.end())
+            return it->second;
+
+        std::shared_ptr<const Container> container;
+        if (std::optional<Container> c = Container::open(path))
+            container = std::make_shared<const Container>(std::move(*c));
+        // Failures are remembered as well, the file is not retried.
+        opened.emplace(path, container);
+        return container;
+    } catch (...) { return nullptr; }
+}
+}  // namespace
+
+std::shared_ptr<const io::depth_sequence>
+shared_sequence(const std::string& path) noexcept {
+    return shared_open<io::depth_sequence>(path);
+}
+
+std::shared_ptr<const io::feature_store>
+shared_feature_store(const std::string& path) noexcept {
+    return shared_open<io::feature_store>(path);
+}
+
+cv::Mat read_input(const std::string& input, int idx, int flags) noexcept {
+    try {
+        if (io::is_sequence_path(input)) {
+            std::shared_ptr<const io::depth_sequence> sequence =
+                shared_sequence(input);
+            return sequence ? sequence->frame(idx) : cv::Mat{};
+        }
+        return io::read_image(fmt::format(input, idx), flags);
+    } catch (...) { return {}; }
+}
+
+io::feature_file open_features(const std::string& input, int idx) {
+    if (io::is_feature_store_path(input)) {
+        std::shared_ptr<const io::feature_store> store =
+            shared_feature_store(input);
+        return store ? store->frame(idx) : io::feature_file{};
+    }
+    return io::open_feature_file(fmt::format(input, idx));
+}
+
+std::optional<math::image<uchar>>
+load_input_as_8bit_gray(const std::string& input, int idx) noexcept {
+    std::optional<math::image<ushort>> depth_image =
+        load_input<ushort>(input, idx);
+
+    if (!depth_image)
+        return {};
+
+    return math::convert<uchar>(
+        math::image<ushort>(depth_image->data() / 255.));  // NOLINT
+}
+
+}  // namespace sens_loc::apps
@@ -0,0 +1,74 @@
+#ifndef INPUT_SOURCE_H_C3YH9PLF
+#define INPUT_SOURCE_H_C3YH9PLF
+
+#include <memory>
+#include <opencv2/imgcodecs.hpp>
+#include <optional>
+#include <sens_loc/io/feature.h>
+#include <sens_loc/io/feature_store.h>
+#include <sens_loc/io/sequence.h>
+#include <sens_loc/math/image.h>
+#include <string>
+#include <type_traits>
+
+namespace sens_loc::apps {
+
+/// Open the sequence container \p path once for the whole process.
+/// All threads share the same mapping, so the frames of a sequence stay
+/// valid until the program ends.
+/// \returns the container or \c nullptr if it can not be opened
+std::shared_ptr<const io::depth_sequence>
+shared_sequence(const std::string& path) noexcept;
+
+/// Read image \p idx of the input \p input.
+///
+/// The input is either a file pattern like \c "depth-{:04d}.png", which is
+/// substituted with \p idx, or a sequence container like \c "depth.slseq".
+/// Frames of an uncompressed sequence are read-only views without a copy.
+/// \returns the image or an empty \c cv::Mat on failure
+/// \sa io::read_image, io::depth_sequence
+cv::Mat read_input(const std::string& input,
+                   int                idx,
+                   int                flags = cv::IMREAD_UNCHANGED) noexcept;
+
+/// Typed version of \c read_input, in the spirit of \c io::load_image.
+/// \returns \c std::nullopt if loading failed or the pixel type does not
+/// match
+template <typename PixelType>
+std::optional<math::image<PixelType>>
+load_input(const std::string& input,
+           int                idx,
+           int                flags = cv::IMREAD_UNCHANGED) noexcept {
+    static_assert(std::is_arithmetic_v<PixelType>);
+
+    cv::Mat result = read_input(input, idx, flags);
+    if (result.empty())
+        return std::nullopt;
+    if (result.type() != math::detail::get_opencv_type<PixelType>())
+        return std::nullopt;
+    return {math::image<PixelType>(std::move(result))};
+}
+
+/// Load a 16bit grayscale image \p idx of \p input as 8bit grayscale image.
+/// \sa io::load_as_8bit_gray
+std::optional<math::image<uchar>>
+load_input_as_8bit_gray(const std::string& input, int idx) noexcept;
+
+/// Open the feature store \p path once for the whole process, in the spirit
+/// of \c shared_sequence.
+/// \returns the store or \c nullptr if it can not be opened
+std::shared_ptr<const io::feature_store>
+shared_feature_store(const std::string& path) noexcept;
+
+/// Open the features of frame \p idx of the input \p input.
+///
+/// The input is either a file pattern like \c "sift-{:04d}.feat", which is
+/// substituted with \p idx, or a feature store like \c "sift.slfseq".
+/// Frames of a feature store are accessed without any system call.
+/// \returns the features, that are not open if loading failed
+/// \sa io::feature_file, io::feature_store
+io::feature_file open_features(const std::string& input, int idx);
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: INPUT_SOURCE_H_C3YH9PLF */
@@ -0,0 +1,41 @@
+#include "memory_budget.h"
+
+#include <algorithm>
+#include <gsl/gsl>
+
+namespace sens_loc::apps {
+
+void memory_budget::acquire(std::size_t bytes) {
+    std::unique_lock lock{_mutex};
+    if (limited())
+        _released.wait(lock, [this, bytes] {
+            return _closed || _in_flight == 0 ||
+                   _in_flight + bytes <= _budget;
+        });
+    _in_flight += bytes;
+    _peak = std::max(_peak, _in_flight);
+}
+
+void memory_budget::release(std::size_t bytes) noexcept {
+    {
+        std::lock_guard lock{_mutex};
+        Expects(bytes <= _in_flight);
+        _in_flight -= bytes;
+    }
+    _released.notify_all();
+}
+
+void memory_budget::close() noexcept {
+    {
+        std::lock_guard lock{_mutex};
+        _closed = true;
+    }
+    _released.notify_all();
+}
+
+std::size_t memory_budget::peak() const noexcept {
+    std::lock_guard lock{_mutex};
+    return _peak;
+}
+
+}  // namespace sens_loc::apps
@@ -0,0 +1,56 @@
+#ifndef MEMORY_BUDGET_H_W3NQ8FXT
+#define MEMORY_BUDGET_H_W3NQ8FXT
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace sens_loc::apps {
+
+/// Admission control for the memory of concurrently processed files.
+///
+/// Each file reserves its estimated footprint before it is started and
+/// returns it when it is finished. New files are only admitted while the
+/// total of the reservations stays within the budget.
+/// \note \c acquire blocks and must not be called from a worker of the
+/// executor that calls \c release, otherwise the batch can deadlock.
+class memory_budget {
+  public:
+    /// \param budget maximum number of bytes in flight, \c 0 means unlimited
+    explicit memory_budget(std::size_t budget) noexcept
+        : _budget{budget} {}
+
+    memory_budget(const memory_budget&) = delete;
+    memory_budget(memory_budget&&)      = delete;
+    memory_budget& operator=(const memory_budget&) = delete;
+    memory_budget& operator=(memory_budget&&) = delete;
+    ~memory_budget()                          = default;
+
+    /// Block until \p bytes fit into the budget and reserve them.
+    /// \note A single reservation that is bigger than the whole budget is
+    /// admitted once nothing else is in flight.
+    void acquire(std::size_t bytes);
+    /// Return the reservation of \p bytes to the budget.
+    /// \pre \p bytes were acquired before
+    void release(std::size_t bytes) noexcept;
+    /// Admit all current and future reservations without waiting, e.g. to
+    /// shut down a batch that failed.
+    void close() noexcept;
+
+    [[nodiscard]] std::size_t budget() const noexcept { return _budget; }
+    [[nodiscard]] bool        limited() const noexcept { return _budget > 0; }
+    /// \returns the highest number of bytes that were in flight at once.
+    [[nodiscard]] std::size_t peak() const noexcept;
+
+  private:
+    const std::size_t       _budget;
+    std::size_t             _in_flight = 0;
+    std::size_t             _peak      = 0;
+    bool                    _closed    = false;
+    mutable std::mutex      _mutex;
+    std::condition_variable _released;
+};
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: MEMORY_BUDGET_H_W3NQ8FXT */
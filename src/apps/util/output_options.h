@@ -0,0 +1,57 @@
+#ifndef OUTPUT_OPTIONS_H_Q7KD2XNA
+#define OUTPUT_OPTIONS_H_Q7KD2XNA
+
+#include <CLI/CLI.hpp>
+#include <map>
+#include <opencv2/imgcodecs.hpp>
+#include <sens_loc/io/image.h>
+#include <string>
+
+namespace sens_loc::apps {
+
+/// Register the command line options for the encoders of the output images
+/// in \p app.
+/// The format itself is determined by the extension of the output pattern.
+/// \sa io::write_image
+inline void add_output_options(CLI::App& app, io::write_options& options) {
+    app.add_option("--png-compression", options.png_compression,
+                   "zlib compression level of PNG output, from 0 (fastest) to "
+                   "9 (smallest). Without '--png-*' OpenCVs fastest settings "
+                   "are used",
+                   true)
+        ->check(CLI::Range(0, 9));
+
+    const std::map<std::string, int> strategies{
+        {"default", cv::IMWRITE_PNG_STRATEGY_DEFAULT},
+        {"filtered", cv::IMWRITE_PNG_STRATEGY_FILTERED},
+        {"huffman", cv::IMWRITE_PNG_STRATEGY_HUFFMAN_ONLY},
+        {"rle", cv::IMWRITE_PNG_STRATEGY_RLE},
+        {"fixed", cv::IMWRITE_PNG_STRATEGY_FIXED}};
+    app.add_option("--png-strategy", options.png_strategy,
+                   "zlib strategy of PNG output", true)
+        ->transform(CLI::CheckedTransformer(strategies));
+
+    app.add_option("--tile-rows", options.tile_rows,
+                   "Number of image rows per tile of '.slt' output", true)
+        ->check(CLI::PositiveNumber);
+
+    const std::map<std::string, io::block_codec> codecs{
+        {"lz4", io::block_codec::lz4}, {"none", io::block_codec::none}};
+    app.add_option("--tile-compression", options.tile_compression,
+                   "Compression of the tiles of '.slt' output", true)
+        ->transform(CLI::CheckedTransformer(codecs));
+
+    app.footer(app.get_footer() +
+               "\n\nThe format of the output images is chosen by the extension "
+               "of the output pattern:\n"
+               "  .png          compressed 8/16 bit, see '--png-*'\n"
+               "  .pgm/.ppm     uncompressed 8/16 bit\n"
+               "  .pfm          uncompressed 32 bit float\n"
+               "  .slt          raw tiles of any type, see '--tile-*'\n"
+               "The other tools read these formats as input, if the pixel "
+               "type fits.\n");
+}
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: OUTPUT_OPTIONS_H_Q7KD2XNA */
@@ -1,11 +1,14 @@
 #ifndef PARALLEL_PROCESSING_H_2FVRLMCH
 #define PARALLEL_PROCESSING_H_2FVRLMCH
 
+#include "executor.h"
+
 #include <chrono>
 #include <gsl/gsl>
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <memory>
 #include <sens_loc/util/console.h>
 #include <sens_loc/util/progress_bar_observer.h>
 #include <taskflow/taskflow.hpp>
@@ -14,18 +17,31 @@
 namespace sens_loc::apps {
 
 /// Helper function that processes a range of files based on index.
-/// The boolean function \c f is applied to each function. Error handling
-/// and reporting is done if \c f returns \c false.
+/// The function \c f is applied to each index. Error handling
+/// and reporting is done if \c f signals a failure.
+///
+/// \c f has one of two forms:
+/// - \c bool(int idx) processes the file sequentially and returns \c false
+///   on failure.
+/// - \c void(int idx, tf::Subflow& sf, bool& success) may spawn parallel work
+///   for the file into \c sf. \c success must be set by the work as soon as
+///   it is known, latest by the last task that is spawned into \c sf.
+///
+/// All work runs on the \c shared_executor, therefore parallelism within one
+/// file and over multiple files are balanced by the same scheduler.
 ///
-/// \tparam BoolFunction Apply this functor for each index.
+/// \tparam Function Apply this functor for each index.
 /// \param start,end inclusive range of integers for the files
 /// \param f functor that is applied for each index
-template <typename BoolFunction>
-bool parallel_indexed_file_processing(int          start,
-                                      int          end,
-                                      BoolFunction f) noexcept {
-    static_assert(std::is_nothrow_invocable_r_v<bool, BoolFunction, int>,
-                  "Functor needs to be noexcept callable and return bool!");
+template <typename Function>
+bool parallel_indexed_file_processing(int start, int end, Function f) noexcept {
+    constexpr bool is_nested =
+        std::is_nothrow_invocable_r_v<void, Function, int, tf::Subflow&,
+                                      bool&>;
+    static_assert(is_nested ||
+                      std::is_nothrow_invocable_r_v<bool, Function, int>,
+                  "Functor needs to be noexcept callable and return bool or "
+                  "spawn into a subflow!");
 
     try {
         if (start > end)
@@ -33,26 +49,45 @@ bool parallel_indexed_file_processing(int          start,
 
         int total_tasks = end - start + 1;
 
-        tf::Executor executor;
-        executor.make_observer<util::progress_bar_observer>(total_tasks);
+        // Only the reporting tasks are counted for the progress, as the
+        // nested tasks of each file are visible to the observer, too.
+        constexpr const char* file_task = "file";
+        tf::Executor&         executor  = shared_executor();
+        executor.make_observer<util::progress_bar_observer>(total_tasks,
+                                                            file_task);
+        auto remove_observer =
+            gsl::finally([&executor] { executor.remove_observer(); });
         tf::Taskflow tf;
 
         bool batch_success = true;
         int  fails         = 0;
+        // Outcome of each file, written by exactly one task each.
+        auto file_success = std::make_unique<bool[]>(total_tasks);
 
-        tf.parallel_for(
-            start, end + 1, 1, [&batch_success, &fails, &f](int idx) {
-                const bool success = f(idx);
-                if (!success) {
-                    auto s = synced();
-                    fails++;
-                    std::cerr << util::err{};
-                    std::cerr << "Could not process index \""
-                              << rang::style::bold << idx << "\""
-                              << rang::style::reset << "!" << std::endl;
-                    batch_success = false;
-                }
-            });
+        for (int idx = start; idx <= end; ++idx) {
+            bool& success = file_success[idx - start];
+
+            tf::Task work = tf.emplace(
+                [&f, idx, &success]([[maybe_unused]] tf::Subflow& sf) {
+                    if constexpr (is_nested)
+                        f(idx, sf, success);
+                    else
+                        success = f(idx);
+                });
+            tf::Task report =
+                tf.emplace([&batch_success, &fails, &success, idx]() {
+                      if (!success) {
+                          auto s = synced();
+                          fails++;
+                          std::cerr << util::err{};
+                          std::cerr << "Could not process index \""
+                                    << rang::style::bold << idx << "\""
+                                    << rang::style::reset << "!" << std::endl;
+                          batch_success = false;
+                      }
+                  }).name(file_task);
+            work.precede(report);
+        }
 
         const auto before = std::chrono::steady_clock::now();
         executor.run(tf).wait();
@@ -0,0 +1,332 @@
+#ifndef PIPELINE_H_5RTC9WQE
+#define PIPELINE_H_5RTC9WQE
+
+#include "bounded_queue.h"
+#include "executor.h"
+#include "memory_budget.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <gsl/gsl>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sens_loc/util/console.h>
+#include <sens_loc/util/progress_bar_observer.h>
+#include <taskflow/taskflow.hpp>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace sens_loc::apps {
+
+/// Deferred output of one file. The compute stage creates it and the writer
+/// stage executes it.
+/// \returns \c true if the results were written successfully.
+using file_writer = std::function<bool()>;
+
+/// Configuration of the stages for \c pipelined_file_processing.
+struct pipeline_config {
+    unsigned int readers       = 2U;   ///< Threads that load files.
+    unsigned int writers       = 2U;   ///< Threads that write results.
+    std::size_t  read_ahead    = 8UL;  ///< Loaded files waiting for compute.
+    std::size_t  write_queue   = 8UL;  ///< Computed files waiting for writers.
+    std::size_t  memory_budget = 0UL;  ///< Upper bound for the bytes of all
+                                       ///< files in flight, 0 is unlimited.
+};
+
+/// Progress bar that additionally accumulates the time each worker spends
+/// executing tasks, to determine the utilisation of the compute stage.
+class utilisation_observer : public util::progress_bar_observer {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    using util::progress_bar_observer::progress_bar_observer;
+
+    void set_up(unsigned num_workers) override {
+        _entry.resize(num_workers);
+        _busy.resize(num_workers, clock::duration::zero());
+    }
+    void on_entry(unsigned worker_id, tf::TaskView task_view) override {
+        _entry[worker_id] = clock::now();
+        util::progress_bar_observer::on_entry(worker_id, task_view);
+    }
+    void on_exit(unsigned worker_id, tf::TaskView task_view) override {
+        util::progress_bar_observer::on_exit(worker_id, task_view);
+        _busy[worker_id] += clock::now() - _entry[worker_id];
+    }
+
+    /// \returns sum of the busy time of all workers.
+    [[nodiscard]] clock::duration busy() const noexcept {
+        clock::duration total = clock::duration::zero();
+        for (const clock::duration d : _busy)
+            total += d;
+        return total;
+    }
+
+  private:
+    // Each worker only accesses its own element.
+    std::vector<clock::time_point> _entry;
+    std::vector<clock::duration>   _busy;
+};
+
+/// Process a range of files in a pipeline of three stages.
+///
+/// - Reader threads load the files ahead of the computation.
+/// - The computation runs on the \c shared_executor and may spawn parallel
+///   work for each file into a \c tf::Subflow.
+/// - Writer threads execute the \c file_writer the computation produced,
+///   e.g. encoding and storing the resulting images.
+///
+/// The stages are connected by bounded queues, therefore decoding, computing
+/// and encoding of different files overlap. The utilisation of each stage is
+/// reported at the end to identify the bottleneck.
+///
+/// \tparam Reader \c std::optional<Frame>(int idx), \c std::nullopt on failure
+/// \tparam Compute \c void(int idx, const Frame&, tf::Subflow&, file_writer&),
+/// the \c file_writer must be set latest by the last task spawned into the
+/// subflow. The frame is only valid during the call.
+/// \param start,end inclusive range of integers for the files
+/// \param footprint estimated peak memory in bytes for one file, \c 0 if
+/// unknown
+/// \sa memory_budget
+template <typename Reader, typename Compute>
+bool pipelined_file_processing(int                    start,
+                               int                    end,
+                               Reader                 read,
+                               Compute                compute,
+                               const pipeline_config& config,
+                               std::size_t            footprint = 0UL) noexcept {
+    using frame_t = typename std::invoke_result_t<Reader, int>::value_type;
+    static_assert(
+        std::is_nothrow_invocable_r_v<std::optional<frame_t>, Reader, int>,
+        "Reader needs to be noexcept callable and return an optional frame!");
+    static_assert(std::is_nothrow_invocable_r_v<void, Compute, int,
+                                                const frame_t&, tf::Subflow&,
+                                                file_writer&>,
+                  "Compute needs to be noexcept callable and spawn into a "
+                  "subflow!");
+    using clock = std::chrono::steady_clock;
+
+    try {
+        if (start > end)
+            std::swap(start, end);
+
+        Expects(config.readers > 0U);
+        Expects(config.writers > 0U);
+        const int total_tasks = end - start + 1;
+
+        // Progress is counted when a file is handed to the writers.
+        constexpr const char* file_task = "file";
+        tf::Executor&         executor  = shared_executor();
+        auto*                 compute_stage =
+            executor.make_observer<utilisation_observer>(total_tasks, file_task);
+        auto remove_observer =
+            gsl::finally([&executor] { executor.remove_observer(); });
+
+        memory_budget in_flight{config.memory_budget};
+        if (in_flight.limited() && footprint > config.memory_budget) {
+            auto s = synced();
+            std::cerr << util::warn{}
+                      << "The memory budget is smaller than the estimated "
+                         "memory for one file!\n"
+                      << "The files will be processed one by one.\n";
+        }
+
+        struct loaded_file {
+            int                    idx;
+            std::optional<frame_t> frame;
+        };
+        bounded_queue<loaded_file> loaded{config.read_ahead};
+        bounded_queue<int>         computed{config.write_queue};
+        // Written by the compute stage, consumed by the writer of the file.
+        auto writers = std::make_unique<file_writer[]>(total_tasks);
+
+        std::vector<clock::duration> read_busy(config.readers);
+        std::vector<clock::duration> write_busy(config.writers);
+        std::atomic<int>             next_idx{start};
+        bool                         batch_success = true;
+        int                          fails         = 0;
+
+        std::vector<std::thread>                   reader_threads;
+        std::vector<std::thread>                   writer_threads;
+        std::vector<std::unique_ptr<tf::Taskflow>> flows;
+        std::vector<std::future<void>>             runs;
+        flows.reserve(total_tasks);
+        runs.reserve(total_tasks);
+
+        // Stops all stages before they are destroyed, even if an exception
+        // escapes. Running threads would terminate the program otherwise.
+        auto shut_down = gsl::finally([&]() noexcept {
+            next_idx = end + 1;
+            in_flight.close();
+            loaded.close();
+            for (std::future<void>& run : runs)
+                if (run.valid())
+                    run.wait();
+            computed.close();
+            for (std::thread& t : reader_threads)
+                if (t.joinable())
+                    t.join();
+            for (std::thread& t : writer_threads)
+                if (t.joinable())
+                    t.join();
+        });
+
+        const auto before = clock::now();
+
+        for (unsigned int i = 0; i < config.readers; ++i) {
+            reader_threads.emplace_back([&, i]() {
+                for (int idx = next_idx++; idx <= end; idx = next_idx++) {
+                    in_flight.acquire(footprint);
+                    const auto t0 = clock::now();
+                    loaded_file f{idx, read(idx)};
+                    read_busy[i] += clock::now() - t0;
+                    if (!loaded.push(std::move(f)))
+                        in_flight.release(footprint);
+                }
+            });
+        }
+
+        for (unsigned int i = 0; i < config.writers; ++i) {
+            writer_threads.emplace_back([&, i]() {
+                while (std::optional<int> idx = computed.pop()) {
+                    const auto  t0      = clock::now();
+                    file_writer writer  = std::move(writers[*idx - start]);
+                    const bool  success = writer && writer();
+                    // Release the data of the file before its budget.
+                    writer = nullptr;
+                    write_busy[i] += clock::now() - t0;
+                    in_flight.release(footprint);
+
+                    if (!success) {
+                        auto s = synced();
+                        fails++;
+                        std::cerr << util::err{};
+                        std::cerr << "Could not process index \""
+                                  << rang::style::bold << *idx << "\""
+                                  << rang::style::reset << "!" << std::endl;
+                        batch_success = false;
+                    }
+                }
+            });
+        }
+
+        // This thread dispatches the loaded files to the executor. Every file
+        // has its own graph. The workers hand the computed files over without
+        // blocking, instead this thread waits while the writers are behind.
+        for (int i = 0; i < total_tasks; ++i) {
+            computed.wait_not_full();
+            std::optional<loaded_file> f = loaded.pop();
+            Ensures(f);
+            const int idx = f->idx;
+
+            tf::Taskflow& flow =
+                *flows.emplace_back(std::make_unique<tf::Taskflow>());
+            tf::Task hand_over = flow.emplace([&computed, idx]() {
+                                         computed.push_unbounded(idx);
+                                     })
+                                     .name(file_task);
+
+            // Without a frame the loading failed. The writer reports the
+            // missing 'file_writer' as failure.
+            if (f->frame) {
+                file_writer& writer = writers[idx - start];
+                tf::Task     work   = flow.emplace(
+                    [&compute, idx, &writer,
+                     frame = std::move(*f->frame)](tf::Subflow& sf) mutable {
+                        // The frame is released after spawning, not with the
+                        // graph.
+                        const frame_t local = std::move(frame);
+                        compute(idx, local, sf, writer);
+                    });
+                work.precede(hand_over);
+            }
+
+            runs.emplace_back(executor.run(flow));
+        }
+
+        for (std::thread& t : reader_threads)
+            t.join();
+        for (std::future<void>& run : runs)
+            run.wait();
+        computed.close();
+        for (std::thread& t : writer_threads)
+            t.join();
+
+        const auto wall = clock::now() - before;
+        std::cout << std::endl;
+
+        Ensures(fails >= 0);
+
+        const auto sum = [](const std::vector<clock::duration>& busy) {
+            clock::duration total = clock::duration::zero();
+            for (const clock::duration d : busy)
+                total += d;
+            return total;
+        };
+        const auto print_utilisation = [wall](const char*     stage,
+                                              clock::duration busy,
+                                              std::size_t     threads) {
+            using seconds = std::chrono::duration<double>;
+            const double capacity = seconds(wall).count() * double(threads);
+            const double percent =
+                capacity > 0. ? 100. * seconds(busy).count() / capacity : 0.;
+            std::cerr << "    " << std::setw(8) << std::left << stage
+                      << std::right << rang::style::bold << std::setw(6)
+                      << std::setprecision(1) << percent << "%"
+                      << rang::style::reset << " of " << threads
+                      << " threads\n";
+        };
+        {
+            auto s = synced();
+            std::cerr << util::info{};
+            std::cerr << "Processing " << rang::style::bold
+                      << total_tasks - fails << rang::style::reset
+                      << " images took " << rang::style::bold << std::fixed
+                      << std::setprecision(2)
+                      << std::chrono::duration<double>(wall).count()
+                      << rang::style::reset << " seconds!\n";
+            std::cerr << util::info{} << "Utilisation of the stages:\n";
+            print_utilisation("read", sum(read_busy), config.readers);
+            print_utilisation("compute", compute_stage->busy(),
+                              executor.num_workers());
+            print_utilisation("write", sum(write_busy), config.writers);
+            std::cerr << "\n";
+
+            if (footprint > 0UL) {
+                constexpr double mib = 1024. * 1024.;
+                std::cerr << util::info{}
+                          << "Peak memory of the files in flight: "
+                          << rang::style::bold << std::setprecision(1)
+                          << (in_flight.peak() / mib) << " MiB"
+                          << rang::style::reset;
+                if (in_flight.limited())
+                    std::cerr << " (budget " << (in_flight.budget() / mib)
+                              << " MiB)";
+                std::cerr << "\n\n";
+            }
+        }
+
+        if (fails > 0) {
+            auto s = synced();
+            std::cerr << util::warn{} << "Encountered " << rang::style::bold
+                      << fails << rang::style::reset << " problematic files!\n";
+        }
+
+        return batch_success;
+    } catch (...) {
+        auto s = synced();
+        std::cerr << util::err{} << "System error in batch processing!\n";
+        return false;
+    }
+}
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: PIPELINE_H_5RTC9WQE */
@@ -0,0 +1,35 @@
+#ifndef PIPELINE_OPTIONS_H_G2MX7HBL
+#define PIPELINE_OPTIONS_H_G2MX7HBL
+
+#include "pipeline.h"
+
+#include <CLI/CLI.hpp>
+
+namespace sens_loc::apps {
+
+/// Register the command line options to configure the stages of the batch
+/// pipeline in \p app.
+/// \sa pipeline_config
+inline void add_pipeline_options(CLI::App& app, pipeline_config& config) {
+    app.add_option("--readers", config.readers,
+                   "Number of threads that load input files", true)
+        ->check(CLI::PositiveNumber);
+    app.add_option("--writers", config.writers,
+                   "Number of threads that write the results", true)
+        ->check(CLI::PositiveNumber);
+    app.add_option("--read-ahead", config.read_ahead,
+                   "Number of loaded files that wait for the conversion", true)
+        ->check(CLI::PositiveNumber);
+    app.add_option("--write-queue", config.write_queue,
+                   "Number of converted files that wait for writing", true)
+        ->check(CLI::PositiveNumber);
+    app.add_option("--memory-budget", config.memory_budget,
+                   "Upper bound for the memory of the images that are "
+                   "processed concurrently, e.g. \"4GB\". 0 means unlimited",
+                   true)
+        ->transform(CLI::AsSizeValue(/*kb_is_1000=*/false));
+}
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: PIPELINE_OPTIONS_H_G2MX7HBL */
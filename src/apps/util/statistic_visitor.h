@@ -8,8 +8,10 @@
 #include <sens_loc/io/feature.h>
 #include <sens_loc/util/console.h>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <util/input_source.h>
 #include <utility>
 
 namespace sens_loc::apps {
@@ -55,8 +57,8 @@ struct statistic_visitor : Analysor {
 
     void operator()(int i) noexcept {
         try {
-            const cv::FileStorage fs =
-                io::open_feature_file(fmt::format(input_pattern, i));
+            const io::feature_file fs =
+                open_features(std::string(input_pattern), i);
 
             std::optional<std::vector<cv::KeyPoint>> keypoints   = std::nullopt;
             std::optional<cv::Mat>                   descriptors = std::nullopt;
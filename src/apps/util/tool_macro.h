@@ -8,6 +8,8 @@
  * error messages on system failure.
  */
 
+#include "executor.h"
+
 #define MAIN_HEAD(TOOL_DESCRIPTION)                                            \
     int main(int argc, char** argv) try {                                      \
         using namespace sens_loc;                                              \
@@ -18,6 +20,9 @@
             gsl::finally([] { cout << rang::style::reset << flush; });         \
         app.add_flag_function("-v,--version", print_version(*argv),            \
                               "Print version and exit");                       \
+        app.add_option_function<unsigned int>(                                 \
+            "-j,--threads", configure_shared_executor,                         \
+            "Number of worker threads, 0 uses all hardware threads");          \
         do
 
 
@@ -0,0 +1,53 @@
+#ifndef WORKER_SHARDS_H_V3NB8KQA
+#define WORKER_SHARDS_H_V3NB8KQA
+
+#include <cstddef>
+#include <util/executor.h>
+#include <utility>
+#include <vector>
+
+namespace sens_loc::apps {
+
+/// One instance of \c T for each worker of the \c shared_executor.
+///
+/// This holds per-worker state, e.g. objects that are expensive to create
+/// and not thread safe. A shard is only ever accessed by its worker, which
+/// requires no lock on the per-frame path.
+/// \note Calls from threads that are not part of the executor share one
+/// additional shard and must not happen concurrently.
+/// \note Which frames end up in which shard depends on the scheduling.
+/// Results of frames are collected in \c index_shards instead, to be
+/// reproducible.
+template <typename T>
+class worker_shards {
+  public:
+    /// \param prototype every shard starts as a copy of it
+    explicit worker_shards(const T& prototype = T{})
+        : _shards(shared_executor().num_workers() + 1UL, shard{prototype}) {}
+
+    /// \returns the shard of the calling worker
+    T& local() noexcept {
+        // Threads outside of the executor have the id '-1'.
+        const int id = shared_executor().this_worker_id();
+        return _shards[std::size_t(id + 1)].value;
+    }
+
+    /// Call \p f with every shard in the order of the worker ids.
+    /// \pre no concurrent access to any shard
+    template <typename Function>
+    void for_each(Function&& f) {
+        for (shard& s : _shards)
+            f(s.value);
+    }
+
+  private:
+    /// Shards of different workers do not share a cache line.
+    struct alignas(64) shard {
+        T value;
+    };
+    std::vector<shard> _shards;
+};
+
+}  // namespace sens_loc::apps
+
+#endif /* end of include guard: WORKER_SHARDS_H_V3NB8KQA */
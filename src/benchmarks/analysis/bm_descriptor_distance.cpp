@@ -0,0 +1,70 @@
+#define NONIUS_RUNNER 1
+#include <cstdint>
+#include <nonius/nonius_single.h++>
+#include <opencv2/core.hpp>
+#include <random>
+#include <sens_loc/analysis/descriptor_distance.h>
+#include <vector>
+
+using namespace sens_loc;
+using namespace analysis;
+
+namespace {
+/// Random binary descriptors with the size of ORB descriptors.
+cv::Mat random_binary(int rows) {
+    std::mt19937                            gen{42U};
+    std::uniform_int_distribution<unsigned> byte{0U, 255U};
+    cv::Mat                                 d(rows, 32, CV_8U);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < d.cols; ++c)
+            d.ptr<std::uint8_t>(r)[c] = std::uint8_t(byte(gen));
+    return d;
+}
+
+/// Random float descriptors with the size of SIFT descriptors.
+cv::Mat random_float(int rows) {
+    std::mt19937                          gen{42U};
+    std::uniform_real_distribution<float> value{0.0F, 255.0F};
+    cv::Mat                               d(rows, 128, CV_32F);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < d.cols; ++c)
+            d.ptr<float>(r)[c] = value(gen);
+    return d;
+}
+
+/// Previous implementation, that materializes the whole distance matrix.
+std::vector<float> batch_distance(const cv::Mat& d, int norm, int dtype) {
+    cv::Mat distances;
+    cv::batchDistance(d, d, distances, dtype, cv::noArray(), norm);
+    std::vector<float> minima;
+    minima.reserve(distances.rows);
+    for (int row = 0; row < distances.rows; ++row) {
+        distances.row(row).col(row) = cv::Scalar::all(1e9);
+        double min_val = 0.0;
+        cv::minMaxLoc(distances.row(row), &min_val);
+        minima.push_back(float(min_val));
+    }
+    return minima;
+}
+}  // namespace
+
+NONIUS_BENCHMARK("Hamming batchDistance 5k", [](nonius::chronometer meter) {
+    const cv::Mat d = random_binary(5'000);
+    meter.measure([&] { return batch_distance(d, cv::NORM_HAMMING, CV_32S); });
+})
+
+NONIUS_BENCHMARK("Hamming blocked 5k", [](nonius::chronometer meter) {
+    const cv::Mat d = random_binary(5'000);
+    meter.measure(
+        [&] { return min_descriptor_distances(d, cv::NORM_HAMMING); });
+})
+
+NONIUS_BENCHMARK("L2 batchDistance 5k", [](nonius::chronometer meter) {
+    const cv::Mat d = random_float(5'000);
+    meter.measure([&] { return batch_distance(d, cv::NORM_L2, CV_32F); });
+})
+
+NONIUS_BENCHMARK("L2 blocked 5k", [](nonius::chronometer meter) {
+    const cv::Mat d = random_float(5'000);
+    meter.measure([&] { return min_descriptor_distances(d, cv::NORM_L2); });
+})
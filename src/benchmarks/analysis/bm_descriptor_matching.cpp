@@ -0,0 +1,113 @@
+#define NONIUS_RUNNER 1
+#include <cstdint>
+#include <nonius/nonius_single.h++>
+#include <opencv2/core.hpp>
+#include <opencv2/features2d.hpp>
+#include <random>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <vector>
+
+using namespace sens_loc;
+using namespace analysis;
+
+namespace {
+/// Random binary descriptors with the size of ORB descriptors.
+cv::Mat random_binary(int rows, unsigned seed) {
+    std::mt19937                            gen{seed};
+    std::uniform_int_distribution<unsigned> byte{0U, 255U};
+    cv::Mat                                 d(rows, 32, CV_8U);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < d.cols; ++c)
+            d.ptr<std::uint8_t>(r)[c] = std::uint8_t(byte(gen));
+    return d;
+}
+
+/// Random float descriptors with the size of SIFT descriptors.
+cv::Mat random_float(int rows, unsigned seed) {
+    std::mt19937                          gen{seed};
+    std::uniform_real_distribution<float> value{0.0F, 255.0F};
+    cv::Mat                               d(rows, 128, CV_32F);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < d.cols; ++c)
+            d.ptr<float>(r)[c] = value(gen);
+    return d;
+}
+
+/// Matching of two sets of \p n descriptors with OpenCV.
+void bf_matcher(nonius::chronometer meter, int n) {
+    const cv::Mat query = random_binary(n, 1U);
+    const cv::Mat train = random_binary(n, 2U);
+    const auto    matcher =
+        cv::BFMatcher::create(cv::NORM_HAMMING, /*crossCheck=*/true);
+    meter.measure([&] {
+        std::vector<cv::DMatch> matches;
+        matcher->match(query, train, matches);
+        return matches;
+    });
+}
+
+/// Matching of two sets of \p n descriptors with the fused cross-check.
+void fused_matcher(nonius::chronometer meter, int n) {
+    const cv::Mat query = random_binary(n, 1U);
+    const cv::Mat train = random_binary(n, 2U);
+    meter.measure([&] {
+        return match_descriptors(query, train, cv::NORM_HAMMING,
+                                 match_strategy::crosscheck);
+    });
+}
+
+/// Ratio test with OpenCV, that requires the two nearest neighbours.
+void bf_ratio_matcher(nonius::chronometer meter, int n) {
+    const cv::Mat query   = random_float(n, 1U);
+    const cv::Mat train   = random_float(n, 2U);
+    const auto    matcher = cv::BFMatcher::create(cv::NORM_L2);
+    meter.measure([&] {
+        std::vector<std::vector<cv::DMatch>> knn_matches;
+        matcher->knnMatch(query, train, knn_matches, 2);
+        std::vector<cv::DMatch> matches;
+        for (const auto& m : knn_matches)
+            if (m.size() == 2 &&
+                m[0].distance < default_match_ratio * m[1].distance)
+                matches.push_back(m[0]);
+        return matches;
+    });
+}
+
+/// Ratio test with the two nearest neighbours from a single pass.
+void single_pass_ratio_matcher(nonius::chronometer meter,
+                               int                 n,
+                               match_strategy      strategy) {
+    const cv::Mat query = random_float(n, 1U);
+    const cv::Mat train = random_float(n, 2U);
+    meter.measure(
+        [&] { return match_descriptors(query, train, cv::NORM_L2, strategy); });
+}
+}  // namespace
+
+NONIUS_BENCHMARK("Hamming BFMatcher 1k",
+                 [](nonius::chronometer meter) { bf_matcher(meter, 1'000); })
+NONIUS_BENCHMARK("Hamming fused 1k",
+                 [](nonius::chronometer meter) { fused_matcher(meter, 1'000); })
+
+NONIUS_BENCHMARK("Hamming BFMatcher 5k",
+                 [](nonius::chronometer meter) { bf_matcher(meter, 5'000); })
+NONIUS_BENCHMARK("Hamming fused 5k",
+                 [](nonius::chronometer meter) { fused_matcher(meter, 5'000); })
+
+NONIUS_BENCHMARK("Hamming BFMatcher 20k",
+                 [](nonius::chronometer meter) { bf_matcher(meter, 20'000); })
+NONIUS_BENCHMARK("Hamming fused 20k", [](nonius::chronometer meter) {
+    fused_matcher(meter, 20'000);
+})
+
+NONIUS_BENCHMARK("L2 BFMatcher ratio 5k", [](nonius::chronometer meter) {
+    bf_ratio_matcher(meter, 5'000);
+})
+NONIUS_BENCHMARK("L2 single pass ratio 5k", [](nonius::chronometer meter) {
+    single_pass_ratio_matcher(meter, 5'000, match_strategy::ratio);
+})
+NONIUS_BENCHMARK("L2 single pass ratio crosscheck 5k",
+                 [](nonius::chronometer meter) {
+                     single_pass_ratio_matcher(
+                         meter, 5'000, match_strategy::ratio_crosscheck);
+                 })
@@ -0,0 +1,59 @@
+#define NONIUS_RUNNER 1
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <nonius/nonius_single.h++>
+#include <opencv2/core/types.hpp>
+#include <random>
+#include <sens_loc/analysis/keypoints.h>
+#include <vector>
+
+using namespace sens_loc;
+using namespace analysis;
+
+namespace {
+/// Uniformly distributed keypoints in a full HD image, similar to a dense
+/// AGAST or FAST detection.
+std::vector<cv::KeyPoint> random_keypoints(std::size_t n) {
+    std::mt19937                          gen{42U};
+    std::uniform_real_distribution<float> x{0.0F, 1920.0F};
+    std::uniform_real_distribution<float> y{0.0F, 1080.0F};
+
+    std::vector<cv::KeyPoint> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        points.emplace_back(x(gen), y(gen), 7.0F);
+    return points;
+}
+
+/// Reference implementation that compares all pairs of keypoints.
+std::vector<float> all_pairs(const std::vector<cv::KeyPoint>& points) {
+    std::vector<float> distances(points.size(),
+                                 std::numeric_limits<float>::max());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        for (std::size_t k = i + 1; k < points.size(); ++k) {
+            const float d = std::hypot(points[i].pt.x - points[k].pt.x,
+                                       points[i].pt.y - points[k].pt.y);
+            distances[i]  = std::min(distances[i], d);
+            distances[k]  = std::min(distances[k], d);
+        }
+    }
+    return distances;
+}
+}  // namespace
+
+NONIUS_BENCHMARK("Nearest Neighbour Grid 5k", [](nonius::chronometer meter) {
+    const auto points = random_keypoints(5'000UL);
+    meter.measure([&] { return nearest_neighbour_distances(points); });
+})
+
+NONIUS_BENCHMARK("Nearest Neighbour All Pairs 5k",
+                 [](nonius::chronometer meter) {
+                     const auto points = random_keypoints(5'000UL);
+                     meter.measure([&] { return all_pairs(points); });
+                 })
+
+NONIUS_BENCHMARK("Nearest Neighbour Grid 50k", [](nonius::chronometer meter) {
+    const auto points = random_keypoints(50'000UL);
+    meter.measure([&] { return nearest_neighbour_distances(points); });
+})
@@ -0,0 +1,52 @@
+#define NONIUS_RUNNER 1
+#include <Eigen/Geometry>
+#include <nonius/nonius_single.h++>
+#include <random>
+#include <sens_loc/camera_models/pinhole.h>
+#include <sens_loc/camera_models/projection.h>
+#include <sens_loc/math/pointcloud.h>
+
+using namespace sens_loc;
+using namespace camera_models;
+
+namespace {
+/// Intrinsic of the kinect, that is used for the recognition analysis.
+const pinhole<float> kinect{/*w=*/960,     /*h=*/540,     /*fx=*/519.0F,
+                            /*fy=*/522.0F, /*cx=*/480.0F, /*cy=*/270.0F};
+
+/// Points in front of the camera, similar to backprojected keypoints.
+math::pointcloud_t random_points(std::size_t n) {
+    std::mt19937                          gen{42U};
+    std::uniform_real_distribution<float> xy{-2.0F, 2.0F};
+    std::uniform_real_distribution<float> z{0.5F, 4.0F};
+
+    math::pointcloud_t points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        points.emplace_back(xy(gen), xy(gen), z(gen));
+    return points;
+}
+
+math::pose_t small_motion() {
+    math::pose_t p = math::pose_t::Identity();
+    p.block<3, 3>(0, 0) =
+        Eigen::AngleAxisf(0.05F, Eigen::Vector3f::UnitY()).toRotationMatrix();
+    p(0, 3) = 0.02F;
+    p(2, 3) = 0.10F;
+    return p;
+}
+}  // namespace
+
+NONIUS_BENCHMARK("Project AoS 20k", [](nonius::chronometer meter) {
+    const auto points = random_points(20'000UL);
+    const auto pose   = small_motion();
+    meter.measure([&] { return project_to_image(kinect, pose * points); });
+})
+
+NONIUS_BENCHMARK("Project SoA 20k", [](nonius::chronometer meter) {
+    const auto points = math::to_soa(random_points(20'000UL));
+    const auto pose   = small_motion();
+    meter.measure([&] {
+        return project_to_image(kinect, math::transform(pose, points));
+    });
+})
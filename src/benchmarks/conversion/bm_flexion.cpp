@@ -2,7 +2,12 @@
 #include "util.h"
 
 #include <nonius/nonius_single.h++>
+#include <opencv2/core/types.hpp>
+#include <sens_loc/camera_models/ray_table.h>
+#include <sens_loc/conversion/conversion_plan.h>
 #include <sens_loc/conversion/depth_to_flexion.h>
+#include <sens_loc/conversion/sparse_conversion.h>
+#include <vector>
 
 using namespace sens_loc;
 using namespace conversion;
@@ -32,6 +37,40 @@ NONIUS_BENCHMARK("Depth2Flexion Parallel", [](nonius::chronometer meter) {
     });
 })
 
+NONIUS_BENCHMARK("Depth2Flexion Parallel Plan", [](nonius::chronometer meter) {
+    const auto [_, euclid, p] = get_data();
+    (void) _;
+
+    auto         in = euclid;
+    tf::Executor exe;
+
+    // The taskgraph is built once, each measurement only runs it.
+    conversion_plan<camera_models::pinhole> plan(p);
+    plan.add_flexion();
+    plan.bind_input(in);
+
+    meter.measure([&] { plan.run(exe).wait(); });
+})
+
+NONIUS_BENCHMARK("Depth2Flexion Sparse 500 Patches",
+                 [](nonius::chronometer meter) {
+                     const auto [_, euclid, p] = get_data();
+                     (void) _;
+
+                     auto in = euclid;
+                     const camera_models::ray_table<float> rays(p);
+
+                     // Patches of 32x32 pixels spread over the whole image,
+                     // similar to the neighbourhood of detected keypoints.
+                     std::vector<cv::Rect> patches;
+                     for (int i = 0; i < 500; ++i)
+                         patches.emplace_back((i * 97) % (in.w() - 32),
+                                              (i * 31) % (in.h() - 32), 32, 32);
+
+                     meter.measure(
+                         [&] { return sparse_flexion(in, rays, patches); });
+                 })
+
 NONIUS_BENCHMARK("Depth2Flexion Laserscan", [](nonius::chronometer meter) {
     const auto [euclid, p] = get_data_laserscan();
     auto in                = euclid;
@@ -0,0 +1,81 @@
+#define NONIUS_RUNNER 1
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <nonius/nonius_single.h++>
+#include <numeric>
+#include <opencv2/core/types.hpp>
+#include <random>
+#include <sens_loc/features/anms.h>
+#include <vector>
+
+using namespace sens_loc;
+using namespace features;
+
+namespace {
+/// Keypoints similar to the output of AGAST on a full HD image: integer
+/// positions and integer scores above the detection threshold.
+std::vector<cv::KeyPoint> agast_keypoints(std::size_t n) {
+    std::mt19937                       gen{42U};
+    std::uniform_int_distribution<int> x{0, 1919};
+    std::uniform_int_distribution<int> y{0, 1079};
+    std::geometric_distribution<int>   score{0.05};
+
+    std::vector<cv::KeyPoint> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        points.emplace_back(float(x(gen)), float(y(gen)), 7.0F, -1.0F,
+                            float(50 + score(gen)));
+    return points;
+}
+
+/// Reference implementation that compares all pairs of keypoints and keeps
+/// the \p count keypoints with the largest radius.
+std::vector<cv::KeyPoint> all_pairs(const std::vector<cv::KeyPoint>& points,
+                                    std::size_t                      count) {
+    std::vector<float> radii(points.size(),
+                             std::numeric_limits<float>::infinity());
+    for (std::size_t i = 0; i < points.size(); ++i)
+        for (std::size_t k = 0; k < points.size(); ++k)
+            if (points[i].response <
+                default_robustness * points[k].response)
+                radii[i] = std::min(
+                    radii[i], std::hypot(points[i].pt.x - points[k].pt.x,
+                                         points[i].pt.y - points[k].pt.y));
+
+    std::vector<std::size_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0UL);
+    std::partial_sort(
+        order.begin(), order.begin() + long(count), order.end(),
+        [&](std::size_t i, std::size_t k) { return radii[i] > radii[k]; });
+
+    std::vector<cv::KeyPoint> selected;
+    selected.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        selected.push_back(points[order[i]]);
+    return selected;
+}
+}  // namespace
+
+NONIUS_BENCHMARK("ANMS Grid 20k", [](nonius::chronometer meter) {
+    const auto points = agast_keypoints(20'000UL);
+    meter.measure([&] {
+        auto selected = points;
+        selected.erase(partition_anms(selected, 2'000UL), selected.end());
+        return selected;
+    });
+})
+
+NONIUS_BENCHMARK("ANMS All Pairs 20k", [](nonius::chronometer meter) {
+    const auto points = agast_keypoints(20'000UL);
+    meter.measure([&] { return all_pairs(points, 2'000UL); });
+})
+
+NONIUS_BENCHMARK("ANMS Grid 100k", [](nonius::chronometer meter) {
+    const auto points = agast_keypoints(100'000UL);
+    meter.measure([&] {
+        auto selected = points;
+        selected.erase(partition_anms(selected, 2'000UL), selected.end());
+        return selected;
+    });
+})
@@ -0,0 +1,135 @@
+#ifndef ANN_INDEX_H_M6QZ3VKD
+#define ANN_INDEX_H_M6QZ3VKD
+
+#include <cstdint>
+#include <gsl/gsl>
+#include <opencv2/core/base.hpp>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <vector>
+
+namespace sens_loc::analysis {
+
+/// Build and query parameters of the approximate nearest neighbour indices.
+struct ann_parameters {
+    /// Number of hash tables for binary descriptors.
+    int lsh_tables = 8;
+    /// Number of sampled bits per hash key, at most 32.
+    int lsh_key_bits = 16;
+    /// Buckets with keys that differ in up to this many bits from the query
+    /// key are searched as well, at most 2.
+    int lsh_probe_level = 1;
+    /// Number of links per node in the HNSW graph for float descriptors, the
+    /// lowest layer has twice as many.
+    int hnsw_links = 16;
+    /// Size of the candidate list while the graph is built.
+    int hnsw_ef_construction = 100;
+    /// Size of the candidate list for each query.
+    int hnsw_ef_search = 64;
+};
+
+/// The two closest descriptors that were found for a query.
+/// Indices are \c -1 if less descriptors were found.
+struct nearest_neighbours {
+    int   first           = -1;
+    float first_distance  = 0.0F;
+    int   second          = -1;
+    float second_distance = 0.0F;
+};
+
+namespace detail {
+/// Hierarchical navigable small world graph over the rows of a descriptor
+/// matrix. Only the links are stored, the descriptors stay in their matrix.
+struct hnsw_graph {
+    /// Highest layer of each node.
+    std::vector<int> levels;
+    /// Links on layer 0 with \c max_links_0 slots per node.
+    std::vector<int> links_0;
+    std::vector<int> link_count_0;
+    int              max_links_0 = 0;
+    /// Links on the upper layers, \c upper_links[node][level - 1].
+    std::vector<std::vector<std::vector<int>>> upper_links;
+    int                                        max_links   = 0;
+    int                                        entry_point = -1;
+    int                                        top_level   = -1;
+};
+
+/// Hash tables for binary descriptors, each key concatenates a random
+/// subset of the descriptor bits.
+struct lsh_tables {
+    struct table {
+        /// Bit positions within the descriptor that form the key.
+        std::vector<int> bits;
+        /// Keys with more bits than required for the number of rows are
+        /// hashed to \c bucket_bits.
+        int bucket_bits = 0;
+        /// The rows in bucket 'b' are \c rows[offsets[b]] to
+        /// \c rows[offsets[b + 1]] (exclusive).
+        std::vector<int> offsets;
+        std::vector<int> rows;
+    };
+    std::vector<table> tables;
+};
+}  // namespace detail
+
+/// Approximate nearest neighbour index over a set of descriptors.
+///
+/// Binary descriptors are hashed into multiple tables of locality sensitive
+/// hashes and neighbouring buckets are probed as well. Float descriptors are
+/// inserted into a HNSW graph, that is searched greedily from its sparse top
+/// layer to the dense bottom layer.
+/// The candidates of both indices are compared with the exact distance
+/// kernels of \c min_descriptor_distances. The indices are deterministic, the
+/// same descriptors and parameters result in the same matches.
+/// \note the index is built once and can be searched concurrently.
+class ann_index {
+  public:
+    /// Build the index over the rows of \p descriptors.
+    /// \pre is_descriptor_norm(norm)
+    /// \pre the hamming norms require \c CV_8U descriptors, descriptors for
+    /// the L-norms are converted to \c CV_32F
+    ann_index(const cv::Mat&        descriptors,
+              cv::NormTypes         norm,
+              const ann_parameters& parameters = {});
+
+    /// Search the two nearest neighbours for each row of \p queries.
+    /// \pre queries have the same type and width as the indexed descriptors
+    /// \returns the neighbours for row 'i' at position 'i'
+    [[nodiscard]] std::vector<nearest_neighbours>
+    search(const cv::Mat& queries) const;
+    /// Search the two nearest neighbours only for the rows \p rows of
+    /// \p queries.
+    /// \returns the neighbours for \c rows[i] at position 'i'
+    [[nodiscard]] std::vector<nearest_neighbours>
+    search(const cv::Mat& queries, gsl::span<const int> rows) const;
+
+    /// The indexed descriptors, converted to \c CV_32F for the L-norms.
+    [[nodiscard]] const cv::Mat& descriptors() const noexcept {
+        return _descriptors;
+    }
+    [[nodiscard]] cv::NormTypes norm() const noexcept { return _norm; }
+
+  private:
+    cv::Mat            _descriptors;
+    cv::NormTypes      _norm;
+    ann_parameters     _parameters;
+    detail::hnsw_graph _graph;
+    detail::lsh_tables _hashes;
+};
+
+/// Approximate version of \c match_descriptors, that searches the nearest
+/// neighbours of the descriptors of \p query in \p train.
+/// Cross-checking searches the matched train descriptors in \p query.
+/// \pre query.norm() == train.norm()
+/// \returns at most one match per query descriptor ordered by \c queryIdx
+/// \sa match_descriptors
+std::vector<cv::DMatch>
+match_descriptors(const ann_index& query,
+                  const ann_index& train,
+                  match_strategy   strategy,
+                  float            ratio = default_match_ratio);
+
+}  // namespace sens_loc::analysis
+
+#endif /* end of include guard: ANN_INDEX_H_M6QZ3VKD */
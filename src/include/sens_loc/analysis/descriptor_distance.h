@@ -0,0 +1,197 @@
+#ifndef DESCRIPTOR_DISTANCE_H_R7XKQ2PD
+#define DESCRIPTOR_DISTANCE_H_R7XKQ2PD
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gsl/gsl>
+#include <opencv2/core/base.hpp>
+#include <opencv2/core/mat.hpp>
+#include <utility>
+#include <vector>
+
+namespace sens_loc::analysis {
+
+/// \returns \c true if \p norm is supported by the descriptor distance
+/// kernels, these are \c NORM_L1, \c NORM_L2, \c NORM_L2SQR, \c NORM_HAMMING
+/// and \c NORM_HAMMING2.
+bool is_descriptor_norm(cv::NormTypes norm) noexcept;
+
+/// Calculate the minimal distance of each descriptor in \p descriptors to all
+/// other descriptors in the same set.
+///
+/// The distances are computed in tiles of rows and only the minimum per row
+/// is kept, the full distance matrix is never stored. This requires \c O(n)
+/// memory instead of \c O(n^2) like \c cv::batchDistance.
+/// \param descriptors one descriptor per row, \c CV_8U for the hamming norms,
+/// \c CV_8U or \c CV_32F for the L-norms
+/// \param norm distance measure, must be supported by \c is_descriptor_norm
+/// \returns the minimal distance for row 'i' at position 'i', empty if there
+/// are less than two descriptors
+std::vector<float> min_descriptor_distances(const cv::Mat& descriptors,
+                                            cv::NormTypes  norm);
+
+namespace detail {
+/// Number of rows in one block of query descriptors.
+constexpr int block_rows = 64;
+/// Number of rows of train descriptors that are compared to one block of
+/// queries before advancing. A tile of binary descriptors fits into the L1
+/// cache, a tile of float descriptors into the L2 cache.
+constexpr int tile_rows = 256;
+
+/// Number of differing bits between two binary descriptors.
+/// The descriptors are processed in 64 bit words, which compile to
+/// \c popcnt or vectorized population counts if the target supports them.
+struct hamming_distance {
+    using element_type = std::uint8_t;
+
+    int operator()(const std::uint8_t* a,
+                   const std::uint8_t* b,
+                   int                 bytes) const noexcept {
+        int d = 0;
+        int i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            std::uint64_t wa;
+            std::uint64_t wb;
+            std::memcpy(&wa, a + i, sizeof(wa));
+            std::memcpy(&wb, b + i, sizeof(wb));
+            d += __builtin_popcountll(wa ^ wb);
+        }
+        for (; i < bytes; ++i)
+            d += __builtin_popcount(unsigned(a[i] ^ b[i]));
+        return d;
+    }
+};
+
+/// Number of differing 2-bit cells between two binary descriptors, which is
+/// the distance for ORB descriptors with \c WTA_K of 3 or 4.
+struct hamming2_distance {
+    using element_type = std::uint8_t;
+
+    int operator()(const std::uint8_t* a,
+                   const std::uint8_t* b,
+                   int                 bytes) const noexcept {
+        constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+        int                     d         = 0;
+        int                     i         = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            std::uint64_t wa;
+            std::uint64_t wb;
+            std::memcpy(&wa, a + i, sizeof(wa));
+            std::memcpy(&wb, b + i, sizeof(wb));
+            const std::uint64_t x = wa ^ wb;
+            d += __builtin_popcountll((x | (x >> 1U)) & even_bits);
+        }
+        for (; i < bytes; ++i) {
+            const unsigned x = unsigned(a[i] ^ b[i]);
+            d += __builtin_popcount((x | (x >> 1U)) & 0x55U);
+        }
+        return d;
+    }
+};
+
+/// Squared euclidean distance between two float descriptors.
+/// Independent partial sums allow vectorization without relaxing the
+/// floating point semantics.
+struct l2sqr_distance {
+    using element_type = float;
+
+    float operator()(const float* a, const float* b, int n) const noexcept {
+        constexpr int lanes = 8;
+        float         acc[lanes]{};
+        int           i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            for (int l = 0; l < lanes; ++l) {
+                const float d = a[i + l] - b[i + l];
+                acc[l] += d * d;
+            }
+        }
+        float s = 0.0F;
+        for (; i < n; ++i) {
+            const float d = a[i] - b[i];
+            s += d * d;
+        }
+        for (float p : acc)
+            s += p;
+        return s;
+    }
+};
+
+/// Manhattan distance between two float descriptors.
+struct l1_distance {
+    using element_type = float;
+
+    float operator()(const float* a, const float* b, int n) const noexcept {
+        constexpr int lanes = 8;
+        float         acc[lanes]{};
+        int           i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            for (int l = 0; l < lanes; ++l)
+                acc[l] += std::abs(a[i + l] - b[i + l]);
+        }
+        float s = 0.0F;
+        for (; i < n; ++i)
+            s += std::abs(a[i] - b[i]);
+        for (float p : acc)
+            s += p;
+        return s;
+    }
+};
+
+/// Kernel for descriptors with \p Width elements known at compile time, which
+/// allows the compiler to unroll and vectorize the distance completely.
+template <typename Distance, int Width>
+struct fixed_width_distance {
+    using element_type = typename Distance::element_type;
+
+    auto operator()(const element_type* a,
+                    const element_type* b,
+                    int /*width*/) const noexcept {
+        return Distance{}(a, b, Width);
+    }
+};
+
+template <typename Distance, int... Widths, typename Function>
+void visit_width(int width, Function&& f) {
+    const bool fixed =
+        ((width == Widths
+              ? (f(fixed_width_distance<Distance, Widths>{}), true)
+              : false) ||
+         ...);
+    if (!fixed)
+        f(Distance{});
+}
+
+/// Call \p f with the distance kernel for \p norm. The kernels are
+/// specialized for the descriptor widths of the common detectors: 32, 61 and
+/// 64 bytes for ORB, AKAZE and BRISK, 64 and 128 floats for SURF and SIFT.
+/// \note \c NORM_L2 and \c NORM_L2SQR both yield the squared distance.
+/// \pre is_descriptor_norm(norm)
+template <typename Function>
+void visit_distance(cv::NormTypes norm, int width, Function&& f) {
+    switch (norm) {
+    case cv::NORM_HAMMING:
+        visit_width<hamming_distance, 32, 61, 64>(width, f);
+        return;
+    case cv::NORM_HAMMING2:
+        visit_width<hamming2_distance, 32, 64>(width, f);
+        return;
+    case cv::NORM_L1: visit_width<l1_distance, 64, 128>(width, f); return;
+    default: visit_width<l2sqr_distance, 64, 128>(width, f); return;
+    }
+}
+
+/// Calculate the minimal distances for the rows \p begin to \p end
+/// (exclusive) of \p descriptors into \p out.
+/// For the L2 norm the squared distances are compared and only the minimum
+/// is converted.
+void min_descriptor_distance_rows(const cv::Mat& descriptors,
+                                  cv::NormTypes  norm,
+                                  int            begin,
+                                  int            end,
+                                  float*         out) noexcept;
+}  // namespace detail
+
+}  // namespace sens_loc::analysis
+
+#endif /* end of include guard: DESCRIPTOR_DISTANCE_H_R7XKQ2PD */
@@ -0,0 +1,55 @@
+#ifndef DESCRIPTOR_MATCHING_H_W3NB8TQC
+#define DESCRIPTOR_MATCHING_H_W3NB8TQC
+
+#include <opencv2/core/base.hpp>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <vector>
+
+namespace sens_loc::analysis {
+
+/// Filters for the nearest neighbour of each query descriptor.
+enum class match_strategy {
+    nearest,           ///< Every nearest neighbour is a match.
+    crosscheck,        ///< The query must be the nearest neighbour of its
+                       ///< match as well, like \c cv::BFMatcher with
+                       ///< \c crossCheck.
+    ratio,             ///< Lowe's ratio test, the nearest neighbour must be
+                       ///< clearly closer than the second nearest neighbour.
+    ratio_crosscheck,  ///< Both the ratio test and the cross-check.
+};
+
+/// Ratio between the closest and the second closest distance, that is
+/// commonly used for the ratio test.
+constexpr float default_match_ratio = 0.8F;
+
+/// Match each descriptor in \p query to its closest descriptor in \p train.
+///
+/// The result is the same as \c cv::BFMatcher::match, but the distances are
+/// computed in tiles with the kernels of \c min_descriptor_distances.
+/// All filters are evaluated in a single pass over the distance tiles. The
+/// forward and the backward nearest neighbours for cross-checking are found
+/// together and the ratio test keeps the two closest distances per query,
+/// instead of matching twice or searching the two nearest neighbours with
+/// \c cv::BFMatcher::knnMatch.
+/// \param query,train one descriptor per row, \c CV_8U for the hamming norms,
+/// \c CV_8U or \c CV_32F for the L-norms
+/// \param norm distance measure, must be supported by \c is_descriptor_norm
+/// \param strategy filter for the nearest neighbours
+/// \param ratio a match is accepted by the ratio test, if its distance is
+/// smaller than \p ratio times the distance to the second closest descriptor.
+/// A single train descriptor always passes the test.
+/// \pre 0 < ratio <= 1
+/// \returns at most one match per query descriptor ordered by \c queryIdx.
+/// If multiple descriptors have the same distance, the lowest index wins.
+/// \sa min_descriptor_distances
+std::vector<cv::DMatch>
+match_descriptors(const cv::Mat& query,
+                  const cv::Mat& train,
+                  cv::NormTypes  norm,
+                  match_strategy strategy,
+                  float          ratio = default_match_ratio);
+
+}  // namespace sens_loc::analysis
+
+#endif /* end of include guard: DESCRIPTOR_MATCHING_H_W3NB8TQC */
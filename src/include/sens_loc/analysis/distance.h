@@ -12,6 +12,8 @@
 #include <cstddef>
 #include <gsl/gsl>
 #include <opencv2/core/persistence.hpp>
+#include <sens_loc/analysis/quantile_sketch.h>
+#include <vector>
 
 namespace sens_loc {
 
@@ -80,6 +82,38 @@ struct statistic {
         return s;
     }
 
+    /// Extract the statistical values from streamed data. The median and
+    /// the decentils are estimated by \p quantiles, all other values are
+    /// exact.
+    /// \pre m.count() == quantiles.count()
+    /// \sa quantile_sketch for the error bound
+    static statistic make(const moments& m, const quantile_sketch& quantiles) {
+        Expects(m.count() == quantiles.count());
+
+        statistic s;
+
+        if (m.count() == 0UL)
+            return s;
+
+        // The same ranks as for the sorted data are selected.
+        if (m.count() >= 10UL) {
+            const std::size_t number_quantils = 10UL;
+            const std::size_t delta           = m.count() / number_quantils;
+            for (std::size_t i = 1; i < number_quantils; ++i)
+                s.decentils[i - 1] = quantiles.at_rank(i * delta);
+        }
+        s.median = quantiles.at_rank(m.count() / 2);
+
+        s.count    = m.count();
+        s.min      = m.min();
+        s.max      = m.max();
+        s.mean     = static_cast<float>(m.mean());
+        s.variance = static_cast<float>(m.variance());
+        s.stddev   = std::sqrt(s.variance);
+        s.skewness = static_cast<float>(m.skewness());
+        return s;
+    }
+
     void reset() noexcept {
         count     = 0UL;
         min       = 0.0F;
@@ -96,6 +130,76 @@ struct statistic {
 /// Write-Functionality for OpenCVs-Filestorage API.
 void write(cv::FileStorage& fs, const std::string& name, const statistic& stat);
 
+/// Collect scalar values for the analysis with \c distance.
+///
+/// By default only the streaming moments and a quantile sketch of the values
+/// are kept, which requires constant memory no matter how many values are
+/// inserted. Median, decentils and histograms are then approximated within
+/// the error bound of \c quantile_sketch.
+/// In exact mode all values are stored and sorted for the analysis instead.
+/// \note accumulators can be merged, which allows to collect values in
+/// parallel.
+class distance_accumulator {
+  public:
+    /// \param exact store all values instead of sketching them
+    explicit distance_accumulator(bool exact) noexcept
+        : _exact{exact} {}
+
+    void insert(float value) {
+        if (_exact) {
+            _values.push_back(value);
+        } else {
+            _moments.insert(value);
+            _sketch.insert(value);
+        }
+    }
+    void insert(gsl::span<const float> values) {
+        if (_exact) {
+            _values.insert(_values.end(), values.begin(), values.end());
+        } else {
+            _moments.insert(values);
+            _sketch.insert(values);
+        }
+    }
+
+    /// Add all values of \p other to this accumulator.
+    /// \pre exact() == other.exact()
+    void merge(const distance_accumulator& other) {
+        Expects(_exact == other._exact);
+        if (_exact) {
+            _values.insert(_values.end(), other._values.begin(),
+                           other._values.end());
+        } else {
+            _moments.merge(other._moments);
+            _sketch.merge(other._sketch);
+        }
+    }
+
+    [[nodiscard]] bool        exact() const noexcept { return _exact; }
+    [[nodiscard]] std::size_t count() const noexcept {
+        return _exact ? _values.size() : _moments.count();
+    }
+    [[nodiscard]] bool empty() const noexcept { return count() == 0UL; }
+
+    /// The inserted values in insertion order, only stored in exact mode.
+    [[nodiscard]] std::vector<float>& values() noexcept { return _values; }
+    [[nodiscard]] const std::vector<float>& values() const noexcept {
+        return _values;
+    }
+    [[nodiscard]] const moments& get_moments() const noexcept {
+        return _moments;
+    }
+    [[nodiscard]] const quantile_sketch& sketch() const noexcept {
+        return _sketch;
+    }
+
+  private:
+    bool               _exact;
+    std::vector<float> _values;
+    moments            _moments;
+    quantile_sketch    _sketch;
+};
+
 /// This class processes 'float' datapoints and calculates both histograms
 /// and basic statistical quantities, like the 'min', 'max', 'mean' and
 /// others.
@@ -124,12 +228,24 @@ class distance {
         , _axis_title{std::move(title)} {
         analyze(distances);
     }
+    explicit distance(distance_accumulator values,
+                      unsigned int         bin_count = 50U,
+                      std::string          title     = "distance") noexcept
+        : _bin_count{bin_count}
+        , _axis_title{std::move(title)} {
+        analyze(std::move(values));
+    }
 
     /// Analyses the provided distances. This will overwrite a previous
     /// analysis and dataset! Use this method to provide the data if the
     /// class was default constructed.
     /// \pre is_sorted(distances)
     void analyze(gsl::span<const float> distances, bool histo = true) noexcept;
+    /// Analyses the collected values. Exact values are sorted and analyzed
+    /// like above. Otherwise the statistic and the histogram are derived from
+    /// the sketch, each retained value of the sketch is counted with the
+    /// number of values it represents.
+    void analyze(distance_accumulator values, bool histo = true) noexcept;
 
     /// Return the reference to the potentially created histogram in \c analyze.
     /// If the histogram is not created, it will just be default constructed.
@@ -6,6 +6,7 @@
 #include <opencv2/core/persistence.hpp>
 #include <opencv2/core/types.hpp>
 #include <sens_loc/analysis/distance.h>
+#include <vector>
 
 namespace sens_loc::analysis {
 
@@ -84,6 +85,21 @@ class keypoints {
                  bool                          size         = true,
                  bool                          response     = true) noexcept;
 
+    /// Accumulate the properties of \p points without storing them. After
+    /// all keypoints are accumulated, \c summarize provides the same results
+    /// as \c analyze, with median, decentils and the size and response
+    /// histograms approximated by quantile sketches.
+    /// \note the configuration must not change while accumulating
+    /// \sa distance_accumulator
+    void accumulate(gsl::span<const cv::KeyPoint> points) noexcept;
+    /// Add the keypoints that were accumulated by \p other, e.g. in another
+    /// thread.
+    /// \pre both have the same configuration
+    void merge(const keypoints& other);
+    /// Calculate statistics and histograms of all accumulated keypoints.
+    /// This will overwrite the results of a previous analysis.
+    void summarize() noexcept;
+
     [[nodiscard]] const distribution_histo_t& distribution() const noexcept {
         return _distribution;
     }
@@ -115,6 +131,10 @@ class keypoints {
     unsigned int _response_bins  = 50U;
     std::string  _response_title = "response of keypoints";
 
+    distance_accumulator _size_values{/*exact=*/false};
+    distance_accumulator _response_values{/*exact=*/false};
+    bool                 _accumulating = false;
+
     distribution_histo_t _distribution;
     unsigned int         _dist_width_bins  = 50U;
     unsigned int         _dist_height_bins = 50U;
@@ -122,6 +142,18 @@ class keypoints {
     std::string          _dist_h_title = "height - distribution of keypoints";
 };
 
+/// Calculate the euclidean pixel distance of each keypoint to its nearest
+/// neighbour in \p points.
+///
+/// The keypoints are sorted into a uniform grid with roughly one keypoint per
+/// cell, which makes the search for \c n keypoints \c O(n) on average instead
+/// of comparing all pairs.
+/// \pre all keypoints have finite coordinates
+/// \returns the distance for keypoint 'i' at position 'i', empty if there are
+/// less than two keypoints
+std::vector<float>
+nearest_neighbour_distances(gsl::span<const cv::KeyPoint> points);
+
 /// Write the statistics for the keypoint distribution in a file with OpenCVs
 /// FileStorage API.
 void write(cv::FileStorage& fs, const std::string& name, const keypoints& kp);
@@ -0,0 +1,175 @@
+#ifndef QUANTILE_SKETCH_H_T8WZ4NQE
+#define QUANTILE_SKETCH_H_T8WZ4NQE
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gsl/gsl>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sens_loc::analysis {
+
+/// Streaming calculation of the first three central moments and the range
+/// of a set of values.
+///
+/// The values are not stored, each insertion updates the moments with the
+/// numerically stable recurrences of Welford and Terriberry. Two sets of
+/// moments can be merged, which allows to accumulate in parallel.
+/// \note variance and skewness are the population moments, like the
+/// corresponding boost accumulators.
+class moments {
+  public:
+    void insert(float value) noexcept {
+        const double x       = value;
+        const double n1      = double(_count);
+        const double n       = n1 + 1.0;
+        const double delta   = x - _mean;
+        const double delta_n = delta / n;
+        const double term    = delta * delta_n * n1;
+
+        _mean += delta_n;
+        _m3 += term * delta_n * (n - 2.0) - 3.0 * delta_n * _m2;
+        _m2 += term;
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+        ++_count;
+    }
+    void insert(gsl::span<const float> values) noexcept {
+        for (float v : values)
+            insert(v);
+    }
+
+    /// Combine the moments of \p other into these moments, as if all values
+    /// had been inserted here.
+    void merge(const moments& other) noexcept {
+        if (other._count == 0UL)
+            return;
+        if (_count == 0UL) {
+            *this = other;
+            return;
+        }
+        const double na    = double(_count);
+        const double nb    = double(other._count);
+        const double n     = na + nb;
+        const double delta = other._mean - _mean;
+
+        _m3 += other._m3 +
+               delta * delta * delta * na * nb * (na - nb) / (n * n) +
+               3.0 * delta * (na * other._m2 - nb * _m2) / n;
+        _m2 += other._m2 + delta * delta * na * nb / n;
+        _mean += delta * nb / n;
+        _min = std::min(_min, other._min);
+        _max = std::max(_max, other._max);
+        _count += other._count;
+    }
+
+    [[nodiscard]] std::size_t count() const noexcept { return _count; }
+    [[nodiscard]] float min() const noexcept { return _count ? _min : 0.0F; }
+    [[nodiscard]] float max() const noexcept { return _count ? _max : 0.0F; }
+    [[nodiscard]] double mean() const noexcept { return _mean; }
+    [[nodiscard]] double variance() const noexcept {
+        return _count ? _m2 / double(_count) : 0.0;
+    }
+    /// \returns \c 0 if all values are equal
+    [[nodiscard]] double skewness() const noexcept {
+        if (_count == 0UL || _m2 <= 0.0)
+            return 0.0;
+        const double n = double(_count);
+        return std::sqrt(n) * _m3 / std::pow(_m2, 1.5);
+    }
+
+  private:
+    std::size_t _count = 0UL;
+    float       _min   = std::numeric_limits<float>::max();
+    float       _max   = std::numeric_limits<float>::lowest();
+    double      _mean  = 0.0;
+    /// Sums of the squared and cubed differences to the mean.
+    double _m2 = 0.0;
+    double _m3 = 0.0;
+};
+
+/// Approximate quantiles of a stream of values in constant memory.
+///
+/// This is the KLL sketch (Karnin, Lang, Liberty 2016). Values are kept in a
+/// hierarchy of buffers, the buffer on level 'h' holds values that represent
+/// \c 2^h original values each. A full buffer is sorted and every other value
+/// is promoted to the next level. Only \c O(k) values are retained, no matter
+/// how many were inserted.
+///
+/// The rank of a value is estimated with an error of at most 1.65% of the
+/// number of inserted values with 99% confidence for the default \c k, the
+/// error shrinks roughly with \c 1/k. If less than \c k values were
+/// inserted, no value is discarded and the quantiles are exact.
+/// \note the random decisions while compacting use a fixed seed, the same
+/// sequence of insertions and merges results in the same sketch.
+class quantile_sketch {
+  public:
+    /// Accuracy parameter of the sketch that retains roughly \c 3 * k values.
+    static constexpr int default_k = 200;
+
+    /// \pre k >= 8
+    explicit quantile_sketch(int k = default_k);
+
+    void insert(float value) {
+        _levels.front().push_back(value);
+        ++_count;
+        if (++_retained > _capacity)
+            compress();
+    }
+    void insert(gsl::span<const float> values) {
+        for (float v : values)
+            insert(v);
+    }
+
+    /// Combine the values of \p other into this sketch. The error bound holds
+    /// for the merged sketch with the accuracy parameter of this sketch.
+    void merge(const quantile_sketch& other);
+
+    /// Number of inserted values.
+    [[nodiscard]] std::size_t count() const noexcept { return _count; }
+    [[nodiscard]] bool        empty() const noexcept { return _count == 0UL; }
+    /// Number of values that are stored in the sketch.
+    [[nodiscard]] std::size_t retained() const noexcept { return _retained; }
+
+    /// Estimate the value with \p rank values before it in sorted order, e.g.
+    /// the element at position \p rank of the sorted input.
+    /// \pre !empty()
+    /// \pre rank < count()
+    [[nodiscard]] float at_rank(std::size_t rank) const;
+    /// Estimate the \p q quantile, this is the value at rank
+    /// \c floor(q * count()).
+    /// \pre !empty()
+    /// \pre 0.0 <= q <= 1.0
+    [[nodiscard]] float quantile(double q) const;
+
+    /// The retained values with the number of original values they represent,
+    /// ordered by value. The weights sum up to \c count().
+    [[nodiscard]] std::vector<std::pair<float, std::uint64_t>>
+    weighted_values() const;
+
+  private:
+    /// Compact the lowest levels that exceed their capacity until the sketch
+    /// fits into its capacity again.
+    void compress();
+    /// Sort the values on \p level and promote every other one.
+    void compact(std::size_t level);
+    /// Capacity of the buffer on \p level, lower levels are smaller.
+    [[nodiscard]] std::size_t level_capacity(std::size_t level) const noexcept;
+    void                      update_capacity() noexcept;
+
+    int                             _k;
+    std::size_t                     _count    = 0UL;
+    std::size_t                     _retained = 0UL;
+    std::size_t                     _capacity = 0UL;
+    /// Level 'h' holds values with the weight \c 2^h, there is always at
+    /// least one level.
+    std::vector<std::vector<float>> _levels;
+    std::uint64_t                   _random_state;
+};
+
+}  // namespace sens_loc::analysis
+
+#endif /* end of include guard: QUANTILE_SKETCH_H_T8WZ4NQE */
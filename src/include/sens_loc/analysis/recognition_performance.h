@@ -124,9 +124,19 @@ struct category_statistic {
 class recognition_statistic {
   public:
     recognition_statistic() = default;
+    /// \param exact_distances store all descriptor distances for exact
+    /// statistics instead of sketching them
+    /// \sa distance_accumulator
+    explicit recognition_statistic(bool exact_distances) noexcept
+        : tp_distance{exact_distances}
+        , fp_distance{exact_distances} {}
 
     /// Track true/false negative/positive for each image.
     void account(const element_categories& classification) noexcept;
+    /// Add the images that were accounted in \p other, e.g. by another
+    /// thread. The images of \p other are appended in their order.
+    /// \pre both store the descriptor distances in the same mode
+    void merge(const recognition_statistic& other);
 
     /// Number \f$P\f$ of all keypoints that have a corresponding keypoint in
     /// another frame.
@@ -290,8 +300,8 @@ class recognition_statistic {
     // Keep track of the true/false-positive descriptor distances.
     // This gives some insight into what distance is expected for good matches
     // and where to draw the border.
-    std::vector<float> tp_distance;
-    std::vector<float> fp_distance;
+    distance_accumulator tp_distance{/*exact=*/false};
+    distance_accumulator fp_distance{/*exact=*/false};
 
     // Keep track of the global count of elements.
     std::int64_t n_true_pos  = 0L;
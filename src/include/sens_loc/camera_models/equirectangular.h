@@ -6,6 +6,7 @@
 #include <sens_loc/camera_models/concepts.h>
 #include <sens_loc/math/constants.h>
 #include <sens_loc/math/coordinate.h>
+#include <sens_loc/math/pointcloud.h>
 #include <sens_loc/math/scaling.h>
 #include <stdexcept>
 #include <type_traits>
@@ -133,6 +134,19 @@ class equirectangular {
     [[nodiscard]] math::pixel_coord<_Real>
     camera_to_pixel(const math::camera_coord<Real>& p) const noexcept;
 
+    /// Backproject all \p pixels to the unit sphere at once.
+    /// \returns the light ray of pixel 'i' in column 'i'
+    /// \sa equirectangular::pixel_to_sphere
+    [[nodiscard]] math::pointcloud_soa<Real>
+    pixel_to_sphere(const math::imagepoints_soa<Real>& pixels) const noexcept;
+
+    /// Project all \p points to pixel coordinates at once.
+    /// \note points that can not be projected get the pixel coordinate
+    /// {-1, -1}, like for a single point.
+    /// \sa equirectangular::camera_to_pixel
+    [[nodiscard]] math::imagepoints_soa<Real>
+    camera_to_pixel(const math::pointcloud_soa<Real>& points) const noexcept;
+
   private:
     void ensure_invariant() const noexcept {
         Ensures(d_phi > Real(0.));
@@ -209,6 +223,40 @@ equirectangular<Real>::camera_to_pixel(const math::camera_coord<Real>& p) const
 
     return {u, v};
 }
+
+template <typename Real>
+math::pointcloud_soa<Real> equirectangular<Real>::pixel_to_sphere(
+    const math::imagepoints_soa<Real>& pixels) const noexcept {
+    Expects((pixels.array() >= Real(0.0)).all());
+    Expects((pixels.row(0).array() < Real(w())).all());
+    Expects((pixels.row(1).array() < Real(h())).all());
+
+    using row_t           = Eigen::Array<Real, 1, Eigen::Dynamic>;
+    const row_t phi       = pixels.row(0).array() * d_phi - math::pi<Real>;
+    const row_t theta     = theta_min + pixels.row(1).array() * d_theta;
+    const row_t sin_theta = theta.sin();
+
+    math::pointcloud_soa<Real> res(3, pixels.cols());
+    res.row(0).array() = sin_theta * phi.cos();
+    res.row(1).array() = sin_theta * phi.sin();
+    res.row(2).array() = theta.cos();
+    return res;
+}
+
+template <typename Real>
+math::imagepoints_soa<Real> equirectangular<Real>::camera_to_pixel(
+    const math::pointcloud_soa<Real>& points) const noexcept {
+    // 'atan2' is not vectorized by Eigen, the points are projected one by
+    // one, but without converting the layout of the whole cloud.
+    math::imagepoints_soa<Real> res(2, points.cols());
+    for (Eigen::Index i = 0; i < points.cols(); ++i) {
+        const math::pixel_coord<Real> px = camera_to_pixel(
+            math::camera_coord<Real>{points(0, i), points(1, i), points(2, i)});
+        res(0, i) = px.u();
+        res(1, i) = px.v();
+    }
+    return res;
+}
 }  // namespace sens_loc::camera_models
 
 #endif /* end of include guard: LASER_SCANNER_H_WSZJIY40 */
@@ -6,6 +6,7 @@
 #include <sens_loc/camera_models/concepts.h>
 #include <sens_loc/math/constants.h>
 #include <sens_loc/math/coordinate.h>
+#include <sens_loc/math/pointcloud.h>
 #include <type_traits>
 
 namespace sens_loc {
@@ -101,6 +102,20 @@ class pinhole {
     [[nodiscard]] math::pixel_coord<_Real>
     camera_to_pixel(const math::camera_coord<Real>& p) const noexcept;
 
+    /// Backproject all \p pixels to the unit sphere at once.
+    /// \pre the same as for a single pixel
+    /// \returns the light ray of pixel 'i' in column 'i'
+    /// \sa pinhole::pixel_to_sphere
+    [[nodiscard]] math::pointcloud_soa<Real>
+    pixel_to_sphere(const math::imagepoints_soa<Real>& pixels) const noexcept;
+
+    /// Project all \p points to pixel coordinates at once.
+    /// \note points that can not be projected get the pixel coordinate
+    /// {-1, -1}, like for a single point.
+    /// \sa pinhole::camera_to_pixel
+    [[nodiscard]] math::imagepoints_soa<Real>
+    camera_to_pixel(const math::pointcloud_soa<Real>& points) const noexcept;
+
   private:
     int  _w  = 0;    ///< width of the image
     int  _h  = 0;    ///< height of the image
@@ -198,6 +213,71 @@ pinhole<Real>::camera_to_pixel(const math::camera_coord<Real>& p) const
 
     return {u, v};
 }
+
+template <typename Real>
+math::pointcloud_soa<Real>
+pinhole<Real>::pixel_to_sphere(const math::imagepoints_soa<Real>& pixels) const
+    noexcept {
+    Expects(_fx > 0.);
+    Expects(_fy > 0.);
+    Expects(_cx > 0.);
+    Expects(_cy > 0.);
+    Expects(p1 == 0. && p2 == 0.);
+    Expects(k1 == 0. && k2 == 0. && k3 == 0.);
+    Expects((pixels.array() >= Real(0.)).all());
+    Expects((pixels.row(0).array() < Real(w())).all());
+    Expects((pixels.row(1).array() < Real(h())).all());
+
+    using row_t        = Eigen::Array<Real, 1, Eigen::Dynamic>;
+    const row_t x      = (pixels.row(0).array() - _cx) / _fx;
+    const row_t y      = (pixels.row(1).array() - _cy) / _fy;
+    const row_t factor = Real(1.) / (Real(1.) + x.square() + y.square()).sqrt();
+
+    math::pointcloud_soa<Real> res(3, pixels.cols());
+    res.row(0).array() = factor * x;
+    res.row(1).array() = factor * y;
+    res.row(2).array() = factor;
+    return res;
+}
+
+template <typename Real>
+math::imagepoints_soa<Real>
+pinhole<Real>::camera_to_pixel(const math::pointcloud_soa<Real>& points) const
+    noexcept {
+    Expects(fx() > 0.);
+    Expects(fy() > 0.);
+    Expects(cx() > 0.);
+    Expects(cy() > 0.);
+    Expects(p1 == 0. && p2 == 0.);
+    Expects(k1 == 0. && k2 == 0. && k3 == 0.);
+
+    const Real* X      = points.row(0).data();
+    const Real* Y      = points.row(1).data();
+    const Real* Z      = points.row(2).data();
+    const Real  f_x    = fx();
+    const Real  f_y    = fy();
+    const Real  c_x    = cx();
+    const Real  c_y    = cy();
+    const auto  width  = gsl::narrow_cast<Real>(w());
+    const auto  height = gsl::narrow_cast<Real>(h());
+
+    math::imagepoints_soa<Real> res(2, points.cols());
+    Real*                       u = res.row(0).data();
+    Real*                       v = res.row(1).data();
+
+    // Eigen does not vectorize comparisons and selections. This loop has no
+    // branches and is vectorized by the compiler instead. The parameters are
+    // copied, as the stores to the result could alias the members otherwise.
+    for (Eigen::Index i = 0; i < points.cols(); ++i) {
+        const Real pu    = f_x * (X[i] / Z[i]) + c_x;
+        const Real pv    = f_y * (Y[i] / Z[i]) + c_y;
+        const bool valid = (Z[i] != Real(0.0)) & (pu >= Real(0.0)) &
+                           (pu <= width) & (pv >= Real(0.0)) & (pv <= height);
+        u[i] = valid ? pu : Real(-1);
+        v[i] = valid ? pv : Real(-1);
+    }
+    return res;
+}
 }  // namespace camera_models
 }  // namespace sens_loc
 
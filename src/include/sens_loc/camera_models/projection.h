@@ -42,6 +42,25 @@ project_to_image(const Model<Real>&            intrinsic,
     return pixel_coord;
 }
 
+/// Project the pointcloud \c points to pixel coordinates, all points at once.
+///
+/// The structure of arrays layout allows the camera model to vectorize the
+/// projection.
+/// \post pixel 'i' in column 'i' is the projection of point 'i'
+/// \post elements that are not in the image are {-1.0F, -1.0F}
+/// \sa project_to_image
+template <template <typename> typename Model = pinhole, typename Real = float>
+math::imagepoints_soa<Real>
+project_to_image(const Model<Real>&                intrinsic,
+                 const math::pointcloud_soa<Real>& points) noexcept {
+    static_assert(is_intrinsic_v<Model, Real>);
+
+    math::imagepoints_soa<Real> pixel_coord = intrinsic.camera_to_pixel(points);
+
+    Ensures(pixel_coord.cols() == points.cols());
+    return pixel_coord;
+}
+
 /// Project \c pixel coordinates to the unit-sphere.
 //
 /// \tparam Model camera model implement with arbitrary precision
@@ -69,6 +88,21 @@ project_to_sphere(const Model<Real>&             intrinsic,
     return sphere_coord;
 }
 
+/// Project \c pixel coordinates to the unit-sphere, all pixels at once.
+/// \post the light ray of pixel 'i' is in column 'i'
+/// \sa project_to_sphere
+template <template <typename> typename Model = pinhole, typename Real = float>
+math::pointcloud_soa<Real>
+project_to_sphere(const Model<Real>&                 intrinsic,
+                  const math::imagepoints_soa<Real>& pixel) noexcept {
+    static_assert(is_intrinsic_v<Model, Real>);
+
+    math::pointcloud_soa<Real> sphere_coord = intrinsic.pixel_to_sphere(pixel);
+
+    Ensures(sphere_coord.cols() == pixel.cols());
+    return sphere_coord;
+}
+
 /// Convert keypoints to pixel coordinates.
 template <typename Real = float>
 math::imagepoints<Real>
@@ -0,0 +1,101 @@
+#ifndef RAY_TABLE_H_QK4TZW7N
+#define RAY_TABLE_H_QK4TZW7N
+
+#include <gsl/gsl>
+#include <sens_loc/camera_models/concepts.h>
+#include <sens_loc/math/coordinate.h>
+#include <type_traits>
+#include <vector>
+
+namespace sens_loc::camera_models {
+
+/// Precomputed backprojection of every pixel of a sensor onto the unit sphere.
+///
+/// The conversion functions call \c Intrinsic::pixel_to_sphere multiple times
+/// per pixel. For sequences with a fixed calibration these lightrays never
+/// change, so they can be calculated once and looked up afterwards.
+/// The coordinates are stored as structure of arrays (one plane for each of
+/// \f$X_s, Y_s, Z_s\f$) to allow vectorized access along image rows.
+///
+/// \tparam Real precision of the lightrays, floating-point
+/// \sa camera_models::is_intrinsic_v
+template <typename Real = float>
+class ray_table {
+  public:
+    static_assert(std::is_floating_point_v<Real>);
+
+    using real_type = Real;
+
+    ray_table() = default;
+
+    /// Backproject each pixel of the sensor described by \p intrinsic.
+    /// \post \c w() == \p intrinsic.w() && \c h() == \p intrinsic.h()
+    template <template <typename> typename Intrinsic>
+    explicit ray_table(const Intrinsic<Real>& intrinsic)
+        : _w{intrinsic.w()}
+        , _h{intrinsic.h()} {
+        static_assert(is_intrinsic_v<Intrinsic, Real>);
+        Expects(_w > 0);
+        Expects(_h > 0);
+
+        const auto n = gsl::narrow<std::size_t>(_w) * _h;
+        _xs.resize(n);
+        _ys.resize(n);
+        _zs.resize(n);
+
+        for (int v = 0; v < _h; ++v) {
+            for (int u = 0; u < _w; ++u) {
+                const math::sphere_coord<Real> s =
+                    intrinsic.pixel_to_sphere(math::pixel_coord<int>(u, v));
+                const std::size_t i = index(u, v);
+                _xs[i]              = s.Xs();
+                _ys[i]              = s.Ys();
+                _zs[i]              = s.Zs();
+            }
+        }
+
+        Ensures(_xs.size() == n);
+        Ensures(_ys.size() == n);
+        Ensures(_zs.size() == n);
+    }
+
+    [[nodiscard]] int w() const noexcept { return _w; }
+    [[nodiscard]] int h() const noexcept { return _h; }
+
+    /// Lookup of the lightray for pixel \p p.
+    /// \pre \p p is within the image
+    [[nodiscard]] math::sphere_coord<Real>
+    operator()(const math::pixel_coord<int>& p) const noexcept {
+        Expects(p.u() >= 0 && p.u() < _w);
+        Expects(p.v() >= 0 && p.v() < _h);
+        const std::size_t i = index(p.u(), p.v());
+        return math::sphere_coord<Real>(_xs[i], _ys[i], _zs[i]);
+    }
+
+    /// Pointer to the first element of row \p v for each coordinate plane.
+    /// Consecutive pixels in a row are stored consecutively.
+    /// \pre 0 <= \p v < \c h()
+    [[nodiscard]] const Real* Xs(int v) const noexcept { return row(_xs, v); }
+    [[nodiscard]] const Real* Ys(int v) const noexcept { return row(_ys, v); }
+    [[nodiscard]] const Real* Zs(int v) const noexcept { return row(_zs, v); }
+
+  private:
+    [[nodiscard]] std::size_t index(int u, int v) const noexcept {
+        return gsl::narrow_cast<std::size_t>(v) * _w + u;
+    }
+    [[nodiscard]] const Real* row(const std::vector<Real>& plane, int v) const
+        noexcept {
+        Expects(v >= 0 && v < _h);
+        return plane.data() + index(0, v);
+    }
+
+    int               _w = 0;
+    int               _h = 0;
+    std::vector<Real> _xs;
+    std::vector<Real> _ys;
+    std::vector<Real> _zs;
+};
+
+}  // namespace sens_loc::camera_models
+
+#endif /* end of include guard: RAY_TABLE_H_QK4TZW7N */
@@ -0,0 +1,167 @@
+#ifndef CONVERSION_PLAN_H_VL3M0DKE
+#define CONVERSION_PLAN_H_VL3M0DKE
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <gsl/gsl>
+#include <sens_loc/camera_models/concepts.h>
+#include <sens_loc/conversion/depth_to_bearing.h>
+#include <sens_loc/conversion/depth_to_flexion.h>
+#include <sens_loc/conversion/depth_to_flexion_angle.h>
+#include <sens_loc/conversion/depth_to_flexion_normalized.h>
+#include <sens_loc/conversion/depth_to_flexion_nxn.h>
+#include <sens_loc/conversion/util.h>
+#include <sens_loc/math/image.h>
+#include <taskflow/taskflow.hpp>
+
+namespace sens_loc::conversion {
+
+/// Prebuilt taskgraph for a fixed set of conversions of range images with
+/// a fixed resolution and calibration.
+///
+/// The \c par_depth_to_* functions add their tasks to a taskflow on every
+/// call. For a stream of images with the same resolution the shape of that
+/// graph never changes. This class builds the graph once and only rebinds
+/// the input and output images for each frame. Processing a frame is then
+/// a single \c run on an executor.
+///
+/// \code
+/// conversion_plan<camera_models::pinhole> plan(intrinsic);
+/// const std::size_t flexion = plan.add_flexion();
+/// const std::size_t bearing = plan.add_bearing<direction::horizontal>();
+///
+/// for (const math::image<float>& range_image : frames) {
+///     plan.bind_input(range_image);
+///     plan.run(executor).wait();
+///     use(plan.output(flexion), plan.output(bearing));
+/// }
+/// \endcode
+///
+/// Binding an image only copies the \c cv::Mat header, the pixel data is
+/// shared. Results are written into the memory of the bound output images.
+///
+/// \tparam Intrinsic camera model that projects pixel to the unit sphere
+/// \tparam Real precision of the calculation, floating-point
+/// \note The tasks reference the members of the plan, which is why it can
+/// neither be copied nor moved.
+/// \note One plan must not run concurrently with itself.
+template <template <typename> typename Intrinsic, typename Real = float>
+class conversion_plan {
+  public:
+    static_assert(camera_models::is_intrinsic_v<Intrinsic, Real>);
+    static_assert(std::is_floating_point_v<Real>);
+
+    /// Create an empty plan for images taken with \p intrinsic.
+    explicit conversion_plan(const Intrinsic<Real>& intrinsic)
+        : _intrinsic{intrinsic}
+        , _input{make_blank()} {}
+
+    conversion_plan(const conversion_plan&) = delete;
+    conversion_plan(conversion_plan&&)      = delete;
+    conversion_plan& operator=(const conversion_plan&) = delete;
+    conversion_plan& operator=(conversion_plan&&) = delete;
+    ~conversion_plan()                            = default;
+
+    [[nodiscard]] int w() const noexcept { return _intrinsic.w(); }
+    [[nodiscard]] int h() const noexcept { return _intrinsic.h(); }
+
+    /// Number of registered conversions.
+    [[nodiscard]] std::size_t size() const noexcept { return _outputs.size(); }
+
+    /// Register conversions in the plan. Each call adds the tasks for one
+    /// converter and allocates an output image for it.
+    /// \returns handle to access the result with \c output
+    /// \sa depth_to_flexion
+    std::size_t add_flexion() {
+        math::image<Real>& out = add_output();
+        par_depth_to_flexion(_input, _intrinsic, out, _flow);
+        return size() - 1UL;
+    }
+    /// \sa depth_to_flexion_normalized
+    std::size_t add_flexion_normalized() {
+        math::image<Real>& out = add_output();
+        par_depth_to_flexion_normalized(_input, _intrinsic, out, _flow);
+        return size() - 1UL;
+    }
+    /// \sa depth_to_flexion_angle
+    std::size_t add_flexion_angle() {
+        math::image<Real>& out = add_output();
+        par_depth_to_flexion_angle(_input, _intrinsic, out, _flow);
+        return size() - 1UL;
+    }
+    /// \sa depth_to_flexion_nxn
+    std::size_t add_flexion_nxn(int neighbors) {
+        // The tasks keep a reference to the parameter.
+        const int&         n   = _parameters.emplace_back(neighbors);
+        math::image<Real>& out = add_output();
+        par_depth_to_flexion_nxn(_input, _intrinsic, n, out, _flow);
+        return size() - 1UL;
+    }
+    /// \sa depth_to_bearing
+    template <direction Direction>
+    std::size_t add_bearing() {
+        math::image<Real>& out = add_output();
+        par_depth_to_bearing<Direction>(_input, _intrinsic, out, _flow);
+        return size() - 1UL;
+    }
+
+    /// Use \p range_image as input for the next \c run.
+    /// \pre dimensions of \p range_image match the calibration
+    void bind_input(const math::image<Real>& range_image) noexcept {
+        Expects(range_image.w() == w());
+        Expects(range_image.h() == h());
+        _input = range_image;
+    }
+
+    /// Write the result of conversion \p id into \p out for the next \c run.
+    /// Without binding, the plan writes into its own buffers.
+    /// \pre \p id was returned by one of the \c add_* methods
+    /// \pre dimensions of \p out match the calibration
+    /// \pre the border pixels of \p out are zero, as they are not written
+    /// by the converters
+    void bind_output(std::size_t id, math::image<Real>& out) noexcept {
+        Expects(id < size());
+        Expects(out.w() == w());
+        Expects(out.h() == h());
+        _outputs[id] = out;
+    }
+
+    /// Access the result of conversion \p id.
+    /// \pre \p id was returned by one of the \c add_* methods
+    [[nodiscard]] const math::image<Real>& output(std::size_t id) const
+        noexcept {
+        Expects(id < size());
+        return _outputs[id];
+    }
+
+    /// Execute all registered conversions on the bound images.
+    std::future<void> run(tf::Executor& executor) {
+        return executor.run(_flow);
+    }
+
+    /// Access to the prebuilt graph, e.g. to compose it into a bigger graph
+    /// with \c tf::FlowBuilder::composed_of.
+    [[nodiscard]] tf::Taskflow& taskflow() noexcept { return _flow; }
+
+  private:
+    [[nodiscard]] math::image<Real> make_blank() const {
+        cv::Mat blank(h(), w(), math::detail::get_opencv_type<Real>());
+        blank = Real(0.);
+        return math::image<Real>(std::move(blank));
+    }
+
+    math::image<Real>& add_output() { return _outputs.emplace_back(make_blank()); }
+
+    const Intrinsic<Real> _intrinsic;
+    math::image<Real>     _input;
+    /// 'std::deque' does not invalidate references to its elements when
+    /// elements are appended. The tasks refer to these elements.
+    std::deque<math::image<Real>> _outputs;
+    std::deque<int>               _parameters;
+    tf::Taskflow                  _flow;
+};
+
+}  // namespace sens_loc::conversion
+
+#endif /* end of include guard: CONVERSION_PLAN_H_VL3M0DKE */
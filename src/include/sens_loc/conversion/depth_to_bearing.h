@@ -58,7 +58,7 @@ math::image<Real> depth_to_bearing(const math::image<Real>& depth_image,
 /// \param[out] ba_image result image that will be created with parallel
 /// processing
 /// \param[inout] flow parallel flow type that is used to parallelize the outer
-/// for loop over all rows.
+/// for loop over all rows. Either a \c tf::Taskflow or a \c tf::Subflow.
 /// \returns synchronization points before and after the calculation of the
 /// bearing angle image.
 /// \sa depth_to_bearing
@@ -70,7 +70,7 @@ std::pair<tf::Task, tf::Task>
 par_depth_to_bearing(const math::image<Real>& depth_image,
                      const Intrinsic<Real>&   intrinsic,
                      math::image<Real>&       ba_image,
-                     tf::Taskflow&            flow) noexcept;
+                     tf::FlowBuilder&         flow) noexcept;
 
 /// Convert a bearing angle image to an image with integer types.
 /// This function scales the bearing angles between
@@ -255,7 +255,7 @@ inline std::pair<tf::Task, tf::Task>
 par_depth_to_bearing(const math::image<Real>& depth_image,
                      const Intrinsic<Real>&   intrinsic,
                      math::image<Real>&       ba_image,
-                     tf::Taskflow&            flow) noexcept {
+                     tf::FlowBuilder&         flow) noexcept {
     static_assert(camera_models::is_intrinsic_v<Intrinsic, Real>);
     static_assert(std::is_floating_point_v<Real>);
 
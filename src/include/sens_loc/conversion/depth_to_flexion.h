@@ -39,7 +39,8 @@ math::image<Real> depth_to_flexion(const math::image<Real>& depth_image,
 /// \sa depth_to_flexion
 /// \param[in] depth_image,intrinsic same as in \p depth_to_flexion
 /// \param[out] flexion_image output image
-/// \param[inout] flow taskgraph the calculations will be registered in
+/// \param[inout] flow taskgraph the calculations will be registered in, this
+/// can be a \c tf::Subflow to nest the conversion in other parallel work
 /// \returns synchronization task before and after the calculation
 /// \note the calculation does not happen instantly but first a taskgraph is
 /// \pre \p flexion_image has the same dimension as \p depth_image
@@ -50,7 +51,7 @@ std::pair<tf::Task, tf::Task>
 par_depth_to_flexion(const math::image<Real>& depth_image,
                      const Intrinsic<Real>&   intrinsic,
                      math::image<Real>&       flexion_image,
-                     tf::Taskflow&            flow) noexcept;
+                     tf::FlowBuilder&         flow) noexcept;
 
 /// Scale the flexion image to \p PixelType for normal image visualization.
 ///
@@ -172,7 +173,7 @@ inline std::pair<tf::Task, tf::Task>
 par_depth_to_flexion(const math::image<Real>& depth_image,
                      const Intrinsic<Real>&   intrinsic,
                      math::image<Real>&       flexion_image,
-                     tf::Taskflow&            flow) noexcept {
+                     tf::FlowBuilder&         flow) noexcept {
     static_assert(camera_models::is_intrinsic_v<Intrinsic, Real>);
     static_assert(std::is_floating_point_v<Real>);
 
@@ -50,7 +50,7 @@ std::pair<tf::Task, tf::Task>
 par_depth_to_flexion_angle(const math::image<Real>& depth_image,
                            const Intrinsic<Real>&   intrinsic,
                            math::image<Real>&       flexion_image,
-                           tf::Taskflow&            flow) noexcept;
+                           tf::FlowBuilder&         flow) noexcept;
 
 
 namespace detail {
@@ -162,7 +162,7 @@ inline std::pair<tf::Task, tf::Task>
 par_depth_to_flexion_angle(const math::image<Real>& depth_image,
                            const Intrinsic<Real>&   intrinsic,
                            math::image<Real>&       flexion_image,
-                           tf::Taskflow&            flow) noexcept {
+                           tf::FlowBuilder&         flow) noexcept {
     static_assert(camera_models::is_intrinsic_v<Intrinsic, Real>);
     static_assert(std::is_floating_point_v<Real>);
 
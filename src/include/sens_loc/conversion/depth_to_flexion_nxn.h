@@ -54,7 +54,7 @@ par_depth_to_flexion_nxn(const math::image<Real>& depth_image,
                          const Intrinsic<Real>&   intrinsic,
                          const int&               neighbors,
                          math::image<Real>&       flexion_image,
-                         tf::Taskflow&            flow) noexcept;
+                         tf::FlowBuilder&         flow) noexcept;
 
 
 namespace detail {
@@ -159,7 +159,7 @@ par_depth_to_flexion_nxn(const math::image<Real>& depth_image,
                          const Intrinsic<Real>&   intrinsic,
                          const int&               neighbors,
                          math::image<Real>&       flexion_image,
-                         tf::Taskflow&            flow) noexcept {
+                         tf::FlowBuilder&         flow) noexcept {
     static_assert(camera_models::is_intrinsic_v<Intrinsic, Real>);
     static_assert(std::is_floating_point_v<Real>);
 
@@ -44,7 +44,7 @@ std::pair<tf::Task, tf::Task>
 par_depth_to_laserscan(const math::image<PixelType>& depth_image,
                        const Intrinsic<Real>&        intrinsic,
                        math::image<Real>&            out,
-                       tf::Taskflow&                 flow) noexcept;
+                       tf::FlowBuilder&              flow) noexcept;
 
 namespace detail {
 template <typename Real,
@@ -101,7 +101,7 @@ inline std::pair<tf::Task, tf::Task>
 par_depth_to_laserscan(const math::image<PixelType>& depth_image,
                        const Intrinsic<Real>&        intrinsic,
                        math::image<Real>&            out,
-                       tf::Taskflow&                 flow) noexcept {
+                       tf::FlowBuilder&              flow) noexcept {
     static_assert(camera_models::is_intrinsic_v<Intrinsic, Real>);
     static_assert(std::is_floating_point_v<Real>);
     static_assert(std::is_arithmetic_v<PixelType>);
@@ -0,0 +1,407 @@
+#ifndef SPARSE_CONVERSION_H_R8WNUE2C
+#define SPARSE_CONVERSION_H_R8WNUE2C
+
+#include <algorithm>
+#include <cmath>
+#include <gsl/gsl>
+#include <limits>
+#include <numeric>
+#include <opencv2/core/types.hpp>
+#include <sens_loc/camera_models/ray_table.h>
+#include <sens_loc/conversion/depth_to_bearing.h>
+#include <sens_loc/conversion/util.h>
+#include <sens_loc/math/constants.h>
+#include <sens_loc/math/coordinate.h>
+#include <sens_loc/math/image.h>
+#include <sens_loc/math/triangles.h>
+#include <vector>
+
+namespace sens_loc::conversion {
+
+/// Calculate the flexion only at the pixels \p points.
+///
+/// The result is the same value \c depth_to_flexion would produce at each
+/// pixel, but without converting the whole image. This is useful if only the
+/// neighbourhood of keypoints is of interest.
+/// Queries within the same row and with neighbouring columns are batched
+/// together and evaluated in one vectorizable pass.
+///
+/// \tparam Real precision of the calculation, floating-point
+/// \param depth_image range image
+/// \param rays precomputed lightrays of the sensor that took the image
+/// \param points pixels to evaluate, can be in any order and contain
+/// duplicates
+/// \returns flexion value for each query in the order of \p points. Pixels at
+/// the image border or outside of the image result in 0.
+/// \pre dimensions of \p depth_image and \p rays match
+/// \sa conversion::depth_to_flexion
+/// \sa camera_models::ray_table
+template <typename Real = float>
+std::vector<Real>
+sparse_flexion(const math::image<Real>&               depth_image,
+               const camera_models::ray_table<Real>&  rays,
+               gsl::span<const math::pixel_coord<int>> points) noexcept;
+
+/// Calculate the flexion image for a patch of \p depth_image.
+///
+/// \returns image with the dimension of \p patch, equivalent to
+/// \c depth_to_flexion(depth_image, intrinsic)(patch). Parts of the patch
+/// that are outside of \p depth_image are 0.
+/// \pre dimensions of \p depth_image and \p rays match
+/// \pre \p patch is not empty
+template <typename Real = float>
+math::image<Real>
+sparse_flexion(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               const cv::Rect&                       patch) noexcept;
+
+/// Calculate the flexion image for multiple patches of \p depth_image.
+/// \sa sparse_flexion
+template <typename Real = float>
+std::vector<math::image<Real>>
+sparse_flexion(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               gsl::span<const cv::Rect>             patches) noexcept;
+
+/// Calculate the bearing angle in \p Direction only at the pixels \p points.
+/// \returns bearing angle for each query in the order of \p points. Pixels
+/// without a prior pixel or outside of the image result in 0.
+/// \sa conversion::depth_to_bearing
+/// \sa sparse_flexion
+template <direction Direction, typename Real = float>
+std::vector<Real>
+sparse_bearing(const math::image<Real>&               depth_image,
+               const camera_models::ray_table<Real>&  rays,
+               gsl::span<const math::pixel_coord<int>> points) noexcept;
+
+/// Calculate the bearing angle image in \p Direction for a patch of
+/// \p depth_image.
+/// \sa sparse_flexion
+template <direction Direction, typename Real = float>
+math::image<Real>
+sparse_bearing(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               const cv::Rect&                       patch) noexcept;
+
+/// Calculate the bearing angle images in \p Direction for multiple patches.
+/// \sa sparse_flexion
+template <direction Direction, typename Real = float>
+std::vector<math::image<Real>>
+sparse_bearing(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               gsl::span<const cv::Rect>             patches) noexcept;
+
+namespace detail {
+
+/// Plain 3D-vector used within the sparse kernels. It avoids the
+/// strong typing of \c math::coordinate to keep the innermost loops simple
+/// enough for auto-vectorization.
+template <typename Real>
+struct vec3 {
+    Real x;
+    Real y;
+    Real z;
+};
+
+template <typename Real>
+inline vec3<Real> backproject(const Real* d,
+                              const Real* xs,
+                              const Real* ys,
+                              const Real* zs,
+                              int         u) noexcept {
+    return {d[u] * xs[u], d[u] * ys[u], d[u] * zs[u]};
+}
+
+template <typename Real>
+inline vec3<Real> operator-(const vec3<Real>& a, const vec3<Real>& b) noexcept {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+/// Same semantic as \c Eigen::normalized(), the null vector stays null.
+template <typename Real>
+inline vec3<Real> normalized(const vec3<Real>& a) noexcept {
+    const Real n = a.x * a.x + a.y * a.y + a.z * a.z;
+    const Real l = n > Real(0.) ? std::sqrt(n) : Real(1.);
+    return {a.x / l, a.y / l, a.z / l};
+}
+
+template <typename Real>
+inline vec3<Real> cross(const vec3<Real>& a, const vec3<Real>& b) noexcept {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x};
+}
+
+template <typename Real>
+inline Real dot(const vec3<Real>& a, const vec3<Real>& b) noexcept {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/// Calculate the flexion for the pixels [u_begin, u_end) in row \p v and
+/// store them consecutively in \p out.
+template <typename Real>
+inline void flexion_span(const math::image<Real>&              depth_image,
+                         const camera_models::ray_table<Real>& rays,
+                         int                                   v,
+                         int                                   u_begin,
+                         int                                   u_end,
+                         Real*                                 out) noexcept {
+    Expects(u_begin <= u_end);
+    std::fill(out, out + (u_end - u_begin), Real(0.));
+
+    // The border has no full neighbourhood and is 0 in the dense conversion.
+    if (v < 1 || v >= depth_image.h() - 1)
+        return;
+    const int first = std::max(u_begin, 1);
+    const int last  = std::min(u_end, depth_image.w() - 1);
+
+    const cv::Mat& d   = depth_image.data();
+    const Real*    d_t = d.ptr<Real>(v - 1);
+    const Real*    d_c = d.ptr<Real>(v);
+    const Real*    d_b = d.ptr<Real>(v + 1);
+
+    const Real *x_t = rays.Xs(v - 1), *y_t = rays.Ys(v - 1),
+               *z_t = rays.Zs(v - 1);
+    const Real *x_c = rays.Xs(v), *y_c = rays.Ys(v), *z_c = rays.Zs(v);
+    const Real *x_b = rays.Xs(v + 1), *y_b = rays.Ys(v + 1),
+               *z_b = rays.Zs(v + 1);
+
+    for (int u = first; u < last; ++u) {
+        // Same neighbourhood and directions as in 'detail::flexion_inner'.
+        const vec3<Real> dir0 = backproject(d_b, x_b, y_b, z_b, u) -
+                                backproject(d_t, x_t, y_t, z_t, u);
+        const vec3<Real> dir1 = backproject(d_c, x_c, y_c, z_c, u + 1) -
+                                backproject(d_c, x_c, y_c, z_c, u - 1);
+        const vec3<Real> dir2 = backproject(d_b, x_b, y_b, z_b, u - 1) -
+                                backproject(d_t, x_t, y_t, z_t, u + 1);
+        const vec3<Real> dir3 = backproject(d_b, x_b, y_b, z_b, u + 1) -
+                                backproject(d_t, x_t, y_t, z_t, u - 1);
+
+        const vec3<Real> cross0 = cross(normalized(dir0), normalized(dir1));
+        const vec3<Real> cross1 = cross(normalized(dir2), normalized(dir3));
+
+        out[u - u_begin] =
+            std::clamp(std::abs(dot(cross0, cross1)), Real(0.), Real(1.));
+    }
+}
+
+/// Calculate the bearing angle for the pixels [u_begin, u_end) in row \p v
+/// and store them consecutively in \p out.
+template <direction Direction, typename Real>
+inline void bearing_span(const math::image<Real>&              depth_image,
+                         const camera_models::ray_table<Real>& rays,
+                         int                                   v,
+                         int                                   u_begin,
+                         int                                   u_end,
+                         Real*                                 out) noexcept {
+    Expects(u_begin <= u_end);
+    std::fill(out, out + (u_end - u_begin), Real(0.));
+
+    const pixel_range<Direction> r{depth_image.data()};
+    if (v < r.y_start || v >= r.y_end)
+        return;
+    const int first = std::max(u_begin, r.x_start);
+    const int last  = std::min(u_end, r.x_end);
+
+    const int du = get_du(Direction);
+    const int dv = get_dv(Direction);
+
+    const cv::Mat& d     = depth_image.data();
+    const Real*    d_c   = d.ptr<Real>(v);
+    const Real*    d_p   = d.ptr<Real>(v + dv);
+    const Real*    x_c   = rays.Xs(v);
+    const Real*    y_c   = rays.Ys(v);
+    const Real*    z_c   = rays.Zs(v);
+    const Real*    x_p   = rays.Xs(v + dv);
+    const Real*    y_p   = rays.Ys(v + dv);
+    const Real*    z_p   = rays.Zs(v + dv);
+    const Real     delta = Real(10.) * std::numeric_limits<Real>::epsilon();
+
+    for (int u = first; u < last; ++u) {
+        const Real d_i = d_c[u];
+        const Real d_j = d_p[u + du];
+        Expects(d_i >= Real(0.));
+        Expects(d_j >= Real(0.));
+
+        // The lightrays are unit vectors, their dot product is the cosine of
+        // the angle between them. See 'camera_models::phi'.
+        const Real cos_phi = std::clamp(x_c[u] * x_p[u + du] +
+                                            y_c[u] * y_p[u + du] +
+                                            z_c[u] * z_p[u + du],
+                                        Real(-1.) + delta, Real(1.) - delta);
+
+        // A depth==0 means there is no measurement at this pixel.
+        out[u - u_begin] = (d_i == Real(0.) || d_j == Real(0.))
+                     ? Real(0.)
+                     : math::bearing_angle<Real>(d_i, d_j, cos_phi);
+    }
+}
+
+/// Evaluate \p span_kernel for each pixel in \p points.
+/// The queries are sorted by row and column first. Runs of neighbouring
+/// pixels within a row are evaluated with one call to \p span_kernel.
+template <typename Real, typename SpanKernel>
+inline std::vector<Real>
+sparse_points(gsl::span<const math::pixel_coord<int>> points,
+              SpanKernel&&                            span_kernel) noexcept {
+    using std::size_t;
+    std::vector<Real> result(points.size(), Real(0.));
+    if (points.empty())
+        return result;
+
+    std::vector<size_t> order(points.size());
+    std::iota(std::begin(order), std::end(order), 0UL);
+    std::sort(std::begin(order), std::end(order), [&](size_t i, size_t j) {
+        const auto& p_i = points[i];
+        const auto& p_j = points[j];
+        return p_i.v() < p_j.v() || (p_i.v() == p_j.v() && p_i.u() < p_j.u());
+    });
+
+    std::vector<Real> run_values;
+    size_t            run_begin = 0UL;
+    while (run_begin < order.size()) {
+        const math::pixel_coord<int>& first = points[order[run_begin]];
+
+        size_t run_end = run_begin + 1UL;
+        int    last_u  = first.u();
+        while (run_end < order.size()) {
+            const math::pixel_coord<int>& next = points[order[run_end]];
+            if (next.v() != first.v() || next.u() > last_u + 1)
+                break;
+            last_u = next.u();
+            ++run_end;
+        }
+
+        run_values.resize(gsl::narrow_cast<size_t>(last_u - first.u() + 1));
+        span_kernel(first.v(), first.u(), last_u + 1, run_values.data());
+
+        for (size_t i = run_begin; i < run_end; ++i) {
+            const math::pixel_coord<int>& p = points[order[i]];
+            result[order[i]] = run_values[p.u() - first.u()];
+        }
+        run_begin = run_end;
+    }
+
+    Ensures(result.size() == points.size());
+    return result;
+}
+
+/// Evaluate \p span_kernel row by row for all pixels in \p patch that are
+/// within the image dimension \p w and \p h.
+template <typename Real, typename SpanKernel>
+inline math::image<Real> sparse_patch(int             w,
+                                      int             h,
+                                      const cv::Rect& patch,
+                                      SpanKernel&&    span_kernel) noexcept {
+    Expects(!patch.empty());
+
+    cv::Mat result(patch.height, patch.width,
+                   math::detail::get_opencv_type<Real>());
+    result = Real(0.);
+
+    const int u_begin = std::max(patch.x, 0);
+    const int u_end   = std::min(patch.x + patch.width, w);
+    const int v_begin = std::max(patch.y, 0);
+    const int v_end   = std::min(patch.y + patch.height, h);
+
+    for (int v = v_begin; v < v_end && u_begin < u_end; ++v)
+        span_kernel(v, u_begin, u_end,
+                    result.ptr<Real>(v - patch.y) + (u_begin - patch.x));
+
+    Ensures(result.cols == patch.width);
+    Ensures(result.rows == patch.height);
+
+    return math::image<Real>(std::move(result));
+}
+}  // namespace detail
+
+template <typename Real>
+inline std::vector<Real>
+sparse_flexion(const math::image<Real>&               depth_image,
+               const camera_models::ray_table<Real>&  rays,
+               gsl::span<const math::pixel_coord<int>> points) noexcept {
+    static_assert(std::is_floating_point_v<Real>);
+    Expects(depth_image.w() == rays.w());
+    Expects(depth_image.h() == rays.h());
+
+    return detail::sparse_points<Real>(
+        points, [&](int v, int u_begin, int u_end, Real* out) {
+            detail::flexion_span(depth_image, rays, v, u_begin, u_end, out);
+        });
+}
+
+template <typename Real>
+inline math::image<Real>
+sparse_flexion(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               const cv::Rect&                       patch) noexcept {
+    static_assert(std::is_floating_point_v<Real>);
+    Expects(depth_image.w() == rays.w());
+    Expects(depth_image.h() == rays.h());
+
+    return detail::sparse_patch<Real>(
+        depth_image.w(), depth_image.h(), patch,
+        [&](int v, int u_begin, int u_end, Real* out) {
+            detail::flexion_span(depth_image, rays, v, u_begin, u_end, out);
+        });
+}
+
+template <typename Real>
+inline std::vector<math::image<Real>>
+sparse_flexion(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               gsl::span<const cv::Rect>             patches) noexcept {
+    std::vector<math::image<Real>> result;
+    result.reserve(patches.size());
+    for (const cv::Rect& patch : patches)
+        result.emplace_back(sparse_flexion(depth_image, rays, patch));
+    return result;
+}
+
+template <direction Direction, typename Real>
+inline std::vector<Real>
+sparse_bearing(const math::image<Real>&               depth_image,
+               const camera_models::ray_table<Real>&  rays,
+               gsl::span<const math::pixel_coord<int>> points) noexcept {
+    static_assert(std::is_floating_point_v<Real>);
+    Expects(depth_image.w() == rays.w());
+    Expects(depth_image.h() == rays.h());
+
+    return detail::sparse_points<Real>(
+        points, [&](int v, int u_begin, int u_end, Real* out) {
+            detail::bearing_span<Direction>(depth_image, rays, v, u_begin,
+                                            u_end, out);
+        });
+}
+
+template <direction Direction, typename Real>
+inline math::image<Real>
+sparse_bearing(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               const cv::Rect&                       patch) noexcept {
+    static_assert(std::is_floating_point_v<Real>);
+    Expects(depth_image.w() == rays.w());
+    Expects(depth_image.h() == rays.h());
+
+    return detail::sparse_patch<Real>(
+        depth_image.w(), depth_image.h(), patch,
+        [&](int v, int u_begin, int u_end, Real* out) {
+            detail::bearing_span<Direction>(depth_image, rays, v, u_begin,
+                                            u_end, out);
+        });
+}
+
+template <direction Direction, typename Real>
+inline std::vector<math::image<Real>>
+sparse_bearing(const math::image<Real>&              depth_image,
+               const camera_models::ray_table<Real>& rays,
+               gsl::span<const cv::Rect>             patches) noexcept {
+    std::vector<math::image<Real>> result;
+    result.reserve(patches.size());
+    for (const cv::Rect& patch : patches)
+        result.emplace_back(
+            sparse_bearing<Direction>(depth_image, rays, patch));
+    return result;
+}
+}  // namespace sens_loc::conversion
+
+#endif /* end of include guard: SPARSE_CONVERSION_H_R8WNUE2C */
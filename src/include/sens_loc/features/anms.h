@@ -0,0 +1,50 @@
+#ifndef ANMS_H_M3QX8TLV
+#define ANMS_H_M3QX8TLV
+
+#include <cstddef>
+#include <gsl/gsl>
+#include <opencv2/core/types.hpp>
+#include <vector>
+
+namespace sens_loc::features {
+
+/// A keypoint only suppresses weaker keypoints, if its response is stronger
+/// by this factor, as proposed by Brown et al.
+constexpr float default_robustness = 0.9F;
+
+/// Calculate the suppression radius of each keypoint for the adaptive
+/// non-maximal suppression (ANMS, Brown, Szeliski, Winder 2005).
+///
+/// The radius of a keypoint is the distance to the closest keypoint with a
+/// response that is stronger by the \p robustness factor. Keypoints with
+/// large radii are the strongest ones within a large neighbourhood.
+///
+/// The keypoints are inserted into a uniform grid and visited with ascending
+/// response, while the weaker keypoints are removed from the grid. Each
+/// search only sees the stronger keypoints, which are found in rings of
+/// cells around the keypoint. This takes \c O(n log n) on average instead of
+/// comparing all pairs, with the same result.
+/// Negative responses are shifted by the weakest response before the
+/// comparison, because the ratio of the responses requires non-negative
+/// values.
+/// \pre 0.0F < robustness <= 1.0F
+/// \returns the radius of keypoint 'i' at position 'i', infinity for the
+/// keypoints that are not suppressed by any other
+std::vector<float> suppression_radii(gsl::span<const cv::KeyPoint> points,
+                                     float robustness = default_robustness);
+
+/// Move the \p count keypoints with the largest suppression radius to the
+/// front of \p points. These keypoints are distributed uniformly over the
+/// image, as each of them is the strongest in its neighbourhood.
+/// Equal radii prefer the stronger keypoint.
+/// \returns the end of the selected keypoints, the selected and the remaining
+/// keypoints keep their relative order
+/// \sa suppression_radii
+std::vector<cv::KeyPoint>::iterator
+partition_anms(std::vector<cv::KeyPoint>& points,
+               std::size_t                count,
+               float                      robustness = default_robustness);
+
+}  // namespace sens_loc::features
+
+#endif /* end of include guard: ANMS_H_M3QX8TLV */
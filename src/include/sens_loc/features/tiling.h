@@ -0,0 +1,67 @@
+#ifndef TILING_H_R7XK2PWD
+#define TILING_H_R7XK2PWD
+
+#include <cstddef>
+#include <gsl/gsl>
+#include <opencv2/core/types.hpp>
+#include <vector>
+
+namespace sens_loc {
+
+/// This namespace contains functionality that works on detected keypoints
+/// before they are described, e.g. to distribute them over the image.
+namespace features {
+
+/// Keypoints of different tiles that are closer than this many pixels are
+/// considered to be the same keypoint.
+constexpr float default_duplicate_radius = 2.0F;
+
+/// Part of an image that is processed on its own.
+struct tile {
+    /// Region of the image that is passed to the detector. It contains the
+    /// core and the overlap with the neighbouring tiles.
+    cv::Rect region;
+    /// The cores of all tiles partition the image without overlap.
+    cv::Rect core;
+};
+
+/// Split an image of \p width x \p height pixels in a grid of \p rows x
+/// \p cols tiles. The regions of the tiles extend \p overlap pixels into
+/// their neighbours, which should be at least the border that the detector
+/// ignores. Otherwise keypoints close to the border of the core are lost.
+/// \pre rows >= 1 && cols >= 1
+/// \pre width >= cols && height >= rows
+/// \pre overlap >= 0
+/// \returns the tiles in row major order
+std::vector<tile>
+make_tiles(int width, int height, int rows, int cols, int overlap);
+
+/// Move the \p count keypoints with the highest response to the front of
+/// \p points.
+/// \returns the end of the strongest keypoints
+std::vector<cv::KeyPoint>::iterator
+partition_strongest(std::vector<cv::KeyPoint>& points, std::size_t count);
+
+/// Transform \p points, that were detected in the region of \p t, into image
+/// coordinates. Keypoints that are farther than \p radius outside of the
+/// core are dropped, these belong to the neighbouring tiles.
+void to_image_coordinates(const tile&                t,
+                          std::vector<cv::KeyPoint>& points,
+                          float radius = default_duplicate_radius);
+
+/// Combine the keypoints of all tiles into one set.
+///
+/// A keypoint that is detected in the overlap of two tiles is found by both.
+/// If keypoints of different tiles are closer than \p radius, only the one
+/// with the highest response is kept. Keypoints of the same tile are never
+/// removed, the detector decides on them.
+/// \param tile_points keypoints of each tile in image coordinates
+/// \returns the remaining keypoints in the order of the tiles
+std::vector<cv::KeyPoint>
+merge_tiles(gsl::span<const std::vector<cv::KeyPoint>> tile_points,
+            float radius = default_duplicate_radius);
+
+}  // namespace features
+}  // namespace sens_loc
+
+#endif /* end of include guard: TILING_H_R7XK2PWD */
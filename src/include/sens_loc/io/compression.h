@@ -0,0 +1,38 @@
+#ifndef COMPRESSION_H_M4TZ8RWE
+#define COMPRESSION_H_M4TZ8RWE
+
+#include <cstddef>
+#include <vector>
+
+namespace sens_loc::io {
+
+/// Compression of the data blocks in the binary file formats.
+enum class block_codec {
+    none,  ///< Raw data, fastest to write and to read.
+    lz4,   ///< LZ4 compressed blocks, if the library is built with LZ4.
+};
+
+/// Block compression for the binary file formats.
+///
+/// LZ4 is an optional dependency. Without it, \c lz4_compress never
+/// compresses and \c lz4_decompress always fails, so files without
+/// compressed blocks remain readable.
+/// \returns \c true if the library is built with LZ4 support
+bool lz4_available() noexcept;
+
+/// Compress the \p bytes at \p raw with LZ4.
+/// \returns the compressed block, or an empty vector if the data is not
+/// compressible or LZ4 is not available
+std::vector<char> lz4_compress(const char* raw, std::size_t bytes);
+
+/// Decompress the LZ4 block \p compressed into exactly \p raw_bytes at
+/// \p raw.
+/// \returns \c true on success
+bool lz4_decompress(const char* compressed,
+                    std::size_t compressed_bytes,
+                    char*       raw,
+                    std::size_t raw_bytes) noexcept;
+
+}  // namespace sens_loc::io
+
+#endif /* end of include guard: COMPRESSION_H_M4TZ8RWE */
@@ -1,15 +1,119 @@
 #ifndef FEATURE_H_9IGYEWVQ
 #define FEATURE_H_9IGYEWVQ
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/persistence.hpp>
+#include <sens_loc/io/compression.h>
+#include <sens_loc/io/mapped_file.h>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace sens_loc::io {
 
-inline cv::FileStorage open_feature_file(const std::string& f_path) {
-    using cv::FileStorage;
-    const FileStorage fs{f_path, FileStorage::READ | FileStorage::FORMAT_YAML};
-    return fs;
+/// \returns \c true if \p path names a binary feature file, recognized by the
+/// extension \c .slfeat
+bool is_binary_feature_path(std::string_view path) noexcept;
+
+namespace detail {
+/// Position of one section in a binary feature file.
+struct feature_section {
+    std::uint64_t offset;  ///< Byte offset from the start of the features.
+    std::uint64_t bytes;   ///< Stored bytes of the section.
+};
+
+/// Encode the features of one image in the binary format.
+/// \returns the content of a complete binary feature file
+/// \sa feature_file, write_features
+std::vector<char> encode_features(const std::string&               source_path,
+                                  const std::vector<cv::KeyPoint>& keypoints,
+                                  const cv::Mat&                   descriptors,
+                                  block_codec                      codec);
+}  // namespace detail
+
+class feature_store;
+
+/// Read access to the keypoints and descriptors of one image.
+///
+/// Feature files are either YAML files written with \c cv::FileStorage, that
+/// are useful for interchange, or binary files with the extension \c .slfeat.
+/// The binary files start with a header and a table with the position of the
+/// sections, followed by the sections. Each section is raw or LZ4
+/// compressed. All values are in host byte order:
+/// ```
+/// char[8]  magic "SLFEAT01"
+/// int32    keypoints, descriptor rows, cols, type, codec
+/// uint32   bytes of the source path
+/// uint64   offset and stored bytes of the keypoints and the descriptors
+/// char     source path
+/// byte     keypoints, 28 bytes each, aligned to 64 bytes
+/// byte     descriptor matrix, aligned to 64 bytes
+/// ```
+/// A keypoint is stored as the floats x, y, size, angle, response and the
+/// int32 octave and class id.
+///
+/// Binary files are memory mapped and opening them only reads the header,
+/// the sections are decoded on access. Only the sections that are actually
+/// requested cost I/O.
+/// Like \c cv::FileStorage, an invalid or missing file yields empty data.
+/// \sa feature_store
+class feature_file {
+  public:
+    /// Features that are not open and yield empty data.
+    feature_file() = default;
+    /// Open the feature file \p path, the format is determined by the
+    /// extension.
+    explicit feature_file(const std::string& path);
+
+    /// \returns \c true if the file could be opened and parsed
+    [[nodiscard]] bool is_open() const noexcept;
+
+    /// Path to the image the features were detected on, empty if it is
+    /// unknown.
+    [[nodiscard]] std::string source_path() const;
+    [[nodiscard]] std::vector<cv::KeyPoint> keypoints() const;
+    /// The descriptors are always copied out of the file.
+    [[nodiscard]] cv::Mat descriptors() const;
+
+  private:
+    friend class feature_store;
+
+    /// Binary features at \p data within the mapping \p file.
+    feature_file(std::shared_ptr<const mapped_file> file,
+                 const char*                        data,
+                 std::size_t                        size) noexcept;
+
+    bool parse_binary(const char* data, std::size_t size) noexcept;
+    /// Copy or decode the section \p s into exactly \p raw_bytes at \p raw.
+    bool read_section(const detail::feature_section& s,
+                      char*                          raw,
+                      std::uint64_t                  raw_bytes) const noexcept;
+
+    cv::FileStorage                        _yaml;
+    std::shared_ptr<const mapped_file>     _file;
+    const char*                            _data           = nullptr;
+    int                                    _keypoint_count = 0;
+    int                                    _rows           = 0;
+    int                                    _cols           = 0;
+    int                                    _type           = 0;
+    std::string                            _source_path;
+    std::array<detail::feature_section, 2> _sections{};
+};
+
+inline feature_file open_feature_file(const std::string& f_path) {
+    return feature_file{f_path};
+}
+
+inline std::vector<cv::KeyPoint> load_keypoints(const feature_file& f) {
+    return f.keypoints();
+}
+
+inline cv::Mat load_descriptors(const feature_file& f) {
+    return f.descriptors();
 }
 
 inline std::vector<cv::KeyPoint> load_keypoints(const cv::FileStorage& fs) {
@@ -26,6 +130,21 @@ inline cv::Mat load_descriptors(const cv::FileStorage& fs) {
     return d;
 }
 
+/// Store the \p keypoints and \p descriptors detected on the image
+/// \p source_path in the feature file \p path.
+///
+/// Paths with the extension \c .slfeat are written in the binary format,
+/// everything else as YAML.
+/// \param codec compression of the binary sections, LZ4 falls back to raw
+/// sections if it is not available or does not pay off
+/// \returns \c true if the file was written successfully
+/// \sa feature_file
+bool write_features(const std::string&               path,
+                    const std::string&               source_path,
+                    const std::vector<cv::KeyPoint>& keypoints,
+                    const cv::Mat&                   descriptors,
+                    block_codec codec = block_codec::lz4) noexcept;
+
 }  // namespace sens_loc::io
 
 #endif /* end of include guard: FEATURE_H_9IGYEWVQ */
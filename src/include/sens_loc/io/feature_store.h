@@ -0,0 +1,127 @@
+#ifndef FEATURE_STORE_H_W2RJ6MAD
+#define FEATURE_STORE_H_W2RJ6MAD
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <opencv2/core/mat.hpp>
+#include <optional>
+#include <sens_loc/io/compression.h>
+#include <sens_loc/io/feature.h>
+#include <sens_loc/io/mapped_file.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sens_loc::io {
+
+/// \returns \c true if \p path names a feature store, recognized by the
+/// extension \c .slfseq
+bool is_feature_store_path(std::string_view path) noexcept;
+
+/// Keypoints and descriptors of a whole sequence of images in one file.
+///
+/// The file starts with a header and an index with the position of the
+/// features of each frame. The features of each frame are stored as a
+/// complete binary feature file. All values are in host byte order:
+/// ```
+/// char[8]  magic "SLFSEQ01"
+/// int32    first index, number of frames
+/// uint64   offset and bytes of the features of each frame [number of frames]
+/// byte     binary feature files, each aligned to 64 bytes
+/// ```
+/// A frame with zero bytes is missing.
+///
+/// The store is memory mapped and opening it only reads the index. Accessing
+/// a frame is a lookup in the index, without any system call, and the
+/// sections of a frame are decoded only when they are requested.
+/// \sa feature_file, feature_store_writer
+class feature_store {
+  public:
+    /// Open the feature store \p path.
+    /// \returns \c std::nullopt if the file is not a valid store
+    static std::optional<feature_store> open(const std::string& path) noexcept;
+
+    /// Index of the first frame in the store.
+    [[nodiscard]] int first() const noexcept { return _first; }
+    /// Index of the last frame in the store, inclusive.
+    [[nodiscard]] int last() const noexcept {
+        return _first + static_cast<int>(_index.size()) - 1;
+    }
+    /// Number of frame slots, including missing frames.
+    [[nodiscard]] std::size_t size() const noexcept { return _index.size(); }
+
+    /// \returns \c true if the features of frame \p idx are stored
+    [[nodiscard]] bool contains(int idx) const noexcept;
+
+    /// Access the features of frame \p idx.
+    /// The result shares the mapping and stays valid after the store is
+    /// destroyed.
+    /// \returns the features, that are not open if the frame is missing
+    [[nodiscard]] feature_file frame(int idx) const;
+
+  private:
+    explicit feature_store(std::shared_ptr<const mapped_file> file) noexcept
+        : _file{std::move(file)} {}
+
+    std::shared_ptr<const mapped_file>   _file;
+    int                                  _first = 0;
+    std::vector<detail::feature_section> _index;
+};
+
+/// Create a feature store frame by frame.
+///
+/// The number of frames is fixed on creation, frames can be added in any
+/// order. The index is written by \c finish.
+/// \note \c append is thread-safe, the frames are encoded in parallel and
+/// only writing them to the file is serialized.
+/// \sa feature_store
+class feature_store_writer {
+  public:
+    /// Create the store \p path for the frames \p first to \p last,
+    /// inclusive.
+    /// \param codec compression of the sections of each frame
+    /// \returns \c std::nullopt if the file can not be created
+    static std::optional<feature_store_writer>
+    create(const std::string& path,
+           int                first,
+           int                last,
+           block_codec        codec = block_codec::lz4) noexcept;
+
+    /// Store the features of frame \p idx, that were detected on the image
+    /// \p source_path.
+    /// \returns \c false if \p idx is out of range or already written or
+    /// writing failed
+    bool append(int                              idx,
+                const std::string&               source_path,
+                const std::vector<cv::KeyPoint>& keypoints,
+                const cv::Mat&                   descriptors) noexcept;
+
+    /// Write header and index.
+    /// Frames that were never added are stored as missing.
+    /// \returns \c true if the store is complete and valid
+    bool finish() noexcept;
+
+  private:
+    feature_store_writer(std::ofstream out,
+                         int           first,
+                         int           last,
+                         block_codec   codec);
+
+    /// Bytes of header and index, the first frame follows.
+    [[nodiscard]] std::uint64_t header_bytes() const noexcept;
+
+    std::ofstream                        _out;
+    int                                  _first;
+    block_codec                          _codec;
+    std::vector<detail::feature_section> _index;
+    std::uint64_t                        _end;
+    /// Serializes \c append, held by pointer to keep the writer movable.
+    std::unique_ptr<std::mutex> _lock = std::make_unique<std::mutex>();
+};
+
+}  // namespace sens_loc::io
+
+#endif /* end of include guard: FEATURE_STORE_H_W2RJ6MAD */
@@ -4,7 +4,10 @@
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 #include <optional>
+#include <sens_loc/io/compression.h>
 #include <sens_loc/math/image.h>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -13,16 +16,66 @@ namespace sens_loc {
 /// This namespace contains all functions for file io and helper for data
 /// loading and storing.
 namespace io {
-/// Perfect forward loading call to opencv's \c cv::imread.
+
+/// Encodings for image files. The encoding of a file is determined by the
+/// extension of its path.
+enum class image_format {
+    png,    ///< \c .png, zlib compressed, 8 or 16 bit.
+    pnm,    ///< \c .pgm, \c .ppm or \c .pnm, uncompressed 8 or 16 bit.
+    pfm,    ///< \c .pfm, uncompressed 32 bit floating point.
+    tiles,  ///< \c .slt, raw pixels in row tiles, optionally LZ4 compressed.
+            ///< Stores any \c cv::Mat type without conversion.
+    other,  ///< Every other extension is left to OpenCV.
+};
+
+/// Determine the encoding of the file \p path by its extension.
+image_format format_from_path(std::string_view path) noexcept;
+
+/// Configuration of the encoders for \c write_image.
+/// The defaults favor speed over the file size.
+struct write_options {
+    /// zlib compression level for PNG from 0 (none) to 9 (smallest).
+    /// \note If neither the level nor the strategy is set, OpenCV uses its
+    /// fastest PNG settings, which are not selectable explicitly.
+    std::optional<int> png_compression;
+    /// zlib strategy for PNG, one of \c cv::ImwritePNGFlags.
+    std::optional<int> png_strategy;
+    /// Number of image rows in one tile of \c image_format::tiles.
+    int tile_rows = 64;
+    /// Compression of the tiles of \c image_format::tiles.
+    block_codec tile_compression = block_codec::lz4;
+};
+
+/// Store \p img in the file \p path with the encoding that corresponds to
+/// the extension of \p path.
+///
+/// PFM files store floating point values, other types are converted to
+/// floating point without scaling. The tile format stores the image as is.
+/// \returns \c true if the file was written successfully
+/// \sa image_format
+bool write_image(const std::string&   path,
+                 const cv::Mat&       img,
+                 const write_options& options = {}) noexcept;
+
+/// Read the file \p path with the decoder for its extension.
+/// The \p flags of \c cv::imread do not apply to \c image_format::tiles,
+/// these images are always loaded unchanged.
+/// \returns the image or an empty \c cv::Mat if decoding failed
+cv::Mat read_image(const std::string& path,
+                   int                flags = cv::IMREAD_COLOR) noexcept;
+
+/// Loading call that mirrors opencv's \c cv::imread and additionally decodes
+/// the formats of \c write_image.
 ///
 /// \returns \c std::optional<cv::Mat> for better error handling.
 /// If the optional contains a value, the load was successful, otherwise it is
 /// \c None.
 template <typename PixelType, typename... Arg>
-std::optional<math::image<PixelType>> load_image(Arg&&... args) {
+std::optional<math::image<PixelType>> load_image(const std::string& path,
+                                                 Arg&&... args) {
     static_assert(std::is_arithmetic_v<PixelType>);
 
-    cv::Mat result = cv::imread(std::forward<Arg>(args)...);
+    cv::Mat result = read_image(path, std::forward<Arg>(args)...);
     if (result.data == nullptr)
         return std::nullopt;
     if (result.type() != math::detail::get_opencv_type<PixelType>())
@@ -0,0 +1,43 @@
+#ifndef MAPPED_FILE_H_8XWQ3JLD
+#define MAPPED_FILE_H_8XWQ3JLD
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace sens_loc::io {
+
+/// Read-only memory mapping of a whole file.
+///
+/// The pages are loaded lazily by the operating system on first access,
+/// therefore only the parts of the file that are actually read cost I/O.
+/// Views into \c data() stay valid as long as the mapping exists.
+class mapped_file {
+  public:
+    /// Map the file \p path into memory.
+    /// \returns \c std::nullopt if the file can not be opened or mapped
+    static std::optional<mapped_file> open(const std::string& path) noexcept;
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    ~mapped_file();
+
+    [[nodiscard]] const char* data() const noexcept { return _data; }
+    [[nodiscard]] std::size_t size() const noexcept { return _size; }
+
+  private:
+    mapped_file(const char* data, std::size_t size) noexcept
+        : _data{data}
+        , _size{size} {}
+
+    void unmap() noexcept;
+
+    const char* _data = nullptr;
+    std::size_t _size = 0UL;
+};
+
+}  // namespace sens_loc::io
+
+#endif /* end of include guard: MAPPED_FILE_H_8XWQ3JLD */
@@ -1,9 +1,11 @@
 #ifndef POSE_H_ZQQXTH63
 #define POSE_H_ZQQXTH63
 
-#include <sens_loc/math/pointcloud.h>
+#include <gsl/gsl>
 #include <istream>
 #include <optional>
+#include <sens_loc/math/pointcloud.h>
+#include <vector>
 
 namespace sens_loc::io {
 
@@ -21,6 +23,57 @@ namespace sens_loc::io {
 /// std::nullopt
 std::optional<math::pose_t> load_pose(std::istream& in) noexcept;
 
+/// Common file formats that store the poses of a whole sequence in one file,
+/// one pose per line.
+enum class trajectory_format {
+    /// TUM RGB-D benchmark: 'timestamp tx ty tz qx qy qz qw', with the
+    /// rotation as unit quaternion.
+    tum,
+    /// KITTI odometry benchmark: the 3x4 matrix 'r11 r12 r13 t1 r21 ... t3'
+    /// in row-major order. The line number is the frame index.
+    kitti,
+};
+
+/// The poses of a whole sequence, stored contiguously.
+struct trajectory {
+    std::vector<math::pose_t> poses;
+    /// Timestamp of each pose in seconds, empty if the format has none.
+    std::vector<double> timestamps;
+};
+
+/// Read a trajectory file in the given \p format.
+///
+/// Empty lines and lines starting with '#' are skipped. The timestamps of
+/// TUM trajectories must be ascending.
+/// \returns the poses in the order of the file, \c std::nullopt if any line
+/// is malformed or contains a rotation that is not orthonormal
+std::optional<trajectory> load_trajectory(std::istream&     in,
+                                          trajectory_format format) noexcept;
+
+/// Read the timestamps of the frames of a sequence, the first column of each
+/// line, e.g. 'depth.txt' of the TUM RGB-D benchmark or 'times.txt' of the
+/// KITTI odometry benchmark.
+///
+/// Empty lines and lines starting with '#' are skipped, further columns like
+/// the file names are ignored.
+/// \returns the timestamp of frame 'i' at position 'i', \c std::nullopt if
+/// a line does not start with a number
+std::optional<std::vector<double>> load_timestamps(std::istream& in) noexcept;
+
+/// Associate each frame with the pose of \p t that is closest in time.
+///
+/// The trajectory and the frames are usually recorded with different rates,
+/// e.g. the ground truth of the TUM RGB-D benchmark.
+/// \pre \p t provides a timestamp for each pose
+/// \param frame_times timestamps of the frames, e.g. from \c load_timestamps
+/// \param max_difference maximal time in seconds between a frame and its pose
+/// \returns the pose of frame 'i' at position 'i', \c std::nullopt if any
+/// frame has no pose within \p max_difference
+std::optional<std::vector<math::pose_t>>
+associate_poses(const trajectory&       t,
+                gsl::span<const double> frame_times,
+                double                  max_difference = 0.02) noexcept;
+
 }  // namespace sens_loc::io
 
 #endif /* end of include guard: POSE_H_ZQQXTH63 */
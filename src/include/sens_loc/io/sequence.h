@@ -0,0 +1,172 @@
+#ifndef SEQUENCE_H_TB5NQ2KV
+#define SEQUENCE_H_TB5NQ2KV
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <opencv2/core/mat.hpp>
+#include <optional>
+#include <sens_loc/io/image.h>
+#include <sens_loc/io/mapped_file.h>
+#include <sens_loc/math/image.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace sens_loc::io {
+
+/// \returns \c true if \p path names a sequence container, recognized by the
+/// extension \c .slseq
+bool is_sequence_path(std::string_view path) noexcept;
+
+namespace detail {
+/// Position of one frame in a sequence container.
+struct sequence_entry {
+    std::uint64_t offset;  ///< Byte offset of the payload in the file.
+    std::uint64_t bytes;   ///< Stored bytes, zero if the frame is missing.
+};
+}  // namespace detail
+
+/// Container for a whole sequence of images with the same resolution and
+/// type, e.g. all depth images of one recording.
+///
+/// The file starts with a header with resolution, pixel type and the
+/// calibration of the camera, followed by an index with the position of each
+/// frame and the payloads of the frames. Payloads are raw pixels or LZ4
+/// compressed. All values are in host byte order:
+/// ```
+/// char[8]  magic "SLSEQ001"
+/// int32    rows, cols, type, codec, first index, number of frames
+/// uint64   bytes of the calibration
+/// char     calibration, padded to 8 bytes
+/// uint64   offset and stored bytes of each frame [number of frames]
+/// byte     payloads, each aligned to 64 bytes
+/// ```
+/// A frame with zero stored bytes is missing, a frame whose stored size
+/// matches its raw size is not compressed.
+///
+/// This class provides read access through a memory mapping. Uncompressed
+/// frames are returned as views into the mapping without any copy. Opening a
+/// container only reads the header and the index.
+/// \sa sequence_writer
+class depth_sequence {
+  public:
+    /// Open the sequence container \p path.
+    /// \returns \c std::nullopt if the file is not a valid container
+    static std::optional<depth_sequence> open(const std::string& path) noexcept;
+
+    [[nodiscard]] int w() const noexcept { return _cols; }
+    [[nodiscard]] int h() const noexcept { return _rows; }
+    /// OpenCV type of the pixels, e.g. \c CV_16UC1.
+    [[nodiscard]] int type() const noexcept { return _type; }
+    /// Index of the first frame in the container.
+    [[nodiscard]] int first() const noexcept { return _first; }
+    /// Index of the last frame in the container, inclusive.
+    [[nodiscard]] int last() const noexcept {
+        return _first + static_cast<int>(_index.size()) - 1;
+    }
+    /// Number of frame slots, including missing frames.
+    [[nodiscard]] std::size_t size() const noexcept { return _index.size(); }
+
+    /// Content of the calibration file of the camera, empty if none was
+    /// stored. It can be parsed with \c io::camera::load_intrinsic.
+    [[nodiscard]] const std::string& intrinsic() const noexcept {
+        return _intrinsic;
+    }
+
+    /// \returns \c true if frame \p idx is stored in the container
+    [[nodiscard]] bool contains(int idx) const noexcept;
+
+    /// Access frame \p idx.
+    /// Uncompressed frames are read-only views into the mapping and must
+    /// not outlive the container, compressed frames are decoded into new
+    /// memory.
+    /// \returns the frame, or an empty \c cv::Mat if it is missing or could
+    /// not be decoded
+    [[nodiscard]] cv::Mat frame(int idx) const noexcept;
+
+    /// Typed access to frame \p idx, with the same lifetime as \c frame.
+    /// \returns \c std::nullopt if the frame is missing or has another type
+    template <typename PixelType>
+    [[nodiscard]] std::optional<math::image<PixelType>> load(int idx) const {
+        static_assert(std::is_arithmetic_v<PixelType>);
+        if (_type != math::detail::get_opencv_type<PixelType>())
+            return std::nullopt;
+        cv::Mat result = frame(idx);
+        if (result.empty())
+            return std::nullopt;
+        return {math::image<PixelType>(std::move(result))};
+    }
+
+  private:
+    explicit depth_sequence(mapped_file file) noexcept
+        : _file{std::move(file)} {}
+
+    mapped_file                         _file;
+    int                                 _rows  = 0;
+    int                                 _cols  = 0;
+    int                                 _type  = 0;
+    int                                 _first = 0;
+    block_codec                         _codec = block_codec::none;
+    std::string                         _intrinsic;
+    std::vector<detail::sequence_entry> _index;
+};
+
+/// Create a sequence container frame by frame.
+///
+/// The number of frames is fixed on creation, frames can be added in any
+/// order. The index is written by \c finish.
+/// \note The writer is not thread-safe.
+/// \sa depth_sequence
+class sequence_writer {
+  public:
+    /// Create the container \p path for the frames \p first to \p last,
+    /// inclusive.
+    /// \param intrinsic content of the calibration file, stored in the
+    /// header
+    /// \param codec compression of the frames, LZ4 falls back to raw frames
+    /// if it is not available
+    /// \returns \c std::nullopt if the file can not be created
+    static std::optional<sequence_writer>
+    create(const std::string& path,
+           int                first,
+           int                last,
+           const std::string& intrinsic = "",
+           block_codec        codec     = block_codec::lz4) noexcept;
+
+    /// Store \p frame as frame \p idx.
+    /// The first frame determines resolution and type of the sequence.
+    /// \returns \c false if \p idx is out of range or already written, the
+    /// frame does not match the sequence or writing failed
+    bool append(int idx, const cv::Mat& frame) noexcept;
+
+    /// Write header and index.
+    /// Frames that were never added are stored as missing.
+    /// \returns \c true if the container is complete and valid
+    bool finish() noexcept;
+
+  private:
+    sequence_writer(std::ofstream out,
+                    int           first,
+                    int           last,
+                    std::string   intrinsic,
+                    block_codec   codec);
+
+    /// Bytes of header, calibration and index, the first payload follows.
+    [[nodiscard]] std::uint64_t header_bytes() const noexcept;
+
+    std::ofstream                       _out;
+    int                                 _rows = 0;
+    int                                 _cols = 0;
+    int                                 _type = -1;
+    int                                 _first;
+    block_codec                         _codec;
+    std::string                         _intrinsic;
+    std::vector<detail::sequence_entry> _index;
+    std::uint64_t                       _end;
+};
+
+}  // namespace sens_loc::io
+
+#endif /* end of include guard: SEQUENCE_H_TB5NQ2KV */
@@ -0,0 +1,218 @@
+#ifndef POINT_GRID_H_K4TQ2WNB
+#define POINT_GRID_H_K4TQ2WNB
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gsl/gsl>
+#include <limits>
+#include <optional>
+#include <sens_loc/math/pointcloud.h>
+#include <unordered_map>
+#include <vector>
+
+namespace sens_loc::math {
+
+/// Uniform grid over a set of pixel coordinates for neighbourhood queries.
+///
+/// Points are referenced by their index into the original set and can be
+/// removed from the grid. A query only visits the cells that overlap with
+/// its search radius, so searching within a radius close to the cell size
+/// takes constant time on average instead of a linear scan over all points.
+/// Unbounded nearest neighbour queries search in growing rings of cells
+/// around the query point. They are fast, if the cell size is close to the
+/// average distance between the points.
+/// \note the grid refers to the original points, which must outlive it.
+/// Points with non-finite coordinates are never part of the grid.
+class point_grid {
+  public:
+    /// Insert all points of \p points into cells of size \p cell_size.
+    /// \pre cell_size > 0.0F
+    /// \pre points.size() < numeric_limits<int>::max()
+    point_grid(const imagepoints_t& points, float cell_size)
+        : _points{points}
+        , _cell_size{cell_size} {
+        Expects(_cell_size > 0.0F);
+        Expects(_points.size() <
+                std::size_t(std::numeric_limits<int>::max()));
+
+        _cells.reserve(_points.size());
+        const int n = gsl::narrow_cast<int>(_points.size());
+        for (int i = 0; i < n; ++i) {
+            const pixel_coord<float>& p = _points[i];
+            if (!std::isfinite(p.u()) || !std::isfinite(p.v()))
+                continue;
+            const std::int64_t cu = cell(p.u());
+            const std::int64_t cv = cell(p.v());
+            // Indices are inserted in ascending order and stay sorted.
+            _cells[key(cu, cv)].push_back(i);
+            ++_size;
+
+            _min_u = std::min(_min_u, cu);
+            _max_u = std::max(_max_u, cu);
+            _min_v = std::min(_min_v, cv);
+            _max_v = std::max(_max_v, cv);
+        }
+    }
+
+    /// Number of points that are still in the grid.
+    [[nodiscard]] std::size_t size() const noexcept { return _size; }
+    [[nodiscard]] bool        empty() const noexcept { return _size == 0UL; }
+
+    /// Remove the point with index \p idx from the grid.
+    /// \returns \c true if the point was in the grid
+    bool erase(int idx) noexcept {
+        if (idx < 0 || std::size_t(idx) >= _points.size())
+            return false;
+        const pixel_coord<float>& p = _points[idx];
+        if (!std::isfinite(p.u()) || !std::isfinite(p.v()))
+            return false;
+
+        auto cell_it = _cells.find(key(cell(p.u()), cell(p.v())));
+        if (cell_it == _cells.end())
+            return false;
+        std::vector<int>& c  = cell_it->second;
+        auto              it = std::lower_bound(c.begin(), c.end(), idx);
+        if (it == c.end() || *it != idx)
+            return false;
+        c.erase(it);
+        --_size;
+        return true;
+    }
+
+    /// Find the closest point to \p p that is closer than \p radius.
+    /// If multiple points have the same distance, the lowest index wins.
+    /// This is the same result as a linear search over the remaining points
+    /// in index order.
+    /// \returns the index of that point, \c std::nullopt if there is none
+    [[nodiscard]] std::optional<int>
+    nearest_within(const pixel_coord<float>& p, float radius) const noexcept {
+        if (empty() || !(radius > 0.0F) || !std::isfinite(p.u()) ||
+            !std::isfinite(p.v()))
+            return std::nullopt;
+
+        std::optional<int> best;
+        float              best_dist = radius;
+        for (std::int64_t cu = cell(p.u() - radius);
+             cu <= cell(p.u() + radius); ++cu) {
+            for (std::int64_t cv = cell(p.v() - radius);
+                 cv <= cell(p.v() + radius); ++cv) {
+                auto cell_it = _cells.find(key(cu, cv));
+                if (cell_it == _cells.end())
+                    continue;
+                for (int idx : cell_it->second) {
+                    const float d = (p - _points[idx]).norm();
+                    if (d < best_dist ||
+                        (best && d == best_dist && idx < *best)) {
+                        best      = idx;
+                        best_dist = d;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    /// Call \p f with the index of every point that is closer than \p radius
+    /// to \p p. The points are visited cell by cell, not by distance.
+    template <typename Function>
+    void for_each_within(const pixel_coord<float>& p,
+                         float                     radius,
+                         Function&&                f) const {
+        if (empty() || !(radius > 0.0F) || !std::isfinite(p.u()) ||
+            !std::isfinite(p.v()))
+            return;
+
+        for (std::int64_t cu = cell(p.u() - radius);
+             cu <= cell(p.u() + radius); ++cu) {
+            for (std::int64_t cv = cell(p.v() - radius);
+                 cv <= cell(p.v() + radius); ++cv) {
+                auto cell_it = _cells.find(key(cu, cv));
+                if (cell_it == _cells.end())
+                    continue;
+                for (int idx : cell_it->second)
+                    if ((p - _points[idx]).norm() < radius)
+                        f(idx);
+            }
+        }
+    }
+
+    /// Find the closest point to \p p in the grid, the point with the index
+    /// \p ignored is skipped. This allows to search the nearest neighbour of
+    /// a point that is part of the grid.
+    /// If multiple points have the same distance, the lowest index wins.
+    /// \returns the index of that point, \c std::nullopt if there is none
+    [[nodiscard]] std::optional<int>
+    nearest(const pixel_coord<float>& p, int ignored = -1) const noexcept {
+        if (empty() || !std::isfinite(p.u()) || !std::isfinite(p.v()))
+            return std::nullopt;
+
+        const std::int64_t pu = cell(p.u());
+        const std::int64_t pv = cell(p.v());
+        // The rings grow until they cover every non-empty cell.
+        const std::int64_t last_ring =
+            std::max({pu - _min_u, _max_u - pu, pv - _min_v, _max_v - pv,
+                      std::int64_t(0)});
+
+        std::optional<int> best;
+        float              best_dist = std::numeric_limits<float>::max();
+        const auto visit = [&](std::int64_t cu, std::int64_t cv) {
+            auto cell_it = _cells.find(key(cu, cv));
+            if (cell_it == _cells.end())
+                return;
+            for (int idx : cell_it->second) {
+                if (idx == ignored)
+                    continue;
+                const float d = (p - _points[idx]).norm();
+                if (!best || d < best_dist ||
+                    (d == best_dist && idx < *best)) {
+                    best      = idx;
+                    best_dist = d;
+                }
+            }
+        };
+
+        visit(pu, pv);
+        for (std::int64_t r = 1; r <= last_ring; ++r) {
+            // All points outside of the visited rings are at least 'r - 1'
+            // cells away from 'p'.
+            if (best && best_dist < float(r - 1) * _cell_size)
+                break;
+            for (std::int64_t cu = pu - r; cu <= pu + r; ++cu) {
+                visit(cu, pv - r);
+                visit(cu, pv + r);
+            }
+            for (std::int64_t cv = pv - r + 1; cv < pv + r; ++cv) {
+                visit(pu - r, cv);
+                visit(pu + r, cv);
+            }
+        }
+        return best;
+    }
+
+  private:
+    /// Cell coordinates are clamped, far away points share the outer cells.
+    [[nodiscard]] std::int64_t cell(float x) const noexcept {
+        constexpr double limit = double(std::int64_t(1) << 30);
+        const double     c     = std::floor(double(x) / double(_cell_size));
+        return std::int64_t(std::clamp(c, -limit, limit));
+    }
+    [[nodiscard]] static std::uint64_t key(std::int64_t cu,
+                                           std::int64_t cv) noexcept {
+        return (std::uint64_t(cu) << 32U) ^ (std::uint64_t(cv) & 0xffffffffU);
+    }
+
+    const imagepoints_t&                                _points;
+    float                                               _cell_size;
+    std::size_t                                         _size = 0UL;
+    std::unordered_map<std::uint64_t, std::vector<int>> _cells;
+    /// Bounding box of all cells that ever contained a point.
+    std::int64_t _min_u = std::numeric_limits<std::int64_t>::max();
+    std::int64_t _max_u = std::numeric_limits<std::int64_t>::min();
+    std::int64_t _min_v = std::numeric_limits<std::int64_t>::max();
+    std::int64_t _max_v = std::numeric_limits<std::int64_t>::min();
+};
+
+}  // namespace sens_loc::math
+
+#endif /* end of include guard: POINT_GRID_H_K4TQ2WNB */
@@ -19,6 +19,69 @@ template <typename Real>
 using imagepoints   = std::vector<pixel_coord<Real>>;
 using imagepoints_t = imagepoints<float>;
 
+/// A pointcloud stored as structure of arrays. Point 'i' is column 'i' and
+/// each row contains one coordinate (X, Y, Z) of all points contiguously.
+/// Operations on whole rows are vectorized by Eigen, which makes this layout
+/// preferable for transforming and projecting many points at once.
+/// \sa pointcloud
+template <typename Real>
+using pointcloud_soa = Eigen::Matrix<Real, 3, Eigen::Dynamic, Eigen::RowMajor>;
+using pointcloud_soa_t = pointcloud_soa<float>;
+
+/// A set of pixel coordinates as structure of arrays, with the 'u' coordinate
+/// in the first and the 'v' coordinate in the second row.
+/// \sa imagepoints
+template <typename Real>
+using imagepoints_soa = Eigen::Matrix<Real, 2, Eigen::Dynamic, Eigen::RowMajor>;
+using imagepoints_soa_t = imagepoints_soa<float>;
+
+/// Convert the pointcloud \p points to the structure of arrays layout.
+template <typename Real>
+pointcloud_soa<Real> to_soa(const pointcloud<Real>& points) noexcept {
+    pointcloud_soa<Real> result(3,
+                                gsl::narrow_cast<Eigen::Index>(points.size()));
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const auto col = gsl::narrow_cast<Eigen::Index>(i);
+        result(0, col) = points[i].X();
+        result(1, col) = points[i].Y();
+        result(2, col) = points[i].Z();
+    }
+    return result;
+}
+
+/// Convert the pixel coordinates \p points to the structure of arrays layout.
+template <typename Real>
+imagepoints_soa<Real> to_soa(const imagepoints<Real>& points) noexcept {
+    imagepoints_soa<Real> result(2,
+                                 gsl::narrow_cast<Eigen::Index>(points.size()));
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const auto col = gsl::narrow_cast<Eigen::Index>(i);
+        result(0, col) = points[i].u();
+        result(1, col) = points[i].v();
+    }
+    return result;
+}
+
+/// Convert the pointcloud \p points back to one coordinate per point.
+template <typename Real>
+pointcloud<Real> to_aos(const pointcloud_soa<Real>& points) noexcept {
+    pointcloud<Real> result;
+    result.reserve(gsl::narrow_cast<std::size_t>(points.cols()));
+    for (Eigen::Index i = 0; i < points.cols(); ++i)
+        result.emplace_back(points(0, i), points(1, i), points(2, i));
+    return result;
+}
+
+/// Convert the pixel coordinates \p points back to one coordinate per point.
+template <typename Real>
+imagepoints<Real> to_aos(const imagepoints_soa<Real>& points) noexcept {
+    imagepoints<Real> result;
+    result.reserve(gsl::narrow_cast<std::size_t>(points.cols()));
+    for (Eigen::Index i = 0; i < points.cols(); ++i)
+        result.emplace_back(points(0, i), points(1, i));
+    return result;
+}
+
 /// Calculate the point-wise euclidean distance between each point in \c c0
 /// and \c c1.
 /// The result is a row-vector with the distance for point 'i' at position 'i'.
@@ -74,6 +137,26 @@ inline pointcloud_t operator*(const pose_t&       p,
     return result;
 }
 
+/// Translate and rotate all points in \c points with the transformation \c p.
+///
+/// Each coordinate of the result is a linear combination of the rows of
+/// \c points and calculated for all points at once.
+/// \note This is not an \c operator*, as an operator for two Eigen types is
+/// neither found by argument dependent lookup nor preferred over the matrix
+/// product of Eigen.
+inline pointcloud_soa_t transform(const pose_t&           p,
+                                  const pointcloud_soa_t& points) noexcept {
+    const auto X = points.row(0).array();
+    const auto Y = points.row(1).array();
+    const auto Z = points.row(2).array();
+
+    pointcloud_soa_t result(3, points.cols());
+    for (int r = 0; r < 3; ++r)
+        result.row(r).array() =
+            p(r, 0) * X + p(r, 1) * Y + p(r, 2) * Z + p(r, 3);
+    return result;
+}
+
 }  // namespace sens_loc::math
 
 #endif /* end of include guard: POINTCLOUD_H_8O5EBVHZ */
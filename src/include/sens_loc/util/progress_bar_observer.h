@@ -9,6 +9,7 @@
 #include <gsl/gsl>
 #include <iomanip>
 #include <sens_loc/util/console.h>
+#include <string>
 #include <taskflow/core/observer.hpp>
 
 namespace sens_loc::util {
@@ -17,9 +18,15 @@ class progress_bar_observer : public tf::ExecutorObserverInterface {
   public:
     constexpr static int max_bars = 50;
 
-    progress_bar_observer(std::int64_t total_tasks)
+    /// \param total_tasks number of tasks that make up 100%
+    /// \param counted_task if not empty, only tasks with this name are counted.
+    /// This allows nesting other tasks, e.g. within a \c tf::Subflow, without
+    /// distorting the progress.
+    progress_bar_observer(std::int64_t total_tasks,
+                          std::string  counted_task = "")
         : _total_tasks{total_tasks}
-        , _done{0} {
+        , _done{0}
+        , _counted_task{std::move(counted_task)} {
         Expects(total_tasks >= 1);
     }
 
@@ -34,10 +41,12 @@ class progress_bar_observer : public tf::ExecutorObserverInterface {
     void on_exit(unsigned /*worker_id*/, tf::TaskView /*task_view*/) override;
 
   private:
+    [[nodiscard]] bool is_counted(const tf::TaskView& task_view) const;
     void print_bar(bool increment) noexcept;
 
     std::int64_t      _total_tasks;
     std::int64_t      _done;
+    std::string       _counted_task;
     std::atomic<bool> _inital_output = false;
 };
 }  // namespace sens_loc::util
@@ -0,0 +1,527 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <sens_loc/analysis/ann_index.h>
+#include <sens_loc/analysis/descriptor_distance.h>
+#include <type_traits>
+
+namespace sens_loc::analysis {
+
+namespace {
+/// The indices are randomized, but must be reproducible.
+constexpr unsigned index_seed = 42U;
+/// Upper bound for the layers of the graph, reached practically never.
+constexpr int max_hnsw_level = 16;
+
+/// Set of visited rows, that is cleared in constant time.
+class visited_set {
+  public:
+    explicit visited_set(int n)
+        : _tags(n, 0U) {}
+
+    void clear() noexcept {
+        if (++_epoch == 0U) {
+            std::fill(_tags.begin(), _tags.end(), 0U);
+            _epoch = 1U;
+        }
+    }
+    /// \returns \c true if \p idx was not visited before
+    bool insert(int idx) noexcept {
+        if (_tags[idx] == _epoch)
+            return false;
+        _tags[idx] = _epoch;
+        return true;
+    }
+
+  private:
+    std::vector<std::uint32_t> _tags;
+    std::uint32_t              _epoch = 0U;
+};
+
+/// The two closest candidates, equal distances keep the lower index.
+template <typename Result>
+struct top_two {
+    Result first_distance  = std::numeric_limits<Result>::max();
+    Result second_distance = std::numeric_limits<Result>::max();
+    int    first           = -1;
+    int    second          = -1;
+
+    void insert(Result d, int idx) noexcept {
+        if (first < 0 || d < first_distance ||
+            (d == first_distance && idx < first)) {
+            second_distance = first_distance;
+            second          = first;
+            first_distance  = d;
+            first           = idx;
+        } else if (second < 0 || d < second_distance ||
+                   (d == second_distance && idx < second)) {
+            second_distance = d;
+            second          = idx;
+        }
+    }
+
+    [[nodiscard]] nearest_neighbours result(bool take_sqrt) const noexcept {
+        const auto convert = [take_sqrt](Result d) {
+            const auto f = static_cast<float>(d);
+            return take_sqrt ? std::sqrt(f) : f;
+        };
+        nearest_neighbours n;
+        n.first = first;
+        if (first >= 0)
+            n.first_distance = convert(first_distance);
+        n.second = second;
+        if (second >= 0)
+            n.second_distance = convert(second_distance);
+        return n;
+    }
+};
+
+/// Construction and search of the HNSW graph with the kernel \p Distance.
+template <typename Distance>
+class hnsw {
+  public:
+    using Element   = typename Distance::element_type;
+    using Result    = decltype(Distance{}(nullptr, nullptr, 0));
+    using candidate = std::pair<Result, int>;
+
+    hnsw(const cv::Mat& descriptors, Distance distance) noexcept
+        : _descriptors{descriptors}
+        , _width{descriptors.cols * descriptors.channels()}
+        , _distance{distance} {}
+
+    void build(detail::hnsw_graph& g, const ann_parameters& p) const {
+        const int n   = _descriptors.rows;
+        g.max_links   = p.hnsw_links;
+        g.max_links_0 = 2 * p.hnsw_links;
+        g.levels.resize(n);
+        g.links_0.assign(std::size_t(n) * g.max_links_0, -1);
+        g.link_count_0.assign(n, 0);
+        g.upper_links.resize(n);
+
+        std::mt19937                           gen{index_seed};
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+        const double level_scale = 1.0 / std::log(double(p.hnsw_links));
+
+        visited_set visited{n};
+        for (int node = 0; node < n; ++node) {
+            const double u     = 1.0 - uniform(gen);
+            const int    level = std::min(
+                int(std::floor(-std::log(u) * level_scale)), max_hnsw_level);
+            g.levels[node] = level;
+            g.upper_links[node].resize(level);
+            insert(g, p, node, level, visited);
+        }
+    }
+
+    [[nodiscard]] nearest_neighbours search(const detail::hnsw_graph& g,
+                                            const Element*            query,
+                                            int                       ef,
+                                            visited_set&              visited,
+                                            bool take_sqrt) const {
+        top_two<Result> best;
+        if (g.entry_point < 0)
+            return best.result(take_sqrt);
+
+        std::vector<candidate> entries{
+            {to_node(query, g.entry_point), g.entry_point}};
+        for (int level = g.top_level; level > 0; --level)
+            entries = search_layer(g, query, entries, 1, level, visited);
+        for (const candidate& c :
+             search_layer(g, query, entries, std::max(ef, 2), 0, visited))
+            best.insert(c.first, c.second);
+        return best.result(take_sqrt);
+    }
+
+  private:
+    [[nodiscard]] const Element* row(int node) const noexcept {
+        return _descriptors.ptr<Element>(node);
+    }
+    [[nodiscard]] Result to_node(const Element* query, int node) const
+        noexcept {
+        return _distance(query, row(node), _width);
+    }
+
+    [[nodiscard]] static gsl::span<const int>
+    links(const detail::hnsw_graph& g, int node, int level) noexcept {
+        if (level == 0)
+            return {g.links_0.data() + std::size_t(node) * g.max_links_0,
+                    g.link_count_0[node]};
+        return g.upper_links[node][level - 1];
+    }
+
+    /// Best first search on one layer, starting from \p entries.
+    /// \returns up to \p ef closest nodes, sorted by their distance
+    std::vector<candidate> search_layer(const detail::hnsw_graph&     g,
+                                        const Element*                query,
+                                        const std::vector<candidate>& entries,
+                                        int                           ef,
+                                        int                           level,
+                                        visited_set& visited) const {
+        using min_queue =
+            std::priority_queue<candidate, std::vector<candidate>,
+                                std::greater<>>;
+        min_queue                      open;
+        std::priority_queue<candidate> found;
+
+        visited.clear();
+        for (const candidate& e : entries) {
+            visited.insert(e.second);
+            open.push(e);
+            found.push(e);
+        }
+        while (found.size() > std::size_t(ef))
+            found.pop();
+
+        while (!open.empty()) {
+            const candidate c = open.top();
+            if (c.first > found.top().first)
+                break;
+            open.pop();
+            for (const int neighbour : links(g, c.second, level)) {
+                if (!visited.insert(neighbour))
+                    continue;
+                const Result d = to_node(query, neighbour);
+                if (found.size() < std::size_t(ef) || d < found.top().first) {
+                    open.emplace(d, neighbour);
+                    found.emplace(d, neighbour);
+                    if (found.size() > std::size_t(ef))
+                        found.pop();
+                }
+            }
+        }
+
+        std::vector<candidate> result(found.size());
+        for (auto it = result.rbegin(); it != result.rend(); ++it) {
+            *it = found.top();
+            found.pop();
+        }
+        return result;
+    }
+
+    /// Neighbour selection heuristic of HNSW: a candidate is only linked, if
+    /// it is closer to the base node than to all already selected nodes.
+    /// This keeps links into different directions instead of a cluster.
+    /// \pre candidates are sorted by their distance to the base node
+    std::vector<int> select(const std::vector<candidate>& candidates,
+                            int                           count) const {
+        std::vector<int> selected;
+        selected.reserve(count);
+        for (const candidate& c : candidates) {
+            if (int(selected.size()) >= count)
+                break;
+            const bool diverse = std::all_of(
+                selected.begin(), selected.end(), [&](int s) {
+                    return !(to_node(row(c.second), s) < c.first);
+                });
+            if (diverse)
+                selected.push_back(c.second);
+        }
+        return selected;
+    }
+
+    void set_links(detail::hnsw_graph&     g,
+                   int                     node,
+                   int                     level,
+                   const std::vector<int>& selected) const {
+        if (level == 0) {
+            std::copy(selected.begin(), selected.end(),
+                      g.links_0.begin() + std::size_t(node) * g.max_links_0);
+            g.link_count_0[node] = int(selected.size());
+        } else {
+            g.upper_links[node][level - 1] = selected;
+        }
+    }
+
+    /// Add the link from \p node to \p target on \p level. If \p node has
+    /// too many links, its links are selected again.
+    void connect(detail::hnsw_graph& g, int node, int target, int level) const {
+        const gsl::span<const int> existing = links(g, node, level);
+        const int max = level == 0 ? g.max_links_0 : g.max_links;
+
+        if (int(existing.size()) < max) {
+            if (level == 0)
+                g.links_0[std::size_t(node) * g.max_links_0 +
+                          g.link_count_0[node]++] = target;
+            else
+                g.upper_links[node][level - 1].push_back(target);
+            return;
+        }
+
+        std::vector<candidate> candidates;
+        candidates.reserve(existing.size() + 1);
+        for (const int l : existing)
+            candidates.emplace_back(to_node(row(node), l), l);
+        candidates.emplace_back(to_node(row(node), target), target);
+        std::sort(candidates.begin(), candidates.end());
+        set_links(g, node, level, select(candidates, max));
+    }
+
+    void insert(detail::hnsw_graph&   g,
+                const ann_parameters& p,
+                int                   node,
+                int                   level,
+                visited_set&          visited) const {
+        if (g.entry_point < 0) {
+            g.entry_point = node;
+            g.top_level   = level;
+            return;
+        }
+
+        const Element*         query = row(node);
+        std::vector<candidate> entries{
+            {to_node(query, g.entry_point), g.entry_point}};
+        for (int l = g.top_level; l > level; --l)
+            entries = search_layer(g, query, entries, 1, l, visited);
+
+        for (int l = std::min(level, g.top_level); l >= 0; --l) {
+            entries = search_layer(g, query, entries, p.hnsw_ef_construction,
+                                   l, visited);
+            const std::vector<int> selected = select(entries, p.hnsw_links);
+            set_links(g, node, l, selected);
+            for (const int s : selected)
+                connect(g, s, node, l);
+        }
+
+        if (level > g.top_level) {
+            g.entry_point = node;
+            g.top_level   = level;
+        }
+    }
+
+    const cv::Mat& _descriptors;
+    int            _width;
+    Distance       _distance;
+};
+
+/// Construction and search of the hash tables with the kernel \p Distance.
+template <typename Distance>
+class lsh {
+  public:
+    using Result = decltype(Distance{}(nullptr, nullptr, 0));
+
+    lsh(const cv::Mat& descriptors, Distance distance) noexcept
+        : _descriptors{descriptors}
+        , _width{descriptors.cols * descriptors.channels()}
+        , _distance{distance} {}
+
+    void build(detail::lsh_tables& h, const ann_parameters& p) const {
+        const int n        = _descriptors.rows;
+        const int key_bits = std::min(p.lsh_key_bits, _width * 8);
+        // About two buckets per row, more only increases the empty buckets.
+        int bucket_bits = 1;
+        while (bucket_bits < key_bits && (1 << bucket_bits) < 2 * n)
+            ++bucket_bits;
+
+        std::vector<int> positions(std::size_t(_width) * 8UL);
+        std::iota(positions.begin(), positions.end(), 0);
+        std::mt19937 gen{index_seed};
+
+        h.tables.resize(p.lsh_tables);
+        for (detail::lsh_tables::table& t : h.tables) {
+            std::shuffle(positions.begin(), positions.end(), gen);
+            t.bits.assign(positions.begin(), positions.begin() + key_bits);
+            std::sort(t.bits.begin(), t.bits.end());
+            t.bucket_bits = bucket_bits;
+
+            // Counting sort of the rows into their buckets.
+            std::vector<int> buckets(n);
+            t.offsets.assign((std::size_t(1) << bucket_bits) + 1UL, 0);
+            for (int r = 0; r < n; ++r) {
+                buckets[r] = bucket(t, key(t, row(r)));
+                ++t.offsets[buckets[r] + 1];
+            }
+            std::partial_sum(t.offsets.begin(), t.offsets.end(),
+                             t.offsets.begin());
+            std::vector<int> next(t.offsets.begin(), t.offsets.end() - 1);
+            t.rows.resize(n);
+            for (int r = 0; r < n; ++r)
+                t.rows[next[buckets[r]]++] = r;
+        }
+    }
+
+    [[nodiscard]] nearest_neighbours search(const detail::lsh_tables& h,
+                                            const std::uint8_t*       query,
+                                            int          probe_level,
+                                            visited_set& visited) const {
+        top_two<Result> best;
+        visited.clear();
+        for (const detail::lsh_tables::table& t : h.tables) {
+            const auto probe = [&](std::uint32_t k) {
+                const int b = bucket(t, k);
+                for (int i = t.offsets[b]; i < t.offsets[b + 1]; ++i) {
+                    const int r = t.rows[i];
+                    if (visited.insert(r))
+                        best.insert(_distance(query, row(r), _width), r);
+                }
+            };
+
+            const std::uint32_t k = key(t, query);
+            const int           n = int(t.bits.size());
+            probe(k);
+            for (int b0 = 0; probe_level >= 1 && b0 < n; ++b0) {
+                probe(k ^ (1U << unsigned(b0)));
+                for (int b1 = b0 + 1; probe_level >= 2 && b1 < n; ++b1)
+                    probe(k ^ (1U << unsigned(b0)) ^ (1U << unsigned(b1)));
+            }
+        }
+        return best.result(/*take_sqrt=*/false);
+    }
+
+  private:
+    [[nodiscard]] const std::uint8_t* row(int r) const noexcept {
+        return _descriptors.ptr<std::uint8_t>(r);
+    }
+    [[nodiscard]] static std::uint32_t
+    key(const detail::lsh_tables::table& t, const std::uint8_t* d) noexcept {
+        std::uint32_t k = 0U;
+        for (const int b : t.bits)
+            k = (k << 1U) | ((d[b >> 3] >> unsigned(b & 7)) & 1U);
+        return k;
+    }
+    /// Fibonacci hashing of the key, if it has more bits than the table.
+    [[nodiscard]] static int
+    bucket(const detail::lsh_tables::table& t, std::uint32_t k) noexcept {
+        if (t.bucket_bits == int(t.bits.size()))
+            return int(k);
+        return int((k * 0x9E3779B1U) >> unsigned(32 - t.bucket_bits));
+    }
+
+    const cv::Mat& _descriptors;
+    int            _width;
+    Distance       _distance;
+};
+
+template <typename Distance>
+constexpr bool is_binary_kernel =
+    std::is_same_v<typename Distance::element_type, std::uint8_t>;
+}  // namespace
+
+ann_index::ann_index(const cv::Mat&        descriptors,
+                     cv::NormTypes         norm,
+                     const ann_parameters& parameters)
+    : _norm{norm}
+    , _parameters{parameters} {
+    Expects(is_descriptor_norm(norm));
+    Expects(parameters.lsh_tables > 0);
+    Expects(parameters.lsh_key_bits > 0 && parameters.lsh_key_bits <= 32);
+    Expects(parameters.lsh_probe_level >= 0 &&
+            parameters.lsh_probe_level <= 2);
+    Expects(parameters.hnsw_links > 1);
+    Expects(parameters.hnsw_ef_construction > 0);
+    Expects(parameters.hnsw_ef_search > 0);
+
+    const bool binary = norm == cv::NORM_HAMMING || norm == cv::NORM_HAMMING2;
+    Expects(descriptors.empty() || !binary || descriptors.depth() == CV_8U);
+
+    // The L-norms are calculated on floats, see 'min_descriptor_distances'.
+    if (!binary && !descriptors.empty() && descriptors.type() != CV_32F)
+        descriptors.convertTo(_descriptors, CV_32F);
+    else
+        _descriptors = descriptors;
+
+    if (_descriptors.empty())
+        return;
+
+    const int width = _descriptors.cols * _descriptors.channels();
+    detail::visit_distance(_norm, width, [this](auto distance) {
+        using Distance = decltype(distance);
+        if constexpr (is_binary_kernel<Distance>)
+            lsh<Distance>{_descriptors, distance}.build(_hashes, _parameters);
+        else
+            hnsw<Distance>{_descriptors, distance}.build(_graph, _parameters);
+    });
+}
+
+std::vector<nearest_neighbours>
+ann_index::search(const cv::Mat& queries) const {
+    std::vector<int> rows(queries.rows);
+    std::iota(rows.begin(), rows.end(), 0);
+    return search(queries, rows);
+}
+
+std::vector<nearest_neighbours>
+ann_index::search(const cv::Mat& queries, gsl::span<const int> rows) const {
+    std::vector<nearest_neighbours> result(rows.size());
+    if (_descriptors.empty() || rows.empty())
+        return result;
+    Expects(queries.type() == _descriptors.type() &&
+            queries.cols == _descriptors.cols);
+
+    // The scratch space is allocated once for all queries.
+    visited_set visited{_descriptors.rows};
+    const int   width = _descriptors.cols * _descriptors.channels();
+    detail::visit_distance(_norm, width, [&](auto distance) {
+        using Distance = decltype(distance);
+        using Element  = typename Distance::element_type;
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            Expects(rows[i] >= 0 && rows[i] < queries.rows);
+            const Element* q = queries.ptr<Element>(rows[i]);
+            if constexpr (is_binary_kernel<Distance>)
+                result[i] = lsh<Distance>{_descriptors, distance}.search(
+                    _hashes, q, _parameters.lsh_probe_level, visited);
+            else
+                result[i] = hnsw<Distance>{_descriptors, distance}.search(
+                    _graph, q, _parameters.hnsw_ef_search, visited,
+                    _norm == cv::NORM_L2);
+        }
+    });
+    return result;
+}
+
+std::vector<cv::DMatch> match_descriptors(const ann_index& query,
+                                          const ann_index& train,
+                                          match_strategy   strategy,
+                                          float            ratio) {
+    Expects(query.norm() == train.norm());
+    Expects(ratio > 0.0F && ratio <= 1.0F);
+
+    const cv::Mat& q = query.descriptors();
+    const cv::Mat& t = train.descriptors();
+    if (q.empty() || t.empty())
+        return {};
+
+    const bool crosscheck = strategy == match_strategy::crosscheck ||
+                            strategy == match_strategy::ratio_crosscheck;
+    const bool ratio_test = strategy == match_strategy::ratio ||
+                            strategy == match_strategy::ratio_crosscheck;
+
+    const std::vector<nearest_neighbours> forward = train.search(q);
+
+    // Only the train descriptors that are the nearest neighbour of some
+    // query are searched backwards.
+    std::vector<int> backward;
+    if (crosscheck) {
+        std::vector<int> matched;
+        matched.reserve(forward.size());
+        for (const nearest_neighbours& n : forward)
+            if (n.first >= 0)
+                matched.push_back(n.first);
+        std::sort(matched.begin(), matched.end());
+        matched.erase(std::unique(matched.begin(), matched.end()),
+                      matched.end());
+
+        const std::vector<nearest_neighbours> back = query.search(t, matched);
+        backward.assign(t.rows, -1);
+        for (std::size_t i = 0; i < matched.size(); ++i)
+            backward[matched[i]] = back[i].first;
+    }
+
+    std::vector<cv::DMatch> matches;
+    matches.reserve(q.rows);
+    for (int i = 0; i < q.rows; ++i) {
+        const nearest_neighbours& n = forward[i];
+        if (n.first < 0 || (crosscheck && backward[n.first] != i))
+            continue;
+        if (ratio_test && n.second >= 0 &&
+            !(n.first_distance < ratio * n.second_distance))
+            continue;
+        matches.emplace_back(i, n.first, 0, n.first_distance);
+    }
+    return matches;
+}
+
+}  // namespace sens_loc::analysis
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <sens_loc/analysis/descriptor_distance.h>
+
+namespace sens_loc::analysis {
+
+namespace {
+/// Minimal distance of each query row in [begin, end) to all other rows,
+/// computed block by block with the train rows in cache sized tiles.
+template <typename Distance>
+void min_rows(const cv::Mat& descriptors,
+              int            begin,
+              int            end,
+              float*         out,
+              Distance       distance) noexcept {
+    using Element = typename Distance::element_type;
+    using Result  = decltype(distance(nullptr, nullptr, 0));
+
+    const int n     = descriptors.rows;
+    const int width = descriptors.cols * descriptors.channels();
+    // The minima are kept in the result type of the kernel, integer for
+    // the hamming distances.
+    std::array<Result, detail::block_rows> minima;
+
+    for (int block = begin; block < end; block += detail::block_rows) {
+        const int block_end = std::min(block + detail::block_rows, end);
+        minima.fill(std::numeric_limits<Result>::max());
+
+        for (int tile = 0; tile < n; tile += detail::tile_rows) {
+            const int tile_end = std::min(tile + detail::tile_rows, n);
+            for (int i = block; i < block_end; ++i) {
+                const Element* query   = descriptors.ptr<Element>(i);
+                Result         minimum = minima[i - block];
+                for (int j = tile; j < tile_end; ++j) {
+                    // The distance to itself is zero and must be ignored.
+                    const Result d =
+                        distance(query, descriptors.ptr<Element>(j), width);
+                    minimum = j == i ? minimum : std::min(minimum, d);
+                }
+                minima[i - block] = minimum;
+            }
+        }
+        std::transform(minima.begin(), minima.begin() + (block_end - block),
+                       out + (block - begin),
+                       [](Result m) { return static_cast<float>(m); });
+    }
+}
+}  // namespace
+
+bool is_descriptor_norm(cv::NormTypes norm) noexcept {
+    return norm == cv::NORM_L1 || norm == cv::NORM_L2 ||
+           norm == cv::NORM_L2SQR || norm == cv::NORM_HAMMING ||
+           norm == cv::NORM_HAMMING2;
+}
+
+namespace detail {
+void min_descriptor_distance_rows(const cv::Mat& descriptors,
+                                  cv::NormTypes  norm,
+                                  int            begin,
+                                  int            end,
+                                  float*         out) noexcept {
+    Expects(is_descriptor_norm(norm));
+    Expects(begin >= 0 && begin <= end && end <= descriptors.rows);
+
+    const bool binary = norm == cv::NORM_HAMMING || norm == cv::NORM_HAMMING2;
+    Expects(binary ? descriptors.depth() == CV_8U
+                   : descriptors.type() == CV_32F);
+
+    const int width = descriptors.cols * descriptors.channels();
+    visit_distance(norm, width, [&](auto distance) {
+        min_rows(descriptors, begin, end, out, distance);
+    });
+    if (norm == cv::NORM_L2)
+        std::transform(out, out + (end - begin), out,
+                       [](float d) { return std::sqrt(d); });
+}
+}  // namespace detail
+
+std::vector<float> min_descriptor_distances(const cv::Mat& descriptors,
+                                            cv::NormTypes  norm) {
+    Expects(is_descriptor_norm(norm));
+
+    if (descriptors.rows < 2)
+        return {};
+
+    // The L-norms are calculated on floats, integer descriptors are converted
+    // once. The converted descriptors have the same size as the input.
+    cv::Mat converted;
+    if (norm != cv::NORM_HAMMING && norm != cv::NORM_HAMMING2 &&
+        descriptors.type() != CV_32F)
+        descriptors.convertTo(converted, CV_32F);
+    const cv::Mat& d = converted.empty() ? descriptors : converted;
+
+    std::vector<float> distances(d.rows);
+    detail::min_descriptor_distance_rows(d, norm, 0, d.rows, distances.data());
+    return distances;
+}
+
+}  // namespace sens_loc::analysis
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sens_loc/analysis/descriptor_distance.h>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <sens_loc/util/correctness_util.h>
+
+namespace sens_loc::analysis {
+
+namespace {
+/// Nearest neighbours of all query descriptors in one pass over all pairs.
+/// \tparam Backward track the closest query for each train descriptor as
+/// well, which is required for cross-checking
+/// \tparam SecondBest track the second closest train descriptor for each
+/// query, which is required for the ratio test
+template <bool Backward, bool SecondBest, typename Distance>
+std::vector<cv::DMatch> match_rows(const cv::Mat& query,
+                                   const cv::Mat& train,
+                                   float          ratio,
+                                   bool           take_sqrt,
+                                   Distance       distance) {
+    using Element = typename Distance::element_type;
+    using Result  = decltype(distance(nullptr, nullptr, 0));
+    constexpr Result no_distance = std::numeric_limits<Result>::max();
+
+    const int n_query = query.rows;
+    const int n_train = train.rows;
+    const int width   = query.cols * query.channels();
+
+    std::vector<Result> forward_dist(n_query, no_distance);
+    std::vector<int>    forward_idx(n_query, -1);
+    std::vector<Result> second_dist(SecondBest ? n_query : 0, no_distance);
+    std::vector<Result> backward_dist(Backward ? n_train : 0, no_distance);
+    std::vector<int>    backward_idx(Backward ? n_train : 0, -1);
+
+    for (int block = 0; block < n_query; block += detail::block_rows) {
+        const int block_end = std::min(block + detail::block_rows, n_query);
+
+        for (int tile = 0; tile < n_train; tile += detail::tile_rows) {
+            const int tile_end = std::min(tile + detail::tile_rows, n_train);
+            for (int i = block; i < block_end; ++i) {
+                const Element* q       = query.ptr<Element>(i);
+                Result         minimum = forward_dist[i];
+                int            min_idx = forward_idx[i];
+                Result second = SecondBest ? second_dist[i] : no_distance;
+                // Queries and train descriptors are visited in ascending
+                // order, strict comparisons keep the lowest index on ties.
+                for (int j = tile; j < tile_end; ++j) {
+                    const Result d =
+                        distance(q, train.ptr<Element>(j), width);
+                    if (d < minimum) {
+                        if constexpr (SecondBest)
+                            second = minimum;
+                        minimum = d;
+                        min_idx = j;
+                    } else if constexpr (SecondBest) {
+                        second = std::min(second, d);
+                    }
+                    if constexpr (Backward) {
+                        if (d < backward_dist[j]) {
+                            backward_dist[j] = d;
+                            backward_idx[j]  = i;
+                        }
+                    }
+                }
+                forward_dist[i] = minimum;
+                forward_idx[i]  = min_idx;
+                if constexpr (SecondBest)
+                    second_dist[i] = second;
+            }
+        }
+    }
+
+    // The L2 distances are squared, so is the ratio.
+    const float squared_ratio = take_sqrt ? ratio * ratio : ratio;
+
+    std::vector<cv::DMatch> matches;
+    matches.reserve(n_query);
+    for (int i = 0; i < n_query; ++i) {
+        const int j = forward_idx[i];
+        if (j < 0)
+            continue;
+        if constexpr (Backward) {
+            if (backward_idx[j] != i)
+                continue;
+        }
+        const float d = static_cast<float>(forward_dist[i]);
+        if constexpr (SecondBest) {
+            if (second_dist[i] != no_distance &&
+                !(d < squared_ratio * static_cast<float>(second_dist[i])))
+                continue;
+        }
+        // The image index is always 0, like for 'cv::BFMatcher' with a single
+        // train image.
+        matches.emplace_back(i, j, 0, take_sqrt ? std::sqrt(d) : d);
+    }
+    return matches;
+}
+}  // namespace
+
+std::vector<cv::DMatch> match_descriptors(const cv::Mat& query,
+                                          const cv::Mat& train,
+                                          cv::NormTypes  norm,
+                                          match_strategy strategy,
+                                          float          ratio) {
+    Expects(is_descriptor_norm(norm));
+    Expects(ratio > 0.0F && ratio <= 1.0F);
+    Expects(query.empty() || train.empty() ||
+            (query.type() == train.type() && query.cols == train.cols));
+
+    if (query.empty() || train.empty())
+        return {};
+
+    const bool binary = norm == cv::NORM_HAMMING || norm == cv::NORM_HAMMING2;
+    Expects(!binary || query.depth() == CV_8U);
+
+    // The L-norms are calculated on floats, see 'min_descriptor_distances'.
+    cv::Mat converted_query;
+    cv::Mat converted_train;
+    if (!binary && query.type() != CV_32F) {
+        query.convertTo(converted_query, CV_32F);
+        train.convertTo(converted_train, CV_32F);
+    }
+    const cv::Mat& q = converted_query.empty() ? query : converted_query;
+    const cv::Mat& t = converted_train.empty() ? train : converted_train;
+
+    const bool take_sqrt = norm == cv::NORM_L2;
+    std::vector<cv::DMatch> matches;
+    const int               width = q.cols * q.channels();
+    detail::visit_distance(norm, width, [&](auto distance) {
+        switch (strategy) {
+        case match_strategy::nearest:
+            matches = match_rows<false, false>(q, t, ratio, take_sqrt,
+                                               distance);
+            return;
+        case match_strategy::crosscheck:
+            matches =
+                match_rows<true, false>(q, t, ratio, take_sqrt, distance);
+            return;
+        case match_strategy::ratio:
+            matches =
+                match_rows<false, true>(q, t, ratio, take_sqrt, distance);
+            return;
+        case match_strategy::ratio_crosscheck:
+            matches = match_rows<true, true>(q, t, ratio, take_sqrt, distance);
+            return;
+        }
+        UNREACHABLE("unexpected match strategy");  // LCOV_EXCL_LINE
+    });
+    return matches;
+}
+
+}  // namespace sens_loc::analysis
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -66,4 +67,42 @@ void distance::analyze(gsl::span<const float> distances, bool histo) noexcept {
     }
 }
 
+void distance::analyze(distance_accumulator values, bool histo) noexcept {
+    if (values.exact()) {
+        std::sort(std::begin(values.values()), std::end(values.values()));
+        analyze(values.values(), histo);
+        return;
+    }
+    _histo.reset();
+    _s.reset();
+
+    if (values.empty())
+        return;
+
+    try {
+        _s = statistic::make(values.get_moments(), values.sketch());
+    } catch (const std::exception& e) {
+        std::cerr << sens_loc::util::err{} << "Can not extract accumulator.\n"
+                  << "Message: " << e.what() << "\n";
+    }
+
+    if (!histo)
+        return;
+
+    const float h_min = _s.min - 5.F * std::numeric_limits<float>::epsilon();
+    const float h_max = _s.max + 5.F * std::numeric_limits<float>::epsilon();
+
+    try {
+        _histo = boost::histogram::make_histogram(
+            axis_t(_bin_count, h_min, h_max, _axis_title));
+        for (const auto& [value, weight] : values.sketch().weighted_values())
+            _histo(value, boost::histogram::weight(weight));
+    } catch (const std::exception& e) {
+        std::cerr << sens_loc::util::err{}
+                  << "Could not create histogram for distance.\n"
+                  << "Message: " << e.what() << "\n";
+        return;
+    }
+}
+
 }  // namespace sens_loc::analysis
@@ -1,6 +1,12 @@
+#include <algorithm>
 #include <boost/histogram.hpp>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <sens_loc/analysis/keypoints.h>
+#include <sens_loc/math/point_grid.h>
+#include <sens_loc/math/pointcloud.h>
 #include <sens_loc/math/rounding.h>
 #include <sens_loc/util/console.h>
 #include <stdexcept>
@@ -116,6 +122,129 @@ void keypoints::analyze(gsl::span<const cv::KeyPoint> points,
     }
 }
 
+void keypoints::accumulate(gsl::span<const cv::KeyPoint> points) noexcept {
+    using namespace boost::histogram;
+
+    try {
+        if (!_accumulating) {
+            _distribution = make_histogram(
+                axis_t{_dist_width_bins, 0.0F, 1.0F, _dist_w_title},
+                axis_t{_dist_height_bins, 0.0F, 1.0F, _dist_h_title});
+            _size_values     = distance_accumulator{/*exact=*/false};
+            _response_values = distance_accumulator{/*exact=*/false};
+            _accumulating    = true;
+        }
+
+        auto iw = static_cast<float>(_img_width);
+        auto ih = static_cast<float>(_img_height);
+        for (const cv::KeyPoint& kp : points) {
+            _distribution(kp.pt.x / iw, kp.pt.y / ih);
+            _size_values.insert(kp.size);
+            _response_values.insert(kp.response);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << sens_loc::util::err{}
+                  << "Could not accumulate keypoints.\n"
+                  << "Message: " << e.what() << "\n";
+    }
+}
+
+void keypoints::merge(const keypoints& other) {
+    if (!other._accumulating)
+        return;
+    if (!_accumulating) {
+        _distribution    = other._distribution;
+        _size_values     = other._size_values;
+        _response_values = other._response_values;
+        _accumulating    = true;
+        return;
+    }
+    _distribution += other._distribution;
+    _size_values.merge(other._size_values);
+    _response_values.merge(other._response_values);
+}
+
+void keypoints::summarize() noexcept {
+    _size_histo.reset();
+    _size.reset();
+    _response_histo.reset();
+    _response.reset();
+
+    if (!_accumulating || _size_values.empty())
+        return;
+
+    using namespace boost::histogram;
+    try {
+        _size     = statistic::make(_size_values.get_moments(),
+                                _size_values.sketch());
+        _response = statistic::make(_response_values.get_moments(),
+                                    _response_values.sketch());
+
+        const float delta = 5.0F * std::numeric_limits<float>::epsilon();
+        if (_size_histo_enabled) {
+            const auto [s_min, s_max] = [&]() -> std::pair<float, float> {
+                if (std::abs(_size.min - _size.max) < 0.0001F)
+                    return {_size.min - 1.0F, _size.max + 1.0F};
+                return {_size.min - delta, _size.max + delta};
+            }();
+            _size_histo =
+                make_histogram(axis_t{_size_bins, s_min, s_max, _size_title});
+            for (const auto& [v, w] : _size_values.sketch().weighted_values())
+                _size_histo(v, weight(w));
+        }
+        if (_response_histo_enabled) {
+            _response_histo = make_histogram(
+                axis_t{_response_bins, _response.min - delta,
+                       _response.max + delta, _response_title});
+            for (const auto& [v, w] :
+                 _response_values.sketch().weighted_values())
+                _response_histo(v, weight(w));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << sens_loc::util::err{}
+                  << "Could not summarize the accumulated keypoints.\n"
+                  << "Message: " << e.what() << "\n";
+        return;
+    }
+}
+
+std::vector<float>
+nearest_neighbour_distances(gsl::span<const cv::KeyPoint> points) {
+    if (points.size() < 2)
+        return {};
+
+    math::imagepoints_t coords;
+    coords.reserve(points.size());
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    for (const cv::KeyPoint& kp : points) {
+        coords.emplace_back(kp.pt.x, kp.pt.y);
+        min_x = std::min(min_x, kp.pt.x);
+        min_y = std::min(min_y, kp.pt.y);
+        max_x = std::max(max_x, kp.pt.x);
+        max_y = std::max(max_y, kp.pt.y);
+    }
+
+    // Uniformly distributed keypoints have their neighbours in the same or
+    // the directly adjacent cells.
+    const float area =
+        std::max(max_x - min_x, 1.0F) * std::max(max_y - min_y, 1.0F);
+    const float cell_size = std::sqrt(area / static_cast<float>(coords.size()));
+    const math::point_grid grid{coords, std::max(cell_size, 1.0F)};
+
+    std::vector<float> distances;
+    distances.reserve(coords.size());
+    for (int i = 0; i < gsl::narrow_cast<int>(coords.size()); ++i) {
+        const std::optional<int> nn = grid.nearest(coords[i], i);
+        Ensures(nn.has_value());
+        distances.emplace_back((coords[i] - coords[*nn]).norm());
+    }
+    Ensures(distances.size() == coords.size());
+    return distances;
+}
+
 void write(cv::FileStorage& fs, const std::string& name, const keypoints& kp) {
     fs << name << "{";
     write(fs, "response", kp.response());
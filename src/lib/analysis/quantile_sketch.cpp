@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cmath>
+#include <sens_loc/analysis/quantile_sketch.h>
+
+namespace sens_loc::analysis {
+
+namespace {
+/// Each level is by this factor smaller than the level above it.
+constexpr double capacity_decay = 2.0 / 3.0;
+/// The smallest buffers still hold this many values.
+constexpr std::size_t min_capacity = 8UL;
+}  // namespace
+
+quantile_sketch::quantile_sketch(int k)
+    : _k{k}
+    , _random_state{0x9e3779b97f4a7c15ULL} {
+    Expects(k >= int(min_capacity));
+    _levels.emplace_back();
+    update_capacity();
+}
+
+void quantile_sketch::merge(const quantile_sketch& other) {
+    if (other.empty())
+        return;
+    if (_levels.size() < other._levels.size())
+        _levels.resize(other._levels.size());
+    for (std::size_t h = 0; h < other._levels.size(); ++h)
+        _levels[h].insert(_levels[h].end(), other._levels[h].begin(),
+                          other._levels[h].end());
+    _count += other._count;
+    _retained += other._retained;
+    update_capacity();
+    compress();
+}
+
+float quantile_sketch::at_rank(std::size_t rank) const {
+    Expects(!empty());
+    Expects(rank < _count);
+
+    const auto    values     = weighted_values();
+    std::uint64_t cumulative = 0UL;
+    for (const auto& [value, weight] : values) {
+        cumulative += weight;
+        if (cumulative > rank)
+            return value;
+    }
+    return values.back().first;
+}
+
+float quantile_sketch::quantile(double q) const {
+    Expects(q >= 0.0 && q <= 1.0);
+    const auto rank = static_cast<std::size_t>(q * double(_count));
+    return at_rank(std::min(rank, _count - 1UL));
+}
+
+std::vector<std::pair<float, std::uint64_t>>
+quantile_sketch::weighted_values() const {
+    std::vector<std::pair<float, std::uint64_t>> values;
+    values.reserve(_retained);
+    for (std::size_t h = 0; h < _levels.size(); ++h) {
+        const std::uint64_t weight = std::uint64_t(1) << h;
+        for (float v : _levels[h])
+            values.emplace_back(v, weight);
+    }
+    std::sort(values.begin(), values.end());
+    Ensures(values.size() == _retained);
+    return values;
+}
+
+void quantile_sketch::compress() {
+    while (_retained > _capacity) {
+        std::size_t h = 0;
+        while (h + 1 < _levels.size() &&
+               _levels[h].size() < level_capacity(h))
+            ++h;
+        if (h + 1 == _levels.size()) {
+            _levels.emplace_back();
+            update_capacity();
+        }
+        compact(h);
+    }
+}
+
+void quantile_sketch::compact(std::size_t h) {
+    std::vector<float>& level = _levels[h];
+    std::sort(level.begin(), level.end());
+
+    // An odd value stays on this level, only pairs are compacted.
+    const std::size_t odd = level.size() % 2UL;
+
+    // xorshift64, a fixed seed keeps the sketch reproducible.
+    _random_state ^= _random_state << 13U;
+    _random_state ^= _random_state >> 7U;
+    _random_state ^= _random_state << 17U;
+    const std::size_t offset = _random_state & 1UL;
+
+    std::vector<float>& next = _levels[h + 1];
+    for (std::size_t i = odd + offset; i < level.size(); i += 2UL)
+        next.push_back(level[i]);
+
+    const std::size_t promoted = (level.size() - odd) / 2UL;
+    _retained -= level.size() - odd - promoted;
+    level.resize(odd);
+}
+
+std::size_t quantile_sketch::level_capacity(std::size_t level) const noexcept {
+    const auto depth = double(_levels.size() - level - 1UL);
+    const auto c     = static_cast<std::size_t>(
+        std::ceil(double(_k) * std::pow(capacity_decay, depth)));
+    return std::max(c, min_capacity);
+}
+
+void quantile_sketch::update_capacity() noexcept {
+    _capacity = 0UL;
+    for (std::size_t h = 0; h < _levels.size(); ++h)
+        _capacity += level_capacity(h);
+}
+
+}  // namespace sens_loc::analysis
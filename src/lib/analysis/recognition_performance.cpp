@@ -5,6 +5,7 @@
 #include <sens_loc/io/feature.h>
 #include <sens_loc/io/image.h>
 #include <sens_loc/io/pose.h>
+#include <sens_loc/math/point_grid.h>
 #include <sens_loc/math/rounding.h>
 #include <unordered_set>
 
@@ -39,7 +40,7 @@ element_categories::element_categories(const math::imagepoints_t& query_data,
     // 'query_data'.
     unordered_set<int> remaining_query_indices;
 
-    // This set contains all positivly used indices into 'train_data'.
+    // This grid contains all remaining indices into 'train_data'.
     // This accounting ensures, that no keypoints are used
     // twice for classification of a query point.
     // This can happen, if a keypoint is close enough to its matched
@@ -47,12 +48,17 @@ element_categories::element_categories(const math::imagepoints_t& query_data,
     // pathological cases.
     // These cases are excluded with masking already used positive train
     // points.
-    unordered_set<int> remaining_train_indices;
+    // Only points closer than 'threshold' can be a correspondence, so the
+    // grid with that cell size only needs to search the neighbouring cells.
+    point_grid remaining_train_points(train_data, threshold);
 
     for (int i = 0; i < query_data_size; ++i)
         remaining_query_indices.emplace(i);
-    for (int i = 0; i < train_data_size; ++i)
-        remaining_train_indices.emplace(i);
+    // Invalid train points are never a correspondence for false negatives.
+    for (int i = 0; i < train_data_size; ++i) {
+        if (train_data[i].u() == -1 || train_data[i].v() == -1)
+            remaining_train_points.erase(i);
+    }
 
     // 1. Matches need to be classified in either true or false positives.
     // True positives remove the corresonding train-point from further
@@ -68,10 +74,9 @@ element_categories::element_categories(const math::imagepoints_t& query_data,
             true_positives.emplace_back(m.queryIdx, m.trainIdx, m.distance);
 
             // Disallow the train-pt to be reused by other classifications.
-            size_t removed = remaining_train_indices.erase(m.trainIdx);
-            // The point could not exist in the remaining_train_indidces.
+            // The point could not exist in the remaining train points.
             // This is due to masking or prior removal.
-            Ensures(removed == 1UL || removed == 0UL);
+            remaining_train_points.erase(m.trainIdx);
         }
         // This match is a false postive. Allow the 'train-pt' to be reused
         // for false negative calculation.
@@ -90,55 +95,29 @@ element_categories::element_categories(const math::imagepoints_t& query_data,
              remaining_query_indices.size()) == query_data.size());
 
     // 2. Search for false negatives in the remain query-points.
-    // Note: This has quadratic complexity, because there is a linear search
-    // for each remaining train index.
-    vector<float> all_distances(train_data.size(),
-                                numeric_limits<float>::max());
     for (int i : remaining_query_indices) {
         // There are no possible correspondences anymore.
         // This implies that each remain index in the query-set is a
         // true negative.
-        if (remaining_train_indices.empty())
+        if (remaining_train_points.empty())
             break;
 
         // Find the closest point to 'p' in the remaining training set.
-        // The distance to every point must be calculated, because there
-        // can be multiple close points. The closest is used as
+        // There can be multiple close points. The closest is used as
         // correspondence.
-        const pixel_coord<float> p = query_data.at(i);
-        all_distances.assign(
-            std::distance(begin(all_distances), end(all_distances)),
-            numeric_limits<float>::max());
-
-        for (int train_idx : remaining_train_indices) {
-            if (train_data.at(train_idx).u() == -1 ||
-                train_data.at(train_idx).v() == -1)
-                continue;
-            all_distances.at(train_idx) = (p - train_data.at(train_idx)).norm();
-        }
-        Ensures(!remaining_train_indices.empty());
-        auto min_it = min_element(begin(all_distances), end(all_distances));
-        const float min_dist = *min_it;
-
-        // This can happen, if all remaining query-points are invalid
-        // == {-1, -1}. In that case the point will be a true negative
-        // and will be classified AFTER this loop with the
-        // 'remaining points' becoming true negatives.
-        if (min_dist == numeric_limits<float>::max())
+        // The point is a false negative, if there is a close (enough)
+        // keypoint in the training set. Otherwise it will be a true negative
+        // and is classified AFTER this loop with the 'remaining points'
+        // becoming true negatives.
+        const optional<int> t_idx =
+            remaining_train_points.nearest_within(query_data.at(i), threshold);
+        if (!t_idx)
             continue;
 
-        Ensures(min_dist < numeric_limits<float>::max());
-
-        // The point is a false negative, because there is a close (enough)
-        // keypoint in the training set.
-        if (min_dist < threshold) {
-            const size_t t_idx = std::distance(begin(all_distances), min_it);
-            Ensures(t_idx < train_data.size());
-
-            false_negatives.emplace_back(i, t_idx);
-            const size_t removed = remaining_train_indices.erase(t_idx);
-            Ensures(removed == 1UL || removed == 0UL);
-        }
+        Ensures(size_t(*t_idx) < train_data.size());
+        false_negatives.emplace_back(i, *t_idx);
+        const bool removed = remaining_train_points.erase(*t_idx);
+        Ensures(removed);
     }
     // At this point 'false_negatives' are filtered out. For every false
     // negative there is an entry in 'false_negatives'. Each 'query_idx'
@@ -184,12 +163,38 @@ void recognition_statistic::account(
         narrow_cast<int64_t>(classification.false_positives.size()));
 
     // Keep track of the descriptor distances.
-    transform(classification.true_positives.begin(),
-              classification.true_positives.end(), back_inserter(tp_distance),
-              [](const keypoint_correspondence& c) { return c.distance; });
-    transform(classification.false_positives.begin(),
-              classification.false_positives.end(), back_inserter(fp_distance),
-              [](const keypoint_correspondence& c) { return c.distance; });
+    for (const keypoint_correspondence& c : classification.true_positives)
+        tp_distance.insert(c.distance);
+    for (const keypoint_correspondence& c : classification.false_positives)
+        fp_distance.insert(c.distance);
+}
+
+void recognition_statistic::merge(const recognition_statistic& other) {
+    using namespace std;
+    n_true_pos += other.n_true_pos;
+    n_false_pos += other.n_false_pos;
+    n_true_neg += other.n_true_neg;
+    n_false_neg += other.n_false_neg;
+
+    // The accumulators can not be merged, the per image values of 'other'
+    // are inserted again.
+    for (size_t i = 0; i < size(other.t_p_per_image); ++i) {
+        _relevant_elements.stat(other.t_p_per_image[i] +
+                                other.f_n_per_image[i]);
+        _true_positives.stat(other.t_p_per_image[i]);
+        _false_positives.stat(other.f_p_per_image[i]);
+    }
+    t_p_per_image.insert(end(t_p_per_image), begin(other.t_p_per_image),
+                         end(other.t_p_per_image));
+    f_p_per_image.insert(end(f_p_per_image), begin(other.f_p_per_image),
+                         end(other.f_p_per_image));
+    t_n_per_image.insert(end(t_n_per_image), begin(other.t_n_per_image),
+                         end(other.t_n_per_image));
+    f_n_per_image.insert(end(f_n_per_image), begin(other.f_n_per_image),
+                         end(other.f_n_per_image));
+
+    tp_distance.merge(other.tp_distance);
+    fp_distance.merge(other.fp_distance);
 }
 
 void recognition_statistic::make_histogram() {
@@ -207,7 +212,6 @@ void recognition_statistic::make_histogram() {
             "True Positives per Frame"));
     _true_positives.histo.fill(t_p_per_image);
 
-    sort(begin(tp_distance), end(tp_distance));
     _tp_descriptor_distance =
         distance(tp_distance, 50, "True Positive Descriptor Distances");
 
@@ -217,7 +221,6 @@ void recognition_statistic::make_histogram() {
             "False Positives per Frame"));
     _false_positives.histo.fill(f_p_per_image);
 
-    sort(begin(fp_distance), end(fp_distance));
     _fp_descriptor_distance =
         distance(fp_distance, 50, "False Positives Descriptor Distances");
 
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <sens_loc/features/anms.h>
+#include <sens_loc/math/point_grid.h>
+#include <sens_loc/math/pointcloud.h>
+
+namespace sens_loc::features {
+
+std::vector<float> suppression_radii(gsl::span<const cv::KeyPoint> points,
+                                     float robustness) {
+    Expects(robustness > 0.0F && robustness <= 1.0F);
+
+    const int n = gsl::narrow_cast<int>(points.size());
+    std::vector<float> radii(points.size(),
+                             std::numeric_limits<float>::infinity());
+    if (n < 2)
+        return radii;
+
+    math::imagepoints_t coords;
+    coords.reserve(points.size());
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    for (const cv::KeyPoint& kp : points) {
+        coords.emplace_back(kp.pt.x, kp.pt.y);
+        min_x = std::min(min_x, kp.pt.x);
+        min_y = std::min(min_y, kp.pt.y);
+        max_x = std::max(max_x, kp.pt.x);
+        max_y = std::max(max_y, kp.pt.y);
+    }
+
+    // Roughly one keypoint per cell, like 'nearest_neighbour_distances'.
+    const float area =
+        std::max(max_x - min_x, 1.0F) * std::max(max_y - min_y, 1.0F);
+    const float cell_size = std::sqrt(area / static_cast<float>(n));
+    math::point_grid grid{coords, std::max(cell_size, 1.0F)};
+
+    std::vector<int> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int i, int k) {
+        return points[i].response < points[k].response;
+    });
+
+    // The ratio test requires non-negative responses. Detectors like ORB
+    // report negative scores, these are shifted so the weakest becomes 0.
+    const float offset = std::min(points[order.front()].response, 0.0F);
+    const auto  response = [&](int i) { return points[i].response - offset; };
+
+    // Keypoint 'k' suppresses 'i' if 'response_i < robustness * response_k'.
+    // The threshold grows with the response of 'i', therefore the keypoints
+    // that can not suppress 'i' are removed from the grid one by one.
+    auto weak = order.begin();
+    for (int i : order) {
+        while (weak != order.end() &&
+               !(response(i) < robustness * response(*weak))) {
+            grid.erase(*weak);
+            ++weak;
+        }
+        if (grid.empty())
+            break;
+
+        // Without a stronger keypoint the radius stays infinite.
+        const std::optional<int> k = grid.nearest(coords[i], i);
+        if (!k)
+            continue;
+        radii[i] = (coords[i] - coords[*k]).norm();
+    }
+    return radii;
+}
+
+std::vector<cv::KeyPoint>::iterator
+partition_anms(std::vector<cv::KeyPoint>& points,
+               std::size_t                count,
+               float                      robustness) {
+    if (points.size() <= count)
+        return points.end();
+
+    const std::vector<float> radii = suppression_radii(points, robustness);
+
+    std::vector<int> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto count_it = order.begin() + gsl::narrow_cast<long>(count);
+    std::nth_element(order.begin(), count_it, order.end(), [&](int i, int k) {
+        if (radii[i] != radii[k])
+            return radii[i] > radii[k];
+        if (points[i].response != points[k].response)
+            return points[i].response > points[k].response;
+        return i < k;
+    });
+
+    std::vector<bool> selected(points.size(), false);
+    for (auto it = order.begin(); it != count_it; ++it)
+        selected[*it] = true;
+
+    std::vector<cv::KeyPoint> partitioned;
+    partitioned.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+        if (selected[i])
+            partitioned.push_back(points[i]);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        if (!selected[i])
+            partitioned.push_back(points[i]);
+    // The storage of 'points' is kept, iterators into it stay valid.
+    std::copy(partitioned.begin(), partitioned.end(), points.begin());
+
+    return points.begin() + gsl::narrow_cast<long>(count);
+}
+
+}  // namespace sens_loc::features
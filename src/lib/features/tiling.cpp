@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <numeric>
+#include <sens_loc/features/tiling.h>
+#include <sens_loc/math/point_grid.h>
+#include <sens_loc/math/pointcloud.h>
+
+namespace sens_loc::features {
+
+std::vector<tile>
+make_tiles(int width, int height, int rows, int cols, int overlap) {
+    Expects(rows >= 1 && cols >= 1);
+    Expects(width >= cols && height >= rows);
+    Expects(overlap >= 0);
+
+    std::vector<tile> tiles;
+    tiles.reserve(std::size_t(rows) * std::size_t(cols));
+    for (int r = 0; r < rows; ++r) {
+        const int y0 = r * height / rows;
+        const int y1 = (r + 1) * height / rows;
+        for (int c = 0; c < cols; ++c) {
+            const int x0 = c * width / cols;
+            const int x1 = (c + 1) * width / cols;
+
+            const int rx0 = std::max(x0 - overlap, 0);
+            const int ry0 = std::max(y0 - overlap, 0);
+            const int rx1 = std::min(x1 + overlap, width);
+            const int ry1 = std::min(y1 + overlap, height);
+            tiles.push_back({cv::Rect(rx0, ry0, rx1 - rx0, ry1 - ry0),
+                             cv::Rect(x0, y0, x1 - x0, y1 - y0)});
+        }
+    }
+    Ensures(tiles.size() == std::size_t(rows) * std::size_t(cols));
+    return tiles;
+}
+
+std::vector<cv::KeyPoint>::iterator
+partition_strongest(std::vector<cv::KeyPoint>& points, std::size_t count) {
+    if (points.size() <= count)
+        return points.end();
+
+    auto count_it = points.begin() + gsl::narrow_cast<long>(count);
+    // Sort until the element 'count' by response. The range is partitioned
+    // afterwards.
+    std::nth_element(points.begin(), count_it, points.end(),
+                     [](const cv::KeyPoint& kp1, const cv::KeyPoint& kp2) {
+                         return kp1.response > kp2.response;
+                     });
+    return count_it;
+}
+
+void to_image_coordinates(const tile&                t,
+                          std::vector<cv::KeyPoint>& points,
+                          float                      radius) {
+    const float min_x = float(t.core.x) - radius;
+    const float min_y = float(t.core.y) - radius;
+    const float max_x = float(t.core.x + t.core.width) + radius;
+    const float max_y = float(t.core.y + t.core.height) + radius;
+
+    for (cv::KeyPoint& kp : points) {
+        kp.pt.x += float(t.region.x);
+        kp.pt.y += float(t.region.y);
+    }
+    auto new_end = std::remove_if(
+        points.begin(), points.end(), [&](const cv::KeyPoint& kp) {
+            return kp.pt.x < min_x || kp.pt.x >= max_x || kp.pt.y < min_y ||
+                   kp.pt.y >= max_y;
+        });
+    points.erase(new_end, points.end());
+}
+
+std::vector<cv::KeyPoint>
+merge_tiles(gsl::span<const std::vector<cv::KeyPoint>> tile_points,
+            float                                      radius) {
+    std::vector<cv::KeyPoint> all;
+    std::vector<int>          owner;
+    std::size_t               total = 0UL;
+    for (const auto& points : tile_points)
+        total += points.size();
+    all.reserve(total);
+    owner.reserve(total);
+    for (int t = 0; t < gsl::narrow_cast<int>(tile_points.size()); ++t) {
+        all.insert(all.end(), tile_points[t].begin(), tile_points[t].end());
+        owner.insert(owner.end(), tile_points[t].size(), t);
+    }
+
+    if (tile_points.size() < 2 || !(radius > 0.0F) || all.empty())
+        return all;
+
+    math::imagepoints_t coords;
+    coords.reserve(all.size());
+    for (const cv::KeyPoint& kp : all)
+        coords.emplace_back(kp.pt.x, kp.pt.y);
+    const math::point_grid grid{coords, radius};
+
+    // The strongest keypoints suppress their weaker duplicates. Equal
+    // responses are resolved by the order of the tiles, which keeps the
+    // result deterministic.
+    std::vector<int> order(all.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int i, int k) {
+        return all[i].response > all[k].response;
+    });
+
+    std::vector<bool> removed(all.size(), false);
+    for (int i : order) {
+        if (removed[i])
+            continue;
+        // Every keypoint of another tile within the radius that was not
+        // removed yet is weaker, otherwise it would have removed 'i'.
+        grid.for_each_within(coords[i], radius, [&](int k) {
+            if (owner[k] != owner[i])
+                removed[k] = true;
+        });
+    }
+
+    std::vector<cv::KeyPoint> merged;
+    merged.reserve(all.size());
+    for (std::size_t i = 0; i < all.size(); ++i)
+        if (!removed[i])
+            merged.push_back(all[i]);
+    return merged;
+}
+
+}  // namespace sens_loc::features
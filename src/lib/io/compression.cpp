@@ -0,0 +1,59 @@
+#include <sens_loc/io/compression.h>
+
+#if SENS_LOC_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace sens_loc::io {
+
+bool lz4_available() noexcept {
+#if SENS_LOC_HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<char> lz4_compress(const char* raw, std::size_t bytes) {
+#if SENS_LOC_HAVE_LZ4
+    if (bytes == 0UL || bytes > std::size_t(LZ4_MAX_INPUT_SIZE))
+        return {};
+
+    std::vector<char> compressed(LZ4_compressBound(static_cast<int>(bytes)));
+    const int         stored = LZ4_compress_default(
+        raw, compressed.data(), static_cast<int>(bytes),
+        static_cast<int>(compressed.size()));
+    // Incompressible data is not worth the decompression.
+    if (stored <= 0 || std::size_t(stored) >= bytes)
+        return {};
+    compressed.resize(stored);
+    return compressed;
+#else
+    (void) raw;
+    (void) bytes;
+    return {};
+#endif
+}
+
+bool lz4_decompress(const char* compressed,
+                    std::size_t compressed_bytes,
+                    char*       raw,
+                    std::size_t raw_bytes) noexcept {
+#if SENS_LOC_HAVE_LZ4
+    if (compressed_bytes > std::size_t(LZ4_MAX_INPUT_SIZE) ||
+        raw_bytes > std::size_t(LZ4_MAX_INPUT_SIZE))
+        return false;
+    const int decoded = LZ4_decompress_safe(
+        compressed, raw, static_cast<int>(compressed_bytes),
+        static_cast<int>(raw_bytes));
+    return decoded >= 0 && std::size_t(decoded) == raw_bytes;
+#else
+    (void) compressed;
+    (void) compressed_bytes;
+    (void) raw;
+    (void) raw_bytes;
+    return false;
+#endif
+}
+
+}  // namespace sens_loc::io
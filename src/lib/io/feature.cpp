@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <sens_loc/io/feature.h>
+#include <utility>
+
+namespace sens_loc::io {
+
+namespace {
+constexpr std::array<char, 8> feature_magic = {'S', 'L', 'F', 'E',
+                                               'A', 'T', '0', '1'};
+constexpr std::string_view    feature_extension = ".slfeat";
+constexpr std::uint64_t       section_alignment = 64UL;
+
+struct feature_header {
+    std::array<char, 8> magic;
+    std::int32_t        keypoints;
+    std::int32_t        rows;
+    std::int32_t        cols;
+    std::int32_t        type;
+    std::int32_t        codec;
+    std::uint32_t       source_bytes;
+};
+
+/// Stable on-disk layout of a \c cv::KeyPoint.
+struct keypoint_record {
+    float        x;
+    float        y;
+    float        size;
+    float        angle;
+    float        response;
+    std::int32_t octave;
+    std::int32_t class_id;
+};
+static_assert(sizeof(keypoint_record) == 28UL);
+
+enum section : std::size_t { keypoint_section = 0, descriptor_section = 1 };
+
+constexpr std::uint64_t align(std::uint64_t bytes,
+                              std::uint64_t alignment) noexcept {
+    return (bytes + alignment - 1UL) / alignment * alignment;
+}
+
+std::uint64_t descriptor_bytes(int rows, int cols, int type) noexcept {
+    return std::uint64_t(rows) * cols * CV_ELEM_SIZE(type);
+}
+
+bool write_yaml(const std::string&               path,
+                const std::string&               source_path,
+                const std::vector<cv::KeyPoint>& keypoints,
+                const cv::Mat&                   descriptors) {
+    using cv::FileStorage;
+    FileStorage fs{path, FileStorage::WRITE | FileStorage::FORMAT_YAML};
+    if (!fs.isOpened())
+        return false;
+    cv::write(fs, "source_path", source_path);
+    cv::write(fs, "keypoints", keypoints);
+    cv::write(fs, "descriptors", descriptors);
+    return true;
+}
+
+bool write_binary(const std::string&               path,
+                  const std::string&               source_path,
+                  const std::vector<cv::KeyPoint>& keypoints,
+                  const cv::Mat&                   descriptors,
+                  block_codec                      codec) {
+    const std::vector<char> encoded =
+        detail::encode_features(source_path, keypoints, descriptors, codec);
+
+    std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+    out.write(encoded.data(), encoded.size());
+    out.flush();
+    return out.good();
+}
+}  // namespace
+
+namespace detail {
+std::vector<char> encode_features(const std::string&               source_path,
+                                  const std::vector<cv::KeyPoint>& keypoints,
+                                  const cv::Mat&                   descriptors,
+                                  block_codec                      codec) {
+    std::vector<keypoint_record> records;
+    records.reserve(keypoints.size());
+    for (const cv::KeyPoint& kp : keypoints)
+        records.push_back({kp.pt.x, kp.pt.y, kp.size, kp.angle, kp.response,
+                           kp.octave, kp.class_id});
+
+    const cv::Mat continuous =
+        descriptors.isContinuous() ? descriptors : descriptors.clone();
+
+    const bool compress = codec == block_codec::lz4 && lz4_available();
+    const feature_header header{
+        feature_magic,
+        static_cast<std::int32_t>(records.size()),
+        continuous.rows,
+        continuous.cols,
+        continuous.type(),
+        static_cast<std::int32_t>(compress ? block_codec::lz4
+                                           : block_codec::none),
+        static_cast<std::uint32_t>(source_path.size())};
+
+    // Incompressible sections are stored raw.
+    const std::array<std::pair<const char*, std::uint64_t>, 2> raw = {
+        std::make_pair(reinterpret_cast<const char*>(records.data()),
+                       records.size() * sizeof(keypoint_record)),
+        std::make_pair(continuous.empty() ? nullptr
+                                          : continuous.ptr<char>(),
+                       continuous.empty()
+                           ? 0UL
+                           : descriptor_bytes(continuous.rows, continuous.cols,
+                                              continuous.type()))};
+    std::array<std::vector<char>, 2> compressed;
+    std::array<feature_section, 2>   sections{};
+
+    std::uint64_t end =
+        sizeof(feature_header) + sizeof(sections) + source_path.size();
+    for (std::size_t s = 0; s < raw.size(); ++s) {
+        if (compress && raw[s].second > 0)
+            compressed[s] = lz4_compress(raw[s].first, raw[s].second);
+        sections[s].offset = align(end, section_alignment);
+        sections[s].bytes =
+            compressed[s].empty() ? raw[s].second : compressed[s].size();
+        end = sections[s].offset + sections[s].bytes;
+    }
+
+    // The padding between the sections stays zero.
+    std::vector<char> encoded(end, '\0');
+    std::memcpy(encoded.data(), &header, sizeof(header));
+    std::memcpy(encoded.data() + sizeof(header), sections.data(),
+                sizeof(sections));
+    std::copy(source_path.begin(), source_path.end(),
+              encoded.begin() + sizeof(header) + sizeof(sections));
+    for (std::size_t s = 0; s < raw.size(); ++s) {
+        const char* data =
+            compressed[s].empty() ? raw[s].first : compressed[s].data();
+        if (sections[s].bytes > 0)
+            std::memcpy(encoded.data() + sections[s].offset, data,
+                        sections[s].bytes);
+    }
+    return encoded;
+}
+}  // namespace detail
+
+bool is_binary_feature_path(std::string_view path) noexcept {
+    return path.size() > feature_extension.size() &&
+           path.substr(path.size() - feature_extension.size()) ==
+               feature_extension;
+}
+
+feature_file::feature_file(const std::string& path) {
+    if (!is_binary_feature_path(path)) {
+        _yaml.open(path, cv::FileStorage::READ | cv::FileStorage::FORMAT_YAML);
+        return;
+    }
+    if (std::optional<mapped_file> file = mapped_file::open(path)) {
+        _file = std::make_shared<const mapped_file>(std::move(*file));
+        parse_binary(_file->data(), _file->size());
+    }
+}
+
+feature_file::feature_file(std::shared_ptr<const mapped_file> file,
+                           const char*                        data,
+                           std::size_t                        size) noexcept
+    : _file{std::move(file)} {
+    if (data != nullptr)
+        parse_binary(data, size);
+}
+
+bool feature_file::parse_binary(const char* data, std::size_t size) noexcept {
+    try {
+        const std::uint64_t table_end =
+            sizeof(feature_header) + sizeof(_sections);
+        if (size < table_end)
+            return false;
+
+        feature_header header{};
+        std::memcpy(&header, data, sizeof(header));
+        const auto codec = static_cast<block_codec>(header.codec);
+        if (header.magic != feature_magic || header.keypoints < 0 ||
+            header.rows < 0 || header.cols < 0 ||
+            (codec != block_codec::none && codec != block_codec::lz4))
+            return false;
+
+        std::array<detail::feature_section, 2> sections{};
+        std::memcpy(sections.data(), data + sizeof(header), sizeof(sections));
+
+        if (header.source_bytes > size - table_end)
+            return false;
+        for (const detail::feature_section& s : sections) {
+            if (s.offset > size || s.bytes > size - s.offset)
+                return false;
+        }
+
+        _keypoint_count = header.keypoints;
+        _rows           = header.rows;
+        _cols           = header.cols;
+        _type           = header.type;
+        _source_path.assign(data + table_end, header.source_bytes);
+        _sections = sections;
+        _data     = data;
+        return true;
+    } catch (...) { return false; }
+}
+
+bool feature_file::is_open() const noexcept {
+    return _data != nullptr || _yaml.isOpened();
+}
+
+bool feature_file::read_section(const detail::feature_section& s,
+                                char*                          raw,
+                                std::uint64_t raw_bytes) const noexcept {
+    if (_data == nullptr)
+        return false;
+    const char* stored = _data + s.offset;
+    if (s.bytes == raw_bytes) {
+        std::copy(stored, stored + raw_bytes, raw);
+        return true;
+    }
+    // Only compressed sections are smaller than the raw data.
+    return s.bytes < raw_bytes &&
+           lz4_decompress(stored, s.bytes, raw, raw_bytes);
+}
+
+std::string feature_file::source_path() const {
+    if (_data != nullptr)
+        return _source_path;
+
+    std::string source;
+    cv::read(_yaml["source_path"], source, "");
+    return source;
+}
+
+std::vector<cv::KeyPoint> feature_file::keypoints() const {
+    if (_data == nullptr)
+        return load_keypoints(_yaml);
+
+    std::vector<keypoint_record> records(_keypoint_count);
+    if (!read_section(_sections[keypoint_section],
+                      reinterpret_cast<char*>(records.data()),
+                      records.size() * sizeof(keypoint_record)))
+        return {};
+
+    std::vector<cv::KeyPoint> k;
+    k.reserve(records.size());
+    for (const keypoint_record& r : records)
+        k.emplace_back(r.x, r.y, r.size, r.angle, r.response, r.octave,
+                       r.class_id);
+    return k;
+}
+
+cv::Mat feature_file::descriptors() const {
+    if (_data == nullptr)
+        return load_descriptors(_yaml);
+    if (_rows == 0 || _cols == 0)
+        return {};
+
+    cv::Mat d(_rows, _cols, _type);
+    if (!read_section(_sections[descriptor_section], d.ptr<char>(),
+                      descriptor_bytes(_rows, _cols, _type)))
+        return {};
+    return d;
+}
+
+bool write_features(const std::string&               path,
+                    const std::string&               source_path,
+                    const std::vector<cv::KeyPoint>& keypoints,
+                    const cv::Mat&                   descriptors,
+                    block_codec                      codec) noexcept {
+    try {
+        if (is_binary_feature_path(path))
+            return write_binary(path, source_path, keypoints, descriptors,
+                                codec);
+        return write_yaml(path, source_path, keypoints, descriptors);
+    } catch (...) { return false; }
+}
+
+}  // namespace sens_loc::io
@@ -0,0 +1,166 @@
+#include <array>
+#include <cstring>
+#include <sens_loc/io/feature_store.h>
+#include <utility>
+
+namespace sens_loc::io {
+
+namespace {
+constexpr std::array<char, 8> store_magic = {'S', 'L', 'F', 'S',
+                                             'E', 'Q', '0', '1'};
+constexpr std::string_view    store_extension = ".slfseq";
+/// Frames are aligned like the sections within a binary feature file.
+constexpr std::uint64_t frame_alignment = 64UL;
+
+struct store_header {
+    std::array<char, 8> magic;
+    std::int32_t        first;
+    std::int32_t        count;
+};
+
+constexpr std::uint64_t align(std::uint64_t bytes,
+                              std::uint64_t alignment) noexcept {
+    return (bytes + alignment - 1UL) / alignment * alignment;
+}
+}  // namespace
+
+bool is_feature_store_path(std::string_view path) noexcept {
+    return path.size() > store_extension.size() &&
+           path.substr(path.size() - store_extension.size()) ==
+               store_extension;
+}
+
+std::optional<feature_store>
+feature_store::open(const std::string& path) noexcept {
+    try {
+        std::optional<mapped_file> file = mapped_file::open(path);
+        if (!file || file->size() < sizeof(store_header))
+            return std::nullopt;
+
+        store_header header{};
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != store_magic || header.count <= 0)
+            return std::nullopt;
+
+        const std::uint64_t size = file->size();
+        const std::uint64_t index_bytes =
+            std::uint64_t(header.count) * sizeof(detail::feature_section);
+        if (sizeof(header) + index_bytes > size)
+            return std::nullopt;
+
+        feature_store s{std::make_shared<const mapped_file>(std::move(*file))};
+        s._first = header.first;
+        s._index.resize(header.count);
+        std::memcpy(s._index.data(), s._file->data() + sizeof(header),
+                    index_bytes);
+
+        for (const detail::feature_section& e : s._index) {
+            if (e.offset > size || e.bytes > size - e.offset)
+                return std::nullopt;
+        }
+        return s;
+    } catch (...) { return std::nullopt; }
+}
+
+bool feature_store::contains(int idx) const noexcept {
+    return idx >= first() && idx <= last() && _index[idx - first()].bytes > 0;
+}
+
+feature_file feature_store::frame(int idx) const {
+    if (!contains(idx))
+        return {};
+
+    const detail::feature_section& e = _index[idx - first()];
+    return feature_file{_file, _file->data() + e.offset, e.bytes};
+}
+
+feature_store_writer::feature_store_writer(std::ofstream out,
+                                           int           first,
+                                           int           last,
+                                           block_codec   codec)
+    : _out{std::move(out)}
+    , _first{first}
+    , _codec{codec}
+    , _index(last - first + 1, detail::feature_section{0UL, 0UL})
+    , _end{header_bytes()} {}
+
+std::uint64_t feature_store_writer::header_bytes() const noexcept {
+    return sizeof(store_header) +
+           _index.size() * sizeof(detail::feature_section);
+}
+
+std::optional<feature_store_writer>
+feature_store_writer::create(const std::string& path,
+                             int                first,
+                             int                last,
+                             block_codec        codec) noexcept {
+    try {
+        if (last < first)
+            return std::nullopt;
+
+        std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+        if (!out)
+            return std::nullopt;
+
+        feature_store_writer writer{std::move(out), first, last, codec};
+        // Reserve the space for header and index, they are written by
+        // 'finish'.
+        const std::vector<char> placeholder(writer._end, '\0');
+        writer._out.write(placeholder.data(), placeholder.size());
+        if (!writer._out)
+            return std::nullopt;
+        return writer;
+    } catch (...) { return std::nullopt; }
+}
+
+bool feature_store_writer::append(
+    int                              idx,
+    const std::string&               source_path,
+    const std::vector<cv::KeyPoint>& keypoints,
+    const cv::Mat&                   descriptors) noexcept {
+    try {
+        if (idx < _first || idx >= _first + static_cast<int>(_index.size()))
+            return false;
+
+        // Encoding and compression happen outside of the lock.
+        const std::vector<char> encoded = detail::encode_features(
+            source_path, keypoints, descriptors, _codec);
+
+        std::lock_guard guard{*_lock};
+        detail::feature_section& e = _index[idx - _first];
+        if (e.bytes > 0)
+            return false;
+
+        const std::uint64_t     begin = align(_end, frame_alignment);
+        const std::vector<char> padding(begin - _end, '\0');
+        _out.write(padding.data(), padding.size());
+        _out.write(encoded.data(), encoded.size());
+        if (!_out)
+            return false;
+
+        e.offset = begin;
+        e.bytes  = encoded.size();
+        _end     = begin + e.bytes;
+        return true;
+    } catch (...) { return false; }
+}
+
+bool feature_store_writer::finish() noexcept {
+    try {
+        std::lock_guard guard{*_lock};
+
+        store_header header{};
+        header.magic = store_magic;
+        header.first = _first;
+        header.count = static_cast<std::int32_t>(_index.size());
+
+        _out.seekp(0);
+        _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _out.write(reinterpret_cast<const char*>(_index.data()),
+                   _index.size() * sizeof(detail::feature_section));
+        _out.flush();
+        return _out.good();
+    } catch (...) { return false; }
+}
+
+}  // namespace sens_loc::io
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <opencv2/core.hpp>
+#include <sens_loc/io/compression.h>
+#include <sens_loc/io/image.h>
+#include <vector>
+
+namespace sens_loc::io {
+
+namespace {
+/// Layout of the tile format, all values in host byte order:
+/// ```
+/// char[8]  magic "SLTILES1"
+/// int32    rows, cols, type, rows per tile, codec
+/// uint64   stored bytes of each tile [number of tiles]
+/// byte     data of the tiles
+/// ```
+/// A tile whose stored size matches its raw size is not compressed.
+constexpr std::array<char, 8> tile_magic = {'S', 'L', 'T', 'I',
+                                            'L', 'E', 'S', '1'};
+
+struct tile_header {
+    std::int32_t rows;
+    std::int32_t cols;
+    std::int32_t type;
+    std::int32_t tile_rows;
+    std::int32_t codec;
+};
+
+bool ends_with(std::string_view path, std::string_view extension) noexcept {
+    if (path.size() < extension.size())
+        return false;
+    return std::equal(extension.rbegin(), extension.rend(), path.rbegin(),
+                      [](char e, char p) {
+                          return e == (p >= 'A' && p <= 'Z' ? p - 'A' + 'a'
+                                                            : p);
+                      });
+}
+
+int number_of_tiles(int rows, int tile_rows) noexcept {
+    return (rows + tile_rows - 1) / tile_rows;
+}
+
+bool write_tiles(const std::string&   path,
+                 const cv::Mat&       img,
+                 const write_options& options) {
+    if (img.empty() || options.tile_rows <= 0)
+        return false;
+
+    // Tiles are consecutive rows, that requires continuous memory.
+    const cv::Mat continuous = img.isContinuous() ? img : img.clone();
+    const std::size_t row_bytes = continuous.cols * continuous.elemSize();
+
+    const bool compress =
+        options.tile_compression == block_codec::lz4 && lz4_available();
+    const block_codec codec = compress ? block_codec::lz4 : block_codec::none;
+    const tile_header header{continuous.rows, continuous.cols,
+                             continuous.type(), options.tile_rows,
+                             static_cast<std::int32_t>(codec)};
+
+    const int tiles = number_of_tiles(header.rows, header.tile_rows);
+    std::vector<std::uint64_t>     sizes(tiles);
+    std::vector<std::vector<char>> compressed(compress ? tiles : 0);
+
+    for (int t = 0; t < tiles; ++t) {
+        const int rows =
+            std::min(header.tile_rows, header.rows - t * header.tile_rows);
+        const std::size_t raw_bytes = rows * row_bytes;
+        sizes[t]                    = raw_bytes;
+
+        // Incompressible tiles are stored raw.
+        if (compress) {
+            compressed[t] = lz4_compress(
+                continuous.ptr<char>(t * header.tile_rows), raw_bytes);
+            if (!compressed[t].empty())
+                sizes[t] = compressed[t].size();
+        }
+    }
+
+    std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+    out.write(tile_magic.data(), tile_magic.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sizes.data()),
+              sizes.size() * sizeof(std::uint64_t));
+    for (int t = 0; t < tiles; ++t) {
+        if (compress && !compressed[t].empty())
+            out.write(compressed[t].data(), sizes[t]);
+        else
+            out.write(continuous.ptr<char>(t * header.tile_rows), sizes[t]);
+    }
+    return out.good();
+}
+
+cv::Mat read_tiles(const std::string& path) {
+    std::ifstream in(path, std::ios_base::binary);
+
+    std::array<char, 8> magic{};
+    tile_header         header{};
+    in.read(magic.data(), magic.size());
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || magic != tile_magic || header.rows <= 0 || header.cols <= 0 ||
+        header.tile_rows <= 0)
+        return {};
+
+    const auto codec = static_cast<block_codec>(header.codec);
+    if (codec != block_codec::none && codec != block_codec::lz4)
+        return {};
+
+    const int tiles = number_of_tiles(header.rows, header.tile_rows);
+    std::vector<std::uint64_t> sizes(tiles);
+    in.read(reinterpret_cast<char*>(sizes.data()),
+            sizes.size() * sizeof(std::uint64_t));
+    if (!in)
+        return {};
+
+    cv::Mat           result(header.rows, header.cols, header.type);
+    const std::size_t row_bytes = result.cols * result.elemSize();
+
+    for (int t = 0; t < tiles; ++t) {
+        const int rows =
+            std::min(header.tile_rows, header.rows - t * header.tile_rows);
+        const std::size_t raw_bytes = rows * row_bytes;
+        char*             raw       = result.ptr<char>(t * header.tile_rows);
+
+        if (sizes[t] == raw_bytes) {
+            in.read(raw, raw_bytes);
+        } else if (codec == block_codec::lz4 && sizes[t] < raw_bytes) {
+            std::vector<char> buffer(sizes[t]);
+            in.read(buffer.data(), sizes[t]);
+            if (!in || !lz4_decompress(buffer.data(), sizes[t], raw, raw_bytes))
+                return {};
+        } else
+            return {};
+
+        if (!in)
+            return {};
+    }
+    return result;
+}
+}  // namespace
+
+image_format format_from_path(std::string_view path) noexcept {
+    if (ends_with(path, ".png"))
+        return image_format::png;
+    if (ends_with(path, ".pgm") || ends_with(path, ".ppm") ||
+        ends_with(path, ".pnm"))
+        return image_format::pnm;
+    if (ends_with(path, ".pfm"))
+        return image_format::pfm;
+    if (ends_with(path, ".slt"))
+        return image_format::tiles;
+    return image_format::other;
+}
+
+bool write_image(const std::string&   path,
+                 const cv::Mat&       img,
+                 const write_options& options) noexcept {
+    try {
+        switch (format_from_path(path)) {
+        case image_format::png: {
+            if (!options.png_compression && !options.png_strategy)
+                return cv::imwrite(path, img);
+
+            // The strategy must follow the level, because setting the level
+            // resets the strategy in OpenCV.
+            std::vector<int> params;
+            if (options.png_compression)
+                params.insert(params.end(), {cv::IMWRITE_PNG_COMPRESSION,
+                                             *options.png_compression});
+            if (options.png_strategy)
+                params.insert(params.end(), {cv::IMWRITE_PNG_STRATEGY,
+                                             *options.png_strategy});
+            return cv::imwrite(path, img, params);
+        }
+        case image_format::pnm:
+            return cv::imwrite(path, img, {cv::IMWRITE_PXM_BINARY, 1});
+        case image_format::pfm: {
+            if (img.depth() == CV_32F)
+                return cv::imwrite(path, img);
+            cv::Mat floating;
+            img.convertTo(floating, CV_32F);
+            return cv::imwrite(path, floating);
+        }
+        case image_format::tiles: return write_tiles(path, img, options);
+        case image_format::other: return cv::imwrite(path, img);
+        }
+        return false;
+    } catch (...) { return false; }
+}
+
+cv::Mat read_image(const std::string& path, int flags) noexcept {
+    try {
+        if (format_from_path(path) == image_format::tiles)
+            return read_tiles(path);
+        return cv::imread(path, flags);
+    } catch (...) { return {}; }
+}
+
+}  // namespace sens_loc::io
@@ -0,0 +1,53 @@
+#include <fcntl.h>
+#include <sens_loc/io/mapped_file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace sens_loc::io {
+
+std::optional<mapped_file> mapped_file::open(const std::string& path) noexcept {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return std::nullopt;
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void*      data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return std::nullopt;
+
+    return mapped_file(static_cast<const char*>(data), size);
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : _data{std::exchange(other._data, nullptr)}
+    , _size{std::exchange(other._size, 0UL)} {}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0UL);
+    }
+    return *this;
+}
+
+mapped_file::~mapped_file() { unmap(); }
+
+void mapped_file::unmap() noexcept {
+    if (_data != nullptr)
+        ::munmap(const_cast<char*>(_data), _size);
+    _data = nullptr;
+    _size = 0UL;
+}
+
+}  // namespace sens_loc::io
@@ -1,9 +1,72 @@
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <sens_loc/io/pose.h>
 #include <sstream>
 #include <string>
 
 namespace sens_loc::io {
+
+namespace {
+/// \returns \c false if the affine transformation is not only a rotation and
+/// translation, but includes shearing. This is not allowed for a pose!
+bool is_rigid(const math::pose_t& p) noexcept {
+    // Note: arguments are: 'block(startRow, startCol, blockRows, blockCols)'
+    return std::abs(std::abs(p.block<3, 3>(0, 0).determinant()) - 1.0F) <=
+           0.0001F;
+}
+
+/// \returns \c true if the line carries no data.
+bool skip_line(const std::string& line) noexcept {
+    const auto first = line.find_first_not_of(" \t\r");
+    return first == std::string::npos || line[first] == '#';
+}
+
+/// Parse exactly \c N whitespace separated numbers from \p line.
+/// Trajectories have tens of thousands of lines, therefore \c strtod is used
+/// instead of a \c stringstream per line.
+template <std::size_t N>
+bool parse_numbers(const std::string& line, std::array<double, N>& values) {
+    const char* pos = line.c_str();
+    for (double& v : values) {
+        char* end = nullptr;
+        v         = std::strtod(pos, &end);
+        if (end == pos)
+            return false;
+        pos = end;
+    }
+    while (*pos == ' ' || *pos == '\t' || *pos == '\r')
+        ++pos;
+    return *pos == '\0';
+}
+
+std::optional<math::pose_t> tum_pose(const std::array<double, 8>& v) {
+    const Eigen::Quaternionf q{float(v[7]), float(v[4]), float(v[5]),
+                               float(v[6])};
+    // Quaternions with a norm of zero are no rotation at all.
+    if (q.norm() < 0.0001F)
+        return std::nullopt;
+
+    math::pose_t p      = math::pose_t::Identity();
+    p.block<3, 3>(0, 0) = q.normalized().toRotationMatrix();
+    p.block<3, 1>(0, 3) =
+        Eigen::Vector3f{float(v[1]), float(v[2]), float(v[3])};
+    return p;
+}
+
+math::pose_t kitti_pose(const std::array<double, 12>& v) {
+    math::pose_t p = math::pose_t::Identity();
+    for (int row = 0; row < 3; ++row)
+        for (int col = 0; col < 4; ++col)
+            p(row, col) = float(v[row * 4 + col]);
+    return p;
+}
+}  // namespace
+
 std::optional<math::pose_t> load_pose(std::istream& in) noexcept {
     using std::ios_base;
     using std::nullopt;
@@ -29,15 +92,97 @@ std::optional<math::pose_t> load_pose(std::istream& in) noexcept {
     if (line_nbr != 3)
         return nullopt;
 
-    // The affine transformation is not only a rotation and translation, but
-    // includes shearing. This is not allowed for a pose!
-    // Note: arguments are: 'block(startRow, startCol, blockRows, blockCols)'
-    if (std::abs(std::abs(p.block<3, 3>(0, 0).determinant()) - 1.0F) >
-        0.0001F) {
+    if (!is_rigid(p)) {
         std::cerr << "Bad Rotation matrix\n";
         return nullopt;
     }
 
     return p;
 }
+
+std::optional<trajectory> load_trajectory(std::istream&     in,
+                                          trajectory_format format) noexcept {
+    using std::nullopt;
+
+    if (!in.good())
+        return nullopt;
+
+    trajectory t;
+    for (std::string line; getline(in, line);) {
+        if (skip_line(line))
+            continue;
+
+        std::optional<math::pose_t> p;
+        if (format == trajectory_format::tum) {
+            std::array<double, 8> values{};
+            if (!parse_numbers(line, values))
+                return nullopt;
+            if (!t.timestamps.empty() && values[0] < t.timestamps.back())
+                return nullopt;
+            p = tum_pose(values);
+            t.timestamps.push_back(values[0]);
+        } else {
+            std::array<double, 12> values{};
+            if (!parse_numbers(line, values))
+                return nullopt;
+            p = kitti_pose(values);
+        }
+
+        if (!p || !is_rigid(*p))
+            return nullopt;
+        t.poses.push_back(*p);
+    }
+    return t;
+}
+
+std::optional<std::vector<double>> load_timestamps(std::istream& in) noexcept {
+    if (!in.good())
+        return std::nullopt;
+
+    std::vector<double> timestamps;
+    for (std::string line; getline(in, line);) {
+        if (skip_line(line))
+            continue;
+
+        const char* begin = line.c_str();
+        char*       end   = nullptr;
+        const double t    = std::strtod(begin, &end);
+        if (end == begin)
+            return std::nullopt;
+        timestamps.push_back(t);
+    }
+    return timestamps;
+}
+
+std::optional<std::vector<math::pose_t>>
+associate_poses(const trajectory&       t,
+                gsl::span<const double> frame_times,
+                double                  max_difference) noexcept {
+    Expects(t.timestamps.size() == t.poses.size());
+    Expects(max_difference >= 0.0);
+
+    std::vector<math::pose_t> poses;
+    poses.reserve(frame_times.size());
+
+    for (double frame_time : frame_times) {
+        // The first pose at or after the frame and its predecessor are the
+        // candidates for the closest pose.
+        auto closest = std::lower_bound(t.timestamps.begin(),
+                                        t.timestamps.end(), frame_time);
+        if (closest != t.timestamps.begin() &&
+            (closest == t.timestamps.end() ||
+             frame_time - *std::prev(closest) <= *closest - frame_time))
+            --closest;
+
+        if (closest == t.timestamps.end() ||
+            std::abs(*closest - frame_time) > max_difference)
+            return std::nullopt;
+        poses.push_back(t.poses[gsl::narrow_cast<std::size_t>(
+            closest - t.timestamps.begin())]);
+    }
+
+    Ensures(poses.size() == gsl::narrow_cast<std::size_t>(frame_times.size()));
+    return poses;
+}
+
 }  // namespace sens_loc::io
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sens_loc/io/compression.h>
+#include <sens_loc/io/sequence.h>
+#include <utility>
+
+namespace sens_loc::io {
+
+namespace {
+constexpr std::array<char, 8> sequence_magic = {'S', 'L', 'S', 'E',
+                                                'Q', '0', '0', '1'};
+constexpr std::string_view    sequence_extension = ".slseq";
+/// Payloads are aligned for the zero-copy views.
+constexpr std::uint64_t payload_alignment = 64UL;
+
+struct sequence_header {
+    std::array<char, 8> magic;
+    std::int32_t        rows;
+    std::int32_t        cols;
+    std::int32_t        type;
+    std::int32_t        codec;
+    std::int32_t        first;
+    std::int32_t        count;
+    std::uint64_t       intrinsic_bytes;
+};
+
+constexpr std::uint64_t align(std::uint64_t bytes,
+                              std::uint64_t alignment) noexcept {
+    return (bytes + alignment - 1UL) / alignment * alignment;
+}
+
+std::uint64_t index_offset(std::uint64_t intrinsic_bytes) noexcept {
+    return align(sizeof(sequence_header) + intrinsic_bytes,
+                 sizeof(std::uint64_t));
+}
+}  // namespace
+
+bool is_sequence_path(std::string_view path) noexcept {
+    return path.size() > sequence_extension.size() &&
+           path.substr(path.size() - sequence_extension.size()) ==
+               sequence_extension;
+}
+
+std::optional<depth_sequence>
+depth_sequence::open(const std::string& path) noexcept {
+    try {
+        std::optional<mapped_file> file = mapped_file::open(path);
+        if (!file || file->size() < sizeof(sequence_header))
+            return std::nullopt;
+
+        sequence_header header{};
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != sequence_magic || header.rows <= 0 ||
+            header.cols <= 0 || header.count <= 0)
+            return std::nullopt;
+
+        const auto codec = static_cast<block_codec>(header.codec);
+        if (codec != block_codec::none && codec != block_codec::lz4)
+            return std::nullopt;
+
+        const std::uint64_t size = file->size();
+        if (header.intrinsic_bytes > size)
+            return std::nullopt;
+        const std::uint64_t index_begin = index_offset(header.intrinsic_bytes);
+        const std::uint64_t index_bytes =
+            std::uint64_t(header.count) * sizeof(detail::sequence_entry);
+        if (index_begin + index_bytes > size)
+            return std::nullopt;
+
+        depth_sequence s{std::move(*file)};
+        s._rows  = header.rows;
+        s._cols  = header.cols;
+        s._type  = header.type;
+        s._first = header.first;
+        s._codec = codec;
+        s._intrinsic.assign(s._file.data() + sizeof(sequence_header),
+                            header.intrinsic_bytes);
+        s._index.resize(header.count);
+        std::memcpy(s._index.data(), s._file.data() + index_begin,
+                    index_bytes);
+
+        const std::uint64_t raw_bytes =
+            std::uint64_t(s._rows) * s._cols * CV_ELEM_SIZE(s._type);
+        for (const detail::sequence_entry& e : s._index) {
+            if (e.bytes > raw_bytes || e.offset > size ||
+                e.bytes > size - e.offset)
+                return std::nullopt;
+        }
+        return s;
+    } catch (...) { return std::nullopt; }
+}
+
+bool depth_sequence::contains(int idx) const noexcept {
+    return idx >= first() && idx <= last() && _index[idx - first()].bytes > 0;
+}
+
+cv::Mat depth_sequence::frame(int idx) const noexcept {
+    try {
+        if (!contains(idx))
+            return {};
+
+        const detail::sequence_entry& e       = _index[idx - first()];
+        const char*                   payload = _file.data() + e.offset;
+        const std::uint64_t           raw_bytes =
+            std::uint64_t(_rows) * _cols * CV_ELEM_SIZE(_type);
+
+        // The mapping is read-only, the view must not be written to.
+        if (e.bytes == raw_bytes)
+            return cv::Mat(_rows, _cols, _type, const_cast<char*>(payload));
+
+        if (_codec != block_codec::lz4)
+            return {};
+        cv::Mat decoded(_rows, _cols, _type);
+        if (!lz4_decompress(payload, e.bytes, decoded.ptr<char>(), raw_bytes))
+            return {};
+        return decoded;
+    } catch (...) { return {}; }
+}
+
+sequence_writer::sequence_writer(std::ofstream out,
+                                 int           first,
+                                 int           last,
+                                 std::string   intrinsic,
+                                 block_codec   codec)
+    : _out{std::move(out)}
+    , _first{first}
+    , _codec{codec}
+    , _intrinsic{std::move(intrinsic)}
+    , _index(last - first + 1, detail::sequence_entry{0UL, 0UL})
+    , _end{header_bytes()} {}
+
+std::uint64_t sequence_writer::header_bytes() const noexcept {
+    return index_offset(_intrinsic.size()) +
+           _index.size() * sizeof(detail::sequence_entry);
+}
+
+std::optional<sequence_writer>
+sequence_writer::create(const std::string& path,
+                        int                first,
+                        int                last,
+                        const std::string& intrinsic,
+                        block_codec        codec) noexcept {
+    try {
+        if (last < first)
+            return std::nullopt;
+
+        std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+        if (!out)
+            return std::nullopt;
+
+        sequence_writer writer{std::move(out), first, last, intrinsic,
+                               lz4_available() ? codec : block_codec::none};
+        // Reserve the space for header and index, they are written by
+        // 'finish'.
+        const std::vector<char> placeholder(writer._end, '\0');
+        writer._out.write(placeholder.data(), placeholder.size());
+        if (!writer._out)
+            return std::nullopt;
+        return writer;
+    } catch (...) { return std::nullopt; }
+}
+
+bool sequence_writer::append(int idx, const cv::Mat& frame) noexcept {
+    try {
+        if (idx < _first || idx >= _first + static_cast<int>(_index.size()) ||
+            frame.empty())
+            return false;
+        detail::sequence_entry& e = _index[idx - _first];
+        if (e.bytes > 0)
+            return false;
+
+        if (_type < 0) {
+            _rows = frame.rows;
+            _cols = frame.cols;
+            _type = frame.type();
+        } else if (frame.rows != _rows || frame.cols != _cols ||
+                   frame.type() != _type)
+            return false;
+
+        const cv::Mat       continuous = frame.isContinuous() ? frame
+                                                              : frame.clone();
+        const std::uint64_t raw_bytes =
+            std::uint64_t(_rows) * _cols * CV_ELEM_SIZE(_type);
+
+        std::vector<char> compressed;
+        if (_codec == block_codec::lz4)
+            compressed = lz4_compress(continuous.ptr<char>(), raw_bytes);
+
+        const std::uint64_t begin = align(_end, payload_alignment);
+        const std::vector<char> padding(begin - _end, '\0');
+        _out.write(padding.data(), padding.size());
+        if (compressed.empty())
+            _out.write(continuous.ptr<char>(), raw_bytes);
+        else
+            _out.write(compressed.data(), compressed.size());
+        if (!_out)
+            return false;
+
+        e.offset = begin;
+        e.bytes  = compressed.empty() ? raw_bytes : compressed.size();
+        _end     = begin + e.bytes;
+        return true;
+    } catch (...) { return false; }
+}
+
+bool sequence_writer::finish() noexcept {
+    try {
+        // Without any frame the resolution of the sequence is unknown.
+        if (_type < 0)
+            return false;
+
+        sequence_header header{};
+        header.magic           = sequence_magic;
+        header.rows            = _rows;
+        header.cols            = _cols;
+        header.type            = _type;
+        header.codec           = static_cast<std::int32_t>(_codec);
+        header.first           = _first;
+        header.count           = static_cast<std::int32_t>(_index.size());
+        header.intrinsic_bytes = _intrinsic.size();
+
+        _out.seekp(0);
+        _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _out.write(_intrinsic.data(), _intrinsic.size());
+        const std::vector<char> padding(
+            index_offset(_intrinsic.size()) - sizeof(header) -
+                _intrinsic.size(),
+            '\0');
+        _out.write(padding.data(), padding.size());
+        _out.write(reinterpret_cast<const char*>(_index.data()),
+                   _index.size() * sizeof(detail::sequence_entry));
+        _out.flush();
+        return _out.good();
+    } catch (...) { return false; }
+}
+
+}  // namespace sens_loc::io
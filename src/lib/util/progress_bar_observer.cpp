@@ -1,8 +1,14 @@
 #include <sens_loc/util/progress_bar_observer.h>
 
 namespace sens_loc::util {
+bool progress_bar_observer::is_counted(const tf::TaskView& task_view) const {
+    return _counted_task.empty() || task_view.name() == _counted_task;
+}
+
 void progress_bar_observer::on_entry(unsigned /*worker_id*/,
-                                     tf::TaskView /*task_view*/) {
+                                     tf::TaskView task_view) {
+    if (!is_counted(task_view))
+        return;
     if (!_inital_output) {
         _inital_output = true;
         print_bar(/*increment=*/false);
@@ -10,7 +16,9 @@ void progress_bar_observer::on_entry(unsigned /*worker_id*/,
 }
 
 void progress_bar_observer::on_exit(unsigned /*worker_id*/,
-                                    tf::TaskView /*task_view*/) {
+                                    tf::TaskView task_view) {
+    if (!is_counted(task_view))
+        return;
     print_bar(/*increment=*/true);
 }
 
@@ -55,6 +55,23 @@ if  [ ! -f batch-flexion-002.png ] || \
     exit 1
 fi
 
+# Floating point output stores the flexion without scaling.
+if ! ${exe} -c "kinect_intrinsic.txt" \
+    -i "data{}-depth.png" \
+    -s 0 -e 1 \
+    flexion \
+    --output "batch-flexion-{}.pfm"
+then
+    print_error "Could not create floating point flexion images."
+    exit 1
+fi
+
+if  [ ! -f batch-flexion-0.pfm ] || \
+    [ ! -f batch-flexion-1.pfm ]; then
+    print_error "Did not create expected floating point output files."
+    exit 1
+fi
+
 # Test that equirectangular images are converted properly as well
 if ! ${exe} \
     -m "equirectangular" \
@@ -31,3 +31,18 @@ if  [ ! -f agast-0.feat ] || \
     print_error "Did not create expected output files."
     exit 1
 fi
+
+if ! ${exe} \
+   -i "flexion-{}.png" \
+   -o "agast-anms-{}.feat" \
+   -s 0 -e 1 \
+   detector --anms-count 500 agast \
+   descriptor null ; then
+    print_error "AGAST keypoints with ANMS did not work"
+    exit 1
+fi
+if  [ ! -f agast-anms-0.feat ] || \
+    [ ! -f agast-anms-1.feat ]; then
+    print_error "Did not create expected output files."
+    exit 1
+fi
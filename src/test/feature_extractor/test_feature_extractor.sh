@@ -46,5 +46,42 @@ if  [ ! -f compressed-0.feat.gz ] || \
     exit 1
 fi
 
+rm -f binary-*
+if ! ${exe} -i "flexion-{}.png" -s 0 -e 1 \
+     -o "binary-{}.slfeat" --compression lz4 \
+     detector orb descriptor orb ; then
+    print_error "Writing binary feature files failed"
+    exit 1
+fi
+if  [ ! -f binary-0.slfeat ] || \
+    [ ! -f binary-1.slfeat ] ; then
+    print_error "Did not create expected output files."
+    exit 1
+fi
+
+rm -f store.slfseq
+if ! ${exe} -i "flexion-{}.png" -s 0 -e 1 -o "store.slfseq" \
+     detector orb descriptor orb ; then
+    print_error "Writing a feature store failed"
+    exit 1
+fi
+if  [ ! -f store.slfseq ] ; then
+    print_error "Did not create the feature store."
+    exit 1
+fi
+
+rm -f tiled-*
+if ! ${exe} -i "flexion-{}.png" -s 0 -e 1 -o "tiled-{}.slfeat" \
+     detector --tiles 3 --tile-overlap 31 --kp-count 900 orb \
+     descriptor orb ; then
+    print_error "Tiled detection failed"
+    exit 1
+fi
+if  [ ! -f tiled-0.slfeat ] || \
+    [ ! -f tiled-1.slfeat ] ; then
+    print_error "Did not create expected output files."
+    exit 1
+fi
+
 print_info "Test successful!"
 exit 0
@@ -28,6 +28,38 @@ if ! ${exe} --input "orb-{}.feat" \
     exit 1
 fi
 
+print_info "Test matching with the ratio test"
+if ! ${exe} --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    matching \
+    --match-strategy ratio-crosscheck --match-ratio 0.7 ; then
+    print_error "Could not analyze surf matching with the ratio test"
+    exit 1
+fi
+if ${exe} --input "orb-{}.feat" \
+    --start 0 --end 1 \
+    matching \
+    --distance-norm HAMMING --no-crosscheck --match-strategy ratio ; then
+    print_error "Did not reject conflicting match strategies"
+    exit 1
+fi
+
+print_info "Test approximate matching"
+if ! ${exe} --input "orb-{}.feat" \
+    --start 0 --end 1 \
+    matching \
+    --distance-norm HAMMING --matcher ann --ann-recall-sample 1 ; then
+    print_error "Could not analyze approximate orb matching"
+    exit 1
+fi
+if ! ${exe} --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    matching \
+    --matcher ann --hnsw-ef-search 32 --ann-recall-sample 1 ; then
+    print_error "Could not analyze approximate surf matching"
+    exit 1
+fi
+
 print_info "Test if statistic files are written"
 rm -f orb-match.stat
 if ! ${exe} --input "orb-{}.feat" \
@@ -58,6 +90,21 @@ if [ ! -f orb_match_distance.dat ] ; then
     exit 1
 fi
 
+print_info "Test matching with multiple gaps"
+rm -f orb-match-gaps.stat
+if ! ${exe} --input "orb-{}.feat" \
+    --start 0 --end 1 \
+    --output orb-match-gaps.stat \
+    matching \
+    --distance-norm HAMMING --gap 1 --gap 2 ; then
+    print_error "Could not analyze orb matching with multiple gaps"
+    exit 1
+fi
+if [ ! -f orb-match-gaps.stat ] ; then
+    print_error "Expected statistic file for orb matching with gaps"
+    exit 1
+fi
+
 rm -f surf-matched-1.png
 if ! ${exe} \
     --input "surf-1-octave-{}.feat.gz" \
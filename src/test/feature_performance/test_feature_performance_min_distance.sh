@@ -26,6 +26,15 @@ if ! ${exe} --input "orb-{}.feat" \
     exit 1
 fi
 
+print_info "Test exact statistics"
+if ! ${exe} --input "sift-{}.feat" \
+    --start 0 --end 1 \
+    --exact-statistics \
+    min-distance --norm L2 ; then
+    print_error "Could not analyze sift features with exact statistics"
+    exit 1
+fi
+
 print_info "Test if statistics are written to file"
 rm -f orb-minimal-distance.stat
 if ! ${exe} --input "orb-{}.feat" \
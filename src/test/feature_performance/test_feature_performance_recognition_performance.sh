@@ -24,6 +24,74 @@ if ! ${exe} \
     exit 1
 fi
 
+print_info "Calculate precision and recall with the ratio test"
+if ! ${exe} \
+    --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    recognition-performance \
+    --depth-image "filtered-{}.png" \
+    --pose-file "pose-{}.pose" \
+    --intrinsic "kinect_intrinsic.txt" \
+    --match-norm "L2" --match-strategy ratio ; then
+    print_error "Could not calculate precision and recall with ratio test"
+    exit 1
+fi
+
+print_info "Calculate precision and recall with the coarse ICP only"
+if ! ${exe} \
+    --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    recognition-performance \
+    --depth-image "filtered-{}.png" \
+    --pose-file "pose-{}.pose" \
+    --intrinsic "kinect_intrinsic.txt" \
+    --match-norm "L2" --icp-coarse-only ; then
+    print_error "Could not calculate precision and recall with coarse ICP"
+    exit 1
+fi
+
+print_info "Read the poses from a KITTI trajectory"
+if ! ${exe} \
+    --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    recognition-performance \
+    --depth-image "filtered-{}.png" \
+    --trajectory "trajectory.kitti" --trajectory-format kitti \
+    --intrinsic "kinect_intrinsic.txt" \
+    --match-norm "L2" ; then
+    print_error "Could not calculate precision and recall with KITTI poses"
+    exit 1
+fi
+
+print_info "Associate the poses of a TUM trajectory by timestamp"
+if ! ${exe} \
+    --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    recognition-performance \
+    --depth-image "filtered-{}.png" \
+    --trajectory "trajectory.tum" \
+    --frame-timestamps "depth_timestamps.txt" \
+    --intrinsic "kinect_intrinsic.txt" \
+    --match-norm "L2" ; then
+    print_error "Could not calculate precision and recall with TUM poses"
+    exit 1
+fi
+
+print_info "Frames without a pose close in time are rejected"
+if ${exe} \
+    --input "surf-1-octave-{}.feat.gz" \
+    --start 0 --end 1 \
+    recognition-performance \
+    --depth-image "filtered-{}.png" \
+    --trajectory "trajectory.tum" \
+    --frame-timestamps "depth_timestamps.txt" \
+    --max-time-difference 0.001 \
+    --intrinsic "kinect_intrinsic.txt" \
+    --match-norm "L2" ; then
+    print_error "Accepted frames without associated pose"
+    exit 1
+fi
+
 print_info "Write the statistics to a file"
 rm -f recognition.stat
 if ! ${exe} \
@@ -0,0 +1,82 @@
+#!/bin/sh
+
+if [ $# -ne 2 ]; then
+    echo "Incorrect call!"
+    exit 1
+fi
+
+exe="$1"
+helpers="$2"
+
+. "${helpers}"
+
+print_info "Using \"${exe}\" as driver executable"
+
+if grep --silent "Precise Pangolin" /etc/os-release ; then
+    print_warning "Skipping Tests on old linux - See #8 for more information!"
+    exit 0
+fi
+
+set -v
+
+print_info "Clearing test directory from old test result files."
+rm -f *.slseq
+
+if ${exe} ; then
+    print_error "Not enough arguments calling not checked"
+    exit 1
+fi
+
+if ${exe} \
+    -i "data{:03d}-depth.png" \
+    -o "depth.png" \
+    -s 2 -e 6 ; then
+    print_error "Output without container extension not detected"
+    exit 1
+fi
+
+if ! ${exe} \
+    -i "data{:03d}-depth.png" \
+    -o "depth.slseq" \
+    --calibration kinect_intrinsic.txt \
+    -s 2 -e 6 ; then
+    print_error "Could not pack the depth images"
+    exit 1
+fi
+
+if [ ! -f depth.slseq ]; then
+    print_error "Did not create the container"
+    exit 1
+fi
+
+# Repack the container itself, it is accepted as input.
+if ! ${exe} \
+    -i "depth.slseq" \
+    -o "depth-raw.slseq" \
+    --compression none \
+    -s 2 -e 6 ; then
+    print_error "Could not repack the container"
+    exit 1
+fi
+
+# Missing input files are reported, but the container is still valid.
+if ${exe} \
+    -i "data{:03d}-depth.png" \
+    -o "depth-missing.slseq" \
+    -s 2 -e 8 ; then
+    print_error "Missing input files not detected"
+    exit 1
+fi
+
+if [ ! -f depth-missing.slseq ]; then
+    print_error "Did not create the container with missing frames"
+    exit 1
+fi
+
+if ! ${exe} --version ; then
+    print_error "Printing the version is required to work"
+    exit 1
+fi
+
+print_info "Test successful!"
+exit 0
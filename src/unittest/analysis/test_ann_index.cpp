@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <opencv2/core/mat.hpp>
+#include <random>
+#include <sens_loc/analysis/ann_index.h>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <vector>
+
+using namespace std;
+using namespace sens_loc::analysis;
+using doctest::Approx;
+
+namespace {
+cv::Mat random_binary(int rows, int bytes, unsigned seed) {
+    mt19937                            gen{seed};
+    uniform_int_distribution<unsigned> byte{0U, 255U};
+    cv::Mat                            d(rows, bytes, CV_8U);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < bytes; ++c)
+            d.ptr<uint8_t>(r)[c] = uint8_t(byte(gen));
+    return d;
+}
+
+cv::Mat random_float(int rows, int cols, unsigned seed) {
+    mt19937                          gen{seed};
+    uniform_real_distribution<float> value{0.0F, 1.0F};
+    cv::Mat                          d(rows, cols, CV_32F);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            d.ptr<float>(r)[c] = value(gen);
+    return d;
+}
+
+/// Copy of \p d with \p flips random bits flipped in each row.
+cv::Mat flip_bits(const cv::Mat& d, int flips, unsigned seed) {
+    mt19937                       gen{seed};
+    uniform_int_distribution<int> bit{0, d.cols * 8 - 1};
+    cv::Mat                       result(d.rows, d.cols, CV_8U);
+    for (int r = 0; r < d.rows; ++r) {
+        for (int c = 0; c < d.cols; ++c)
+            result.ptr<uint8_t>(r)[c] = d.ptr<uint8_t>(r)[c];
+        for (int i = 0; i < flips; ++i) {
+            const int b = bit(gen);
+            result.ptr<uint8_t>(r)[b / 8] ^= uint8_t(1U << unsigned(b % 8));
+        }
+    }
+    return result;
+}
+
+/// Copy of \p d with uniform noise of \p amplitude added.
+cv::Mat add_noise(const cv::Mat& d, float amplitude, unsigned seed) {
+    mt19937                          gen{seed};
+    uniform_real_distribution<float> noise{-amplitude, amplitude};
+    cv::Mat                          result(d.rows, d.cols, CV_32F);
+    for (int r = 0; r < d.rows; ++r)
+        for (int c = 0; c < d.cols; ++c)
+            result.ptr<float>(r)[c] = d.ptr<float>(r)[c] + noise(gen);
+    return result;
+}
+
+void check_same_matches(const vector<cv::DMatch>& exact,
+                        const vector<cv::DMatch>& approximate) {
+    REQUIRE(exact.size() == approximate.size());
+    for (size_t i = 0; i < exact.size(); ++i) {
+        CHECK(exact[i].queryIdx == approximate[i].queryIdx);
+        CHECK(exact[i].trainIdx == approximate[i].trainIdx);
+        CHECK(exact[i].distance == Approx(approximate[i].distance));
+    }
+}
+
+/// Fraction of the queries whose nearest neighbour is the row with the same
+/// index.
+float identity_recall(const vector<nearest_neighbours>& n) {
+    int found = 0;
+    for (size_t i = 0; i < n.size(); ++i)
+        found += n[i].first == int(i) ? 1 : 0;
+    return float(found) / float(n.size());
+}
+
+const match_strategy all_strategies[] = {
+    match_strategy::nearest, match_strategy::crosscheck, match_strategy::ratio,
+    match_strategy::ratio_crosscheck};
+}  // namespace
+
+TEST_CASE("approximate nearest neighbours") {
+    SUBCASE("empty index") {
+        const ann_index empty{cv::Mat(), cv::NORM_HAMMING};
+        const cv::Mat   queries = random_binary(5, 32, 1U);
+        const vector<nearest_neighbours> n = empty.search(queries);
+        REQUIRE(n.size() == 5UL);
+        CHECK(n[0].first == -1);
+        CHECK(n[0].second == -1);
+
+        const ann_index query{queries, cv::NORM_HAMMING};
+        CHECK(match_descriptors(query, empty, match_strategy::crosscheck)
+                  .empty());
+    }
+    SUBCASE("probing all buckets is exact") {
+        // Two bits per key and probing two bit flips visits every bucket.
+        ann_parameters p;
+        p.lsh_key_bits    = 2;
+        p.lsh_probe_level = 2;
+        const cv::Mat   q = random_binary(150, 32, 2U);
+        const cv::Mat   t = random_binary(200, 32, 3U);
+        const ann_index query{q, cv::NORM_HAMMING, p};
+        const ann_index train{t, cv::NORM_HAMMING, p};
+        for (match_strategy strategy : all_strategies)
+            check_same_matches(
+                match_descriptors(q, t, cv::NORM_HAMMING, strategy),
+                match_descriptors(query, train, strategy));
+    }
+    SUBCASE("searching the whole graph is exact") {
+        ann_parameters p;
+        p.hnsw_ef_search = 300;
+        const cv::Mat q = random_float(150, 64, 4U);
+        const cv::Mat t = random_float(200, 64, 5U);
+        for (cv::NormTypes norm : {cv::NORM_L1, cv::NORM_L2}) {
+            const ann_index query{q, norm, p};
+            const ann_index train{t, norm, p};
+            for (match_strategy strategy : all_strategies)
+                check_same_matches(match_descriptors(q, t, norm, strategy),
+                                   match_descriptors(query, train, strategy));
+        }
+    }
+    SUBCASE("binary recall") {
+        const cv::Mat   t = random_binary(2'000, 32, 6U);
+        const cv::Mat   q = flip_bits(t, 20, 7U);
+        const ann_index train{t, cv::NORM_HAMMING};
+        CHECK(identity_recall(train.search(q)) > 0.95F);
+    }
+    SUBCASE("float recall") {
+        const cv::Mat   t = random_float(2'000, 128, 8U);
+        const cv::Mat   q = add_noise(t, 0.05F, 9U);
+        const ann_index train{t, cv::NORM_L2};
+        CHECK(identity_recall(train.search(q)) > 0.95F);
+    }
+    SUBCASE("integer descriptors with L-norms are converted") {
+        const cv::Mat   t = random_binary(100, 32, 10U);
+        const ann_index train{t, cv::NORM_L2};
+        CHECK(train.descriptors().type() == CV_32F);
+        const vector<nearest_neighbours> n = train.search(train.descriptors());
+        CHECK(identity_recall(n) == Approx(1.0F));
+        CHECK(n[0].first_distance == Approx(0.0F));
+    }
+}
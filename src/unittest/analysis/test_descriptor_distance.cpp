@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <limits>
+#include <opencv2/core/mat.hpp>
+#include <random>
+#include <sens_loc/analysis/descriptor_distance.h>
+#include <vector>
+
+using namespace std;
+using namespace sens_loc::analysis;
+using doctest::Approx;
+
+namespace {
+cv::Mat random_binary(int rows, int bytes, unsigned seed) {
+    mt19937                            gen{seed};
+    uniform_int_distribution<unsigned> byte{0U, 255U};
+    cv::Mat                            d(rows, bytes, CV_8U);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < bytes; ++c)
+            d.ptr<uint8_t>(r)[c] = uint8_t(byte(gen));
+    return d;
+}
+
+cv::Mat random_float(int rows, int cols, unsigned seed) {
+    mt19937                          gen{seed};
+    uniform_real_distribution<float> value{0.0F, 1.0F};
+    cv::Mat                          d(rows, cols, CV_32F);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            d.ptr<float>(r)[c] = value(gen);
+    return d;
+}
+
+float reference(const cv::Mat& d, int a, int b, cv::NormTypes norm) {
+    float s = 0.0F;
+    for (int c = 0; c < d.cols; ++c) {
+        if (norm == cv::NORM_HAMMING) {
+            s += float(__builtin_popcount(
+                unsigned(d.ptr<uint8_t>(a)[c] ^ d.ptr<uint8_t>(b)[c])));
+        } else if (norm == cv::NORM_HAMMING2) {
+            const unsigned x = d.ptr<uint8_t>(a)[c] ^ d.ptr<uint8_t>(b)[c];
+            for (unsigned shift = 0U; shift < 8U; shift += 2U)
+                s += ((x >> shift) & 3U) != 0U ? 1.0F : 0.0F;
+        } else {
+            const float diff = d.ptr<float>(a)[c] - d.ptr<float>(b)[c];
+            s += norm == cv::NORM_L1 ? abs(diff) : diff * diff;
+        }
+    }
+    return norm == cv::NORM_L2 ? sqrt(s) : s;
+}
+
+/// Minimal distance per row, comparing all pairs.
+vector<float> all_pairs(const cv::Mat& d, cv::NormTypes norm) {
+    vector<float> m(d.rows, numeric_limits<float>::max());
+    for (int a = 0; a < d.rows; ++a)
+        for (int b = 0; b < d.rows; ++b)
+            if (a != b)
+                m[a] = min(m[a], reference(d, a, b, norm));
+    return m;
+}
+}  // namespace
+
+TEST_CASE("minimal descriptor distances") {
+    SUBCASE("less than two descriptors") {
+        CHECK(min_descriptor_distances(cv::Mat(), cv::NORM_L2).empty());
+        CHECK(min_descriptor_distances(random_binary(1, 32, 1U),
+                                       cv::NORM_HAMMING)
+                  .empty());
+    }
+    SUBCASE("binary descriptors") {
+        // 61 bytes is the AKAZE descriptor and does not fill whole words.
+        for (int bytes : {32, 61, 64}) {
+            const cv::Mat d = random_binary(300, bytes, unsigned(bytes));
+            for (cv::NormTypes norm : {cv::NORM_HAMMING, cv::NORM_HAMMING2}) {
+                const vector<float> expected = all_pairs(d, norm);
+                const vector<float> result =
+                    min_descriptor_distances(d, norm);
+                REQUIRE(result.size() == expected.size());
+                for (size_t i = 0; i < result.size(); ++i)
+                    CHECK(result[i] == expected[i]);
+            }
+        }
+    }
+    SUBCASE("float descriptors") {
+        const cv::Mat d = random_float(300, 67, 42U);
+        for (cv::NormTypes norm : {cv::NORM_L1, cv::NORM_L2, cv::NORM_L2SQR}) {
+            const vector<float> expected = all_pairs(d, norm);
+            const vector<float> result   = min_descriptor_distances(d, norm);
+            REQUIRE(result.size() == expected.size());
+            for (size_t i = 0; i < result.size(); ++i)
+                CHECK(result[i] == Approx(expected[i]));
+        }
+    }
+}
@@ -0,0 +1,171 @@
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <limits>
+#include <opencv2/core/mat.hpp>
+#include <random>
+#include <sens_loc/analysis/descriptor_matching.h>
+#include <vector>
+
+using namespace std;
+using namespace sens_loc::analysis;
+using doctest::Approx;
+
+namespace {
+/// Random binary descriptors, only the first \p random_bytes are set which
+/// results in many equal distances for small values.
+cv::Mat random_binary(int rows, int bytes, int random_bytes, unsigned seed) {
+    mt19937                            gen{seed};
+    uniform_int_distribution<unsigned> byte{0U, 255U};
+    cv::Mat                            d(rows, bytes, CV_8U);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < bytes; ++c)
+            d.ptr<uint8_t>(r)[c] = c < random_bytes ? uint8_t(byte(gen)) : 0U;
+    return d;
+}
+
+cv::Mat random_float(int rows, int cols, unsigned seed) {
+    mt19937                          gen{seed};
+    uniform_real_distribution<float> value{0.0F, 1.0F};
+    cv::Mat                          d(rows, cols, CV_32F);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            d.ptr<float>(r)[c] = value(gen);
+    return d;
+}
+
+float reference(const cv::Mat& q,
+                int            a,
+                const cv::Mat& t,
+                int            b,
+                cv::NormTypes  norm) {
+    float s = 0.0F;
+    for (int c = 0; c < q.cols; ++c) {
+        if (norm == cv::NORM_HAMMING) {
+            s += float(__builtin_popcount(
+                unsigned(q.ptr<uint8_t>(a)[c] ^ t.ptr<uint8_t>(b)[c])));
+        } else {
+            const float diff = q.ptr<float>(a)[c] - t.ptr<float>(b)[c];
+            s += norm == cv::NORM_L1 ? abs(diff) : diff * diff;
+        }
+    }
+    return norm == cv::NORM_L2 ? sqrt(s) : s;
+}
+
+/// Index of the closest row in \p t to row \p a of \p q, the first minimum
+/// like 'cv::BFMatcher'.
+int closest(const cv::Mat& q, int a, const cv::Mat& t, cv::NormTypes norm) {
+    int   best      = -1;
+    float best_dist = numeric_limits<float>::max();
+    for (int b = 0; b < t.rows; ++b) {
+        const float d = reference(q, a, t, b, norm);
+        if (d < best_dist) {
+            best      = b;
+            best_dist = d;
+        }
+    }
+    return best;
+}
+
+/// Distance of the closest row in \p t to row \p a of \p q, ignoring the
+/// row \p ignored.
+float closest_distance(const cv::Mat& q,
+                       int            a,
+                       const cv::Mat& t,
+                       int            ignored,
+                       cv::NormTypes  norm) {
+    float best_dist = numeric_limits<float>::max();
+    for (int b = 0; b < t.rows; ++b)
+        if (b != ignored)
+            best_dist = min(best_dist, reference(q, a, t, b, norm));
+    return best_dist;
+}
+
+void check_matches(const cv::Mat& query,
+                   const cv::Mat& train,
+                   cv::NormTypes  norm,
+                   match_strategy strategy,
+                   float          ratio = default_match_ratio) {
+    const vector<cv::DMatch> result =
+        match_descriptors(query, train, norm, strategy, ratio);
+    const bool crosscheck = strategy == match_strategy::crosscheck ||
+                            strategy == match_strategy::ratio_crosscheck;
+    const bool ratio_test = strategy == match_strategy::ratio ||
+                            strategy == match_strategy::ratio_crosscheck;
+
+    size_t next = 0UL;
+    for (int i = 0; i < query.rows; ++i) {
+        const int   j = closest(query, i, train, norm);
+        const float d = reference(query, i, train, j, norm);
+        if (crosscheck && closest(train, j, query, norm) != i)
+            continue;
+        if (ratio_test && train.rows > 1 &&
+            !(d < ratio * closest_distance(query, i, train, j, norm)))
+            continue;
+        REQUIRE(next < result.size());
+        const cv::DMatch& m = result[next++];
+        CHECK(m.queryIdx == i);
+        CHECK(m.trainIdx == j);
+        CHECK(m.imgIdx == 0);
+        CHECK(m.distance == Approx(d));
+    }
+    CHECK(next == result.size());
+}
+
+const match_strategy all_strategies[] = {
+    match_strategy::nearest, match_strategy::crosscheck, match_strategy::ratio,
+    match_strategy::ratio_crosscheck};
+}  // namespace
+
+TEST_CASE("brute force descriptor matching") {
+    SUBCASE("empty sets") {
+        const cv::Mat d = random_binary(10, 32, 32, 1U);
+        CHECK(match_descriptors(cv::Mat(), d, cv::NORM_HAMMING,
+                                match_strategy::crosscheck)
+                  .empty());
+        CHECK(match_descriptors(d, cv::Mat(), cv::NORM_HAMMING,
+                                match_strategy::crosscheck)
+                  .empty());
+    }
+    SUBCASE("binary descriptors") {
+        for (match_strategy strategy : all_strategies) {
+            for (int bytes : {32, 61, 64}) {
+                const cv::Mat query = random_binary(300, bytes, bytes, 2U);
+                const cv::Mat train = random_binary(500, bytes, bytes, 3U);
+                check_matches(query, train, cv::NORM_HAMMING, strategy);
+                check_matches(train, query, cv::NORM_HAMMING, strategy);
+            }
+        }
+    }
+    SUBCASE("equal distances choose the lowest index") {
+        // With only one random byte most distances are equal, which checks
+        // the handling of ties in both directions. Equal distances never
+        // pass the ratio test.
+        const cv::Mat query = random_binary(400, 32, 1, 4U);
+        const cv::Mat train = random_binary(700, 32, 1, 5U);
+        for (match_strategy strategy : all_strategies)
+            check_matches(query, train, cv::NORM_HAMMING, strategy);
+    }
+    SUBCASE("float descriptors") {
+        for (int cols : {64, 128, 30}) {
+            const cv::Mat query = random_float(200, cols, 6U);
+            const cv::Mat train = random_float(300, cols, 7U);
+            for (cv::NormTypes norm : {cv::NORM_L1, cv::NORM_L2})
+                for (match_strategy strategy : all_strategies)
+                    check_matches(query, train, norm, strategy);
+        }
+    }
+    SUBCASE("ratio test") {
+        const cv::Mat query = random_float(200, 128, 8U);
+        const cv::Mat train = random_float(300, 128, 9U);
+        for (float ratio : {0.5F, 0.9F, 1.0F})
+            check_matches(query, train, cv::NORM_L2, match_strategy::ratio,
+                          ratio);
+
+        // A single train descriptor has no second neighbour.
+        const cv::Mat single = random_float(1, 128, 10U);
+        CHECK(match_descriptors(query, single, cv::NORM_L2,
+                                match_strategy::ratio)
+                  .size() == size_t(query.rows));
+    }
+}
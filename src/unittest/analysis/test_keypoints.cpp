@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include <doctest/doctest.h>
+#include <limits>
 #include <sens_loc/analysis/keypoints.h>
 #include <sstream>
 #include <vector>
@@ -228,3 +231,33 @@ TEST_CASE("write with filestorage") {
                     .first == prefix.end());
     }
 }
+
+TEST_CASE("nearest neighbour distances") {
+    SUBCASE("less than two keypoints") {
+        CHECK(nearest_neighbour_distances(vector<KeyPoint>{}).empty());
+        CHECK(nearest_neighbour_distances(vector<KeyPoint>{pts[0]}).empty());
+    }
+    SUBCASE("equal to comparing all pairs") {
+        const vector<float> d = nearest_neighbour_distances(pts);
+        REQUIRE(d.size() == pts.size());
+
+        for (size_t i = 0; i < pts.size(); ++i) {
+            float expected = numeric_limits<float>::max();
+            for (size_t k = 0; k < pts.size(); ++k) {
+                if (i != k)
+                    expected = min(expected, hypot(pts[i].pt.x - pts[k].pt.x,
+                                                   pts[i].pt.y - pts[k].pt.y));
+            }
+            CHECK(d[i] == doctest::Approx(expected));
+        }
+    }
+    SUBCASE("duplicated keypoints") {
+        const vector<KeyPoint> dup{
+            {10.0F, 1.0F, 5.0F}, {10.0F, 1.0F, 5.0F}, {20.0F, 1.0F, 5.0F}};
+        const vector<float> d = nearest_neighbour_distances(dup);
+        REQUIRE(d.size() == 3UL);
+        CHECK(d[0] == 0.0F);
+        CHECK(d[1] == 0.0F);
+        CHECK(d[2] == 10.0F);
+    }
+}
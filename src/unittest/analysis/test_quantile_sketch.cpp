@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <cmath>
+#include <doctest/doctest.h>
+#include <random>
+#include <sens_loc/analysis/distance.h>
+#include <sens_loc/analysis/keypoints.h>
+#include <sens_loc/analysis/quantile_sketch.h>
+#include <vector>
+
+using namespace std;
+using namespace sens_loc;
+
+namespace {
+vector<float> lognormal_values(size_t n, unsigned int seed) {
+    mt19937                       gen{seed};
+    lognormal_distribution<float> dist{0.0F, 1.0F};
+    vector<float>                 values(n);
+    generate(begin(values), end(values), [&]() { return dist(gen); });
+    return values;
+}
+
+/// The sketch estimates ranks within this fraction of the count.
+constexpr double rank_error = 0.0165;
+
+/// Difference between the normalized rank of \p value in the sorted values
+/// and the expected rank \p q.
+double rank_difference(const vector<float>& sorted, float value, double q) {
+    const auto r =
+        lower_bound(begin(sorted), end(sorted), value) - begin(sorted);
+    return abs(double(r) / double(sorted.size()) - q);
+}
+}  // namespace
+
+TEST_CASE("moments") {
+    const vector<float> values = lognormal_values(10'000UL, 42U);
+
+    SUBCASE("equal to the boost accumulators") {
+        analysis::moments m;
+        m.insert(values);
+
+        vector<float> sorted = values;
+        sort(begin(sorted), end(sorted));
+        const analysis::statistic exact = analysis::statistic::make(sorted);
+
+        CHECK(m.count() == exact.count);
+        CHECK(m.min() == exact.min);
+        CHECK(m.max() == exact.max);
+        CHECK(m.mean() == doctest::Approx(exact.mean).epsilon(1e-5));
+        CHECK(m.variance() == doctest::Approx(exact.variance).epsilon(1e-4));
+        CHECK(m.skewness() == doctest::Approx(exact.skewness).epsilon(1e-3));
+    }
+    SUBCASE("merging is equal to inserting") {
+        analysis::moments all;
+        analysis::moments first;
+        analysis::moments second;
+        all.insert(values);
+        first.insert(gsl::span<const float>(values).first(1'234));
+        second.insert(gsl::span<const float>(values).subspan(1'234));
+        first.merge(second);
+
+        CHECK(first.count() == all.count());
+        CHECK(first.min() == all.min());
+        CHECK(first.max() == all.max());
+        CHECK(first.mean() == doctest::Approx(all.mean()));
+        CHECK(first.variance() == doctest::Approx(all.variance()));
+        CHECK(first.skewness() == doctest::Approx(all.skewness()));
+    }
+    SUBCASE("constant values have no skewness") {
+        analysis::moments m;
+        m.insert(vector<float>(10UL, 2.0F));
+        CHECK(m.mean() == 2.0);
+        CHECK(m.variance() == 0.0);
+        CHECK(m.skewness() == 0.0);
+    }
+}
+
+TEST_CASE("quantile sketch") {
+    SUBCASE("small inputs are exact") {
+        const vector<float>       values = lognormal_values(100UL, 1U);
+        analysis::quantile_sketch sketch;
+        sketch.insert(values);
+
+        vector<float> sorted = values;
+        sort(begin(sorted), end(sorted));
+        CHECK(sketch.retained() == values.size());
+        for (size_t i = 0; i < sorted.size(); ++i)
+            CHECK(sketch.at_rank(i) == sorted[i]);
+        CHECK(sketch.quantile(0.0) == sorted.front());
+        CHECK(sketch.quantile(1.0) == sorted.back());
+    }
+    SUBCASE("large inputs are within the error bound") {
+        const vector<float>       values = lognormal_values(1'000'000UL, 2U);
+        analysis::quantile_sketch sketch;
+        sketch.insert(values);
+
+        vector<float> sorted = values;
+        sort(begin(sorted), end(sorted));
+
+        CHECK(sketch.count() == values.size());
+        // The memory does not grow with the number of values.
+        CHECK(sketch.retained() < 4UL * analysis::quantile_sketch::default_k);
+
+        for (int i = 1; i < 100; ++i) {
+            const double q = i / 100.0;
+            CHECK(rank_difference(sorted, sketch.quantile(q), q) < rank_error);
+        }
+
+        const auto weighted = sketch.weighted_values();
+        uint64_t   total    = 0UL;
+        for (const auto& [value, weight] : weighted)
+            total += weight;
+        CHECK(total == values.size());
+        CHECK(is_sorted(begin(weighted), end(weighted)));
+    }
+    SUBCASE("merged sketches are within the error bound") {
+        const vector<float>       values = lognormal_values(200'000UL, 3U);
+        analysis::quantile_sketch merged;
+        for (size_t i = 0; i < values.size(); i += 10'000UL) {
+            analysis::quantile_sketch part;
+            part.insert(gsl::span<const float>(values).subspan(i, 10'000UL));
+            merged.merge(part);
+        }
+        vector<float> sorted = values;
+        sort(begin(sorted), end(sorted));
+
+        CHECK(merged.count() == values.size());
+        CHECK(merged.retained() < 4UL * analysis::quantile_sketch::default_k);
+        for (int i = 1; i < 10; ++i) {
+            const double q = i / 10.0;
+            CHECK(rank_difference(sorted, merged.quantile(q), q) < rank_error);
+        }
+    }
+    SUBCASE("same input, same sketch") {
+        const vector<float>       values = lognormal_values(50'000UL, 4U);
+        analysis::quantile_sketch s1;
+        analysis::quantile_sketch s2;
+        s1.insert(values);
+        s2.insert(values);
+        CHECK(s1.weighted_values() == s2.weighted_values());
+    }
+}
+
+TEST_CASE("distance from an accumulator") {
+    const vector<float> values = lognormal_values(100'000UL, 5U);
+    vector<float>       sorted = values;
+    sort(begin(sorted), end(sorted));
+    const analysis::distance exact{sorted, 20U, "exact"};
+
+    SUBCASE("exact mode equals sorted data") {
+        analysis::distance_accumulator acc{/*exact=*/true};
+        acc.insert(values);
+        const analysis::distance d{acc, 20U, "exact"};
+
+        CHECK(d.count() == exact.count());
+        CHECK(d.median() == exact.median());
+        CHECK(d.get_statistic().decentils == exact.get_statistic().decentils);
+        CHECK(d.histogram() == exact.histogram());
+    }
+    SUBCASE("sketched mode approximates the quantiles") {
+        analysis::distance_accumulator acc{/*exact=*/false};
+        analysis::distance_accumulator other{/*exact=*/false};
+        acc.insert(gsl::span<const float>(values).first(50'000UL));
+        other.insert(gsl::span<const float>(values).subspan(50'000UL));
+        acc.merge(other);
+        REQUIRE(acc.count() == values.size());
+        CHECK(acc.values().empty());
+
+        const analysis::distance d{acc, 20U, "sketched"};
+        CHECK(d.count() == exact.count());
+        CHECK(d.min() == exact.min());
+        CHECK(d.max() == exact.max());
+        CHECK(d.mean() == doctest::Approx(exact.mean()).epsilon(1e-4));
+        CHECK(d.stddev() == doctest::Approx(exact.stddev()).epsilon(1e-3));
+        CHECK(rank_difference(sorted, d.median(), 0.5) < rank_error);
+        for (int i = 0; i < 9; ++i)
+            CHECK(rank_difference(sorted, d.get_statistic().decentils[i],
+                                  (i + 1) / 10.0) < rank_error);
+
+        // Every value is counted once in the histogram.
+        double total = 0.0;
+        for (auto&& cell : boost::histogram::indexed(d.histogram())) {
+            total += *cell;
+            // Each bin is the difference of two ranks.
+            const double e = exact.histogram().at(cell.index());
+            CHECK(abs(*cell - e) < 2.0 * rank_error * double(values.size()));
+        }
+        CHECK(total == doctest::Approx(double(values.size())));
+    }
+}
+
+TEST_CASE("accumulated keypoints") {
+    vector<cv::KeyPoint>             points;
+    mt19937                          gen{6U};
+    uniform_real_distribution<float> coord{0.0F, 99.0F};
+    for (int i = 0; i < 150; ++i)
+        points.emplace_back(coord(gen), coord(gen), float(i % 7 + 1), -1.0F,
+                            float(i % 13) / 13.0F);
+
+    analysis::keypoints exact{100U, 100U};
+    exact.analyze(points);
+
+    analysis::keypoints streamed{100U, 100U};
+    analysis::keypoints other{100U, 100U};
+    streamed.accumulate(gsl::span<const cv::KeyPoint>(points).first(60));
+    other.accumulate(gsl::span<const cv::KeyPoint>(points).subspan(60));
+    streamed.merge(other);
+    streamed.summarize();
+
+    // Less values than the sketch capacity are exact.
+    CHECK(streamed.size().count == exact.size().count);
+    CHECK(streamed.size().median == exact.size().median);
+    CHECK(streamed.size().decentils == exact.size().decentils);
+    CHECK(streamed.response().median == exact.response().median);
+    CHECK(streamed.response().mean ==
+          doctest::Approx(exact.response().mean).epsilon(1e-5));
+    CHECK(streamed.distribution() == exact.distribution());
+    CHECK(streamed.size_histo() == exact.size_histo());
+}
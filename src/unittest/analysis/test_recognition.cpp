@@ -108,6 +108,49 @@ TEST_CASE("Pathological case - no query data") {
     }
 }
 
+TEST_CASE("merging statistics") {
+    const vector<DMatch> first_matches{{0, 0, 1.0F}, {1, 2, 9.0F}};
+    const vector<DMatch> second_matches{{0, 0, 2.0F}, {1, 1, 3.0F}};
+    element_categories first{some_points, some_points, first_matches,
+                             threshold};
+    element_categories second{some_points, some_points, second_matches,
+                              threshold};
+    REQUIRE(!first.true_positives.empty());
+    REQUIRE(!first.false_positives.empty());
+
+    recognition_statistic all;
+    all.account(first);
+    all.account(second);
+    all.account(first);
+
+    recognition_statistic part1;
+    part1.account(first);
+    recognition_statistic part2;
+    part2.account(second);
+    part2.account(first);
+    part1.merge(part2);
+
+    CHECK(part1.true_positives() == all.true_positives());
+    CHECK(part1.false_positives() == all.false_positives());
+    CHECK(part1.true_negatives() == all.true_negatives());
+    CHECK(part1.false_negatives() == all.false_negatives());
+    CHECK(boost::accumulators::count(
+              part1.true_positive_distribution().stat) == 3UL);
+    CHECK(boost::accumulators::max(part1.true_positive_distribution().stat) ==
+          boost::accumulators::max(all.true_positive_distribution().stat));
+
+    part1.make_histogram();
+    all.make_histogram();
+    CHECK(part1.true_positive_distribution().histo ==
+          all.true_positive_distribution().histo);
+    CHECK(part1.true_positive_distance().count() ==
+          all.true_positive_distance().count());
+    CHECK(part1.true_positive_distance().median() ==
+          all.true_positive_distance().median());
+    CHECK(part1.false_positive_distance().mean() ==
+          Approx(all.false_positive_distance().mean()));
+}
+
 TEST_CASE("writing result with filestorage") {
     element_categories    ec{some_points, bad_points, matches, threshold};
     recognition_statistic rs;
@@ -75,6 +75,50 @@ TEST_CASE("project image points to sphere") {
     }
 }
 
+TEST_CASE("project structure of arrays") {
+    // Points that are not in the image, or can not be projected at all.
+    pointcloud<double> points = c;
+    points.emplace_back(1.0, 1.0, 0.0);
+    points.emplace_back(1000.0, 0.0, 1.0);
+
+    SUBCASE("pinhole to image") {
+        const imagepoints<double> expected = project_to_image(p, points);
+        const imagepoints<double> pxs =
+            to_aos(project_to_image(p, to_soa(points)));
+        REQUIRE(pxs.size() == expected.size());
+        for (size_t k = 0; k < pxs.size(); ++k) {
+            CHECK(pxs[k].u() == Approx(expected[k].u()));
+            CHECK(pxs[k].v() == Approx(expected[k].v()));
+        }
+        CHECK(pxs[3].u() == -1.0);
+        CHECK(pxs[4].v() == -1.0);
+    }
+    SUBCASE("equirectangular to image") {
+        const imagepoints<double> expected = project_to_image(e, points);
+        const imagepoints<double> pxs =
+            to_aos(project_to_image(e, to_soa(points)));
+        REQUIRE(pxs.size() == expected.size());
+        for (size_t k = 0; k < pxs.size(); ++k) {
+            CHECK(pxs[k].u() == Approx(expected[k].u()));
+            CHECK(pxs[k].v() == Approx(expected[k].v()));
+        }
+    }
+    SUBCASE("pinhole to sphere") {
+        const pointcloud<double> expected = project_to_sphere(p, i);
+        const pointcloud<double> pts = to_aos(project_to_sphere(p, to_soa(i)));
+        REQUIRE(pts.size() == expected.size());
+        for (size_t k = 0; k < pts.size(); ++k)
+            CHECK((pts[k] - expected[k]).norm() == Approx(0.0));
+    }
+    SUBCASE("equirectangular to sphere") {
+        const pointcloud<double> expected = project_to_sphere(e, i);
+        const pointcloud<double> pts = to_aos(project_to_sphere(e, to_soa(i)));
+        REQUIRE(pts.size() == expected.size());
+        for (size_t k = 0; k < pts.size(); ++k)
+            CHECK((pts[k] - expected[k]).norm() == Approx(0.0));
+    }
+}
+
 TEST_CASE("keypoints to coordinates") {
     std::vector<cv::KeyPoint> kps = coords_to_keypoint(i);
     imagepoints<double>       pts = keypoint_to_coords<double>(kps);
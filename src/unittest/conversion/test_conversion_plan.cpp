@@ -0,0 +1,64 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "intrinsic.h"
+
+#include <doctest/doctest.h>
+#include <opencv2/core.hpp>
+#include <sens_loc/conversion/conversion_plan.h>
+#include <sens_loc/conversion/depth_to_bearing.h>
+#include <sens_loc/conversion/depth_to_flexion.h>
+#include <sens_loc/conversion/depth_to_laserscan.h>
+#include <sens_loc/io/image.h>
+#include <sens_loc/util/correctness_util.h>
+
+using namespace sens_loc;
+using namespace sens_loc::conversion;
+
+namespace {
+double max_difference(const math::image<double>& i1,
+                      const math::image<double>& i2) {
+    return cv::norm(i1.data(), i2.data(), cv::NORM_INF);
+}
+}  // namespace
+
+TEST_CASE("conversion plan matches direct conversion") {
+    auto depth_image = io::load_image<ushort>("conversion/data0-depth.png",
+                                              cv::IMREAD_UNCHANGED);
+    REQUIRE(depth_image);
+    const auto frame0 = depth_to_laserscan<double, ushort>(*depth_image, p);
+    // A second, different frame to check the rebinding of the input.
+    const auto frame1 = math::image<double>(frame0.data() * 1.5);
+
+    conversion_plan<camera_models::pinhole, double> plan(p);
+    const std::size_t flexion = plan.add_flexion();
+    const std::size_t bearing = plan.add_bearing<direction::diagonal>();
+    REQUIRE(plan.size() == 2UL);
+    REQUIRE(plan.w() == p.w());
+    REQUIRE(plan.h() == p.h());
+
+    tf::Executor executor;
+
+    for (const math::image<double>* frame : {&frame0, &frame1, &frame0}) {
+        plan.bind_input(*frame);
+        plan.run(executor).wait();
+
+        REQUIRE(max_difference(plan.output(flexion),
+                               depth_to_flexion(*frame, p)) == 0.);
+        REQUIRE(max_difference(plan.output(bearing),
+                               depth_to_bearing<direction::diagonal>(
+                                   *frame, p)) == 0.);
+    }
+
+    SUBCASE("bound output buffers") {
+        cv::Mat result(p.h(), p.w(), CV_64F);
+        result = 0.;
+        math::image<double> out(result);
+        plan.bind_output(flexion, out);
+
+        plan.bind_input(frame1);
+        plan.run(executor).wait();
+
+        // The result is written into the memory of the bound image.
+        REQUIRE(max_difference(out, depth_to_flexion(frame1, p)) == 0.);
+    }
+}
@@ -0,0 +1,131 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "intrinsic.h"
+
+#include <doctest/doctest.h>
+#include <sens_loc/camera_models/ray_table.h>
+#include <sens_loc/conversion/depth_to_bearing.h>
+#include <sens_loc/conversion/depth_to_flexion.h>
+#include <sens_loc/conversion/depth_to_laserscan.h>
+#include <sens_loc/conversion/sparse_conversion.h>
+#include <sens_loc/io/image.h>
+#include <vector>
+
+using namespace sens_loc;
+using namespace sens_loc::conversion;
+using doctest::Approx;
+
+namespace {
+std::vector<math::pixel_coord<int>> query_points(int w, int h) {
+    std::vector<math::pixel_coord<int>> points;
+    // Border pixels, a consecutive run within one row and duplicates.
+    points.emplace_back(0, 0);
+    points.emplace_back(w - 1, h - 1);
+    points.emplace_back(w / 2, 0);
+    for (int u = 40; u < 60; ++u)
+        points.emplace_back(u, h / 2);
+    points.emplace_back(42, h / 2);
+    for (int i = 1; i < 50; ++i)
+        points.emplace_back((i * 97) % w, (i * 31) % h);
+    return points;
+}
+}  // namespace
+
+TEST_CASE("ray table") {
+    const camera_models::ray_table<double> rays(p);
+    REQUIRE(rays.w() == p.w());
+    REQUIRE(rays.h() == p.h());
+
+    for (const math::pixel_coord<int> px : {math::pixel_coord<int>{0, 0},
+                                            math::pixel_coord<int>{42, 21},
+                                            math::pixel_coord<int>{959, 539}}) {
+        const math::sphere_coord<double> expected = p.pixel_to_sphere(px);
+        const math::sphere_coord<double> looked_up = rays(px);
+        REQUIRE(looked_up.Xs() == Approx(expected.Xs()));
+        REQUIRE(looked_up.Ys() == Approx(expected.Ys()));
+        REQUIRE(looked_up.Zs() == Approx(expected.Zs()));
+        REQUIRE(rays.Xs(px.v())[px.u()] == Approx(expected.Xs()));
+    }
+}
+
+TEST_CASE("sparse flexion pinhole") {
+    auto depth_image = io::load_image<ushort>("conversion/data0-depth.png",
+                                              cv::IMREAD_UNCHANGED);
+    REQUIRE(depth_image);
+    const auto laser_double = depth_to_laserscan<double, ushort>(*depth_image, p);
+    const auto dense        = depth_to_flexion(laser_double, p);
+    const camera_models::ray_table<double> rays(p);
+
+    SUBCASE("points") {
+        const auto points = query_points(p.w(), p.h());
+        const auto sparse = sparse_flexion(laser_double, rays, points);
+        REQUIRE(sparse.size() == points.size());
+        for (std::size_t i = 0; i < points.size(); ++i)
+            REQUIRE(sparse[i] == Approx(dense.at(points[i])));
+    }
+    SUBCASE("patches") {
+        const std::vector<cv::Rect> patches{
+            {100, 100, 32, 32}, {-10, -5, 32, 32}, {940, 520, 32, 32}};
+        const auto sparse = sparse_flexion(laser_double, rays, patches);
+        REQUIRE(sparse.size() == patches.size());
+
+        for (std::size_t i = 0; i < patches.size(); ++i) {
+            const cv::Rect& r = patches[i];
+            REQUIRE(sparse[i].w() == r.width);
+            REQUIRE(sparse[i].h() == r.height);
+            for (int y = 0; y < r.height; ++y) {
+                for (int x = 0; x < r.width; ++x) {
+                    const int  u      = r.x + x;
+                    const int  v      = r.y + y;
+                    const bool inside = u >= 0 && u < dense.w() && v >= 0 &&
+                                        v < dense.h();
+                    const double expected = inside ? dense.at({u, v}) : 0.;
+                    REQUIRE(sparse[i].at({x, y}) == Approx(expected));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("sparse flexion equirectangular") {
+    auto depth_image = io::load_image<ushort>("conversion/laserscan-depth.png",
+                                              cv::IMREAD_UNCHANGED);
+    REQUIRE(depth_image);
+    const auto laser_double = math::convert<double>(*depth_image);
+    const auto dense        = depth_to_flexion(laser_double, e_double);
+    const camera_models::ray_table<double> rays(e_double);
+
+    const auto points = query_points(e_double.w(), e_double.h());
+    const auto sparse = sparse_flexion(laser_double, rays, points);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        REQUIRE(sparse[i] == Approx(dense.at(points[i])));
+}
+
+TEST_CASE("sparse bearing pinhole") {
+    auto depth_image = io::load_image<ushort>("conversion/data0-depth.png",
+                                              cv::IMREAD_UNCHANGED);
+    REQUIRE(depth_image);
+    const auto laser_double = depth_to_laserscan<double, ushort>(*depth_image, p);
+    const camera_models::ray_table<double> rays(p);
+    const auto points = query_points(p.w(), p.h());
+
+    SUBCASE("diagonal") {
+        const auto dense =
+            depth_to_bearing<direction::diagonal>(laser_double, p);
+        const auto sparse =
+            sparse_bearing<direction::diagonal>(laser_double, rays, points);
+        for (std::size_t i = 0; i < points.size(); ++i)
+            REQUIRE(sparse[i] == Approx(dense.at(points[i])));
+    }
+    SUBCASE("antidiagonal patch") {
+        const auto dense =
+            depth_to_bearing<direction::antidiagonal>(laser_double, p);
+        const cv::Rect r{500, 520, 32, 32};
+        const auto     sparse =
+            sparse_bearing<direction::antidiagonal>(laser_double, rays, r);
+        for (int y = 0; y < r.height && r.y + y < dense.h(); ++y)
+            for (int x = 0; x < r.width; ++x)
+                REQUIRE(sparse.at({x, y}) ==
+                        Approx(dense.at({r.x + x, r.y + y})));
+    }
+}
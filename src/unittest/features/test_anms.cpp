@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cmath>
+#include <doctest/doctest.h>
+#include <limits>
+#include <random>
+#include <sens_loc/features/anms.h>
+#include <sens_loc/features/tiling.h>
+#include <vector>
+
+using namespace sens_loc::features;
+using namespace std;
+
+namespace {
+vector<cv::KeyPoint> random_keypoints(size_t n, unsigned int seed) {
+    mt19937                          gen{seed};
+    uniform_real_distribution<float> coord{0.0F, 640.0F};
+    // Few distinct responses result in many equal responses.
+    uniform_int_distribution<int> response{1, 20};
+
+    vector<cv::KeyPoint> points;
+    points.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        points.emplace_back(coord(gen), coord(gen), 7.0F, -1.0F,
+                            float(response(gen)) / 20.0F);
+    return points;
+}
+
+/// Reference implementation that compares all pairs of keypoints.
+vector<float> all_pairs(const vector<cv::KeyPoint>& points, float robustness) {
+    vector<float> radii(points.size(), numeric_limits<float>::infinity());
+    for (size_t i = 0; i < points.size(); ++i)
+        for (size_t k = 0; k < points.size(); ++k)
+            if (points[i].response < robustness * points[k].response)
+                radii[i] =
+                    min(radii[i], hypot(points[i].pt.x - points[k].pt.x,
+                                        points[i].pt.y - points[k].pt.y));
+    return radii;
+}
+}  // namespace
+
+TEST_CASE("suppression radii") {
+    SUBCASE("equal to comparing all pairs") {
+        const vector<cv::KeyPoint> points = random_keypoints(2'000UL, 1U);
+        for (float robustness : {1.0F, 0.9F, 0.5F}) {
+            const vector<float> radii = suppression_radii(points, robustness);
+            const vector<float> expected = all_pairs(points, robustness);
+            REQUIRE(radii.size() == expected.size());
+            for (size_t i = 0; i < radii.size(); ++i) {
+                if (isinf(expected[i]))
+                    CHECK(isinf(radii[i]));
+                else
+                    CHECK(radii[i] == doctest::Approx(expected[i]));
+            }
+        }
+    }
+    SUBCASE("the strongest keypoints are not suppressed") {
+        const vector<cv::KeyPoint> points{{0.0F, 0.0F, 1.0F, -1.0F, 1.0F},
+                                          {3.0F, 4.0F, 1.0F, -1.0F, 0.5F},
+                                          {6.0F, 8.0F, 1.0F, -1.0F, 1.0F}};
+        const vector<float>        radii = suppression_radii(points);
+        CHECK(isinf(radii[0]));
+        CHECK(radii[1] == doctest::Approx(5.0F));
+        CHECK(isinf(radii[2]));
+    }
+    SUBCASE("negative responses") {
+        // ORB reports negative scores, the stronger keypoint is the one
+        // closer to zero.
+        const vector<cv::KeyPoint> points{{0.0F, 0.0F, 1.0F, -1.0F, -5.0F},
+                                          {3.0F, 4.0F, 1.0F, -1.0F, -1.0F}};
+        const vector<float>        radii = suppression_radii(points);
+        CHECK(radii[0] == doctest::Approx(5.0F));
+        CHECK(isinf(radii[1]));
+
+        const vector<cv::KeyPoint> equal{{0.0F, 0.0F, 1.0F, -1.0F, -2.0F},
+                                         {3.0F, 4.0F, 1.0F, -1.0F, -2.0F}};
+        const vector<float>        equal_radii = suppression_radii(equal);
+        CHECK(isinf(equal_radii[0]));
+        CHECK(isinf(equal_radii[1]));
+    }
+    SUBCASE("less than two keypoints") {
+        CHECK(suppression_radii({}).empty());
+        const vector<cv::KeyPoint> single{{1.0F, 1.0F, 1.0F}};
+        CHECK(isinf(suppression_radii(single).at(0)));
+    }
+}
+
+TEST_CASE("adaptive non-maximal suppression") {
+    // A cluster of strong keypoints in the top left corner and weaker
+    // keypoints in the other corners.
+    vector<cv::KeyPoint> points;
+    for (int i = 0; i < 10; ++i)
+        points.emplace_back(float(i), float(i), 1.0F, -1.0F, float(1 << i));
+    points.emplace_back(100.0F, 0.0F, 1.0F, -1.0F, 0.5F);
+    points.emplace_back(0.0F, 100.0F, 1.0F, -1.0F, 0.4F);
+    points.emplace_back(100.0F, 100.0F, 1.0F, -1.0F, 0.3F);
+
+    SUBCASE("the selected keypoints are spread over the image") {
+        auto selected = points;
+        auto end      = partition_anms(selected, 4UL);
+        REQUIRE(end - selected.begin() == 4);
+
+        vector<float> responses;
+        for (auto it = selected.begin(); it != end; ++it)
+            responses.push_back(it->response);
+        // The strongest of the cluster and the weak corners keep their
+        // order.
+        CHECK(responses == vector<float>{512.0F, 0.5F, 0.4F, 0.3F});
+
+        // Selecting by response only picks the cluster.
+        auto strongest     = points;
+        auto strongest_end = partition_strongest(strongest, 4UL);
+        CHECK(all_of(strongest.begin(), strongest_end,
+                     [](const cv::KeyPoint& kp) { return kp.pt.x < 10.0F; }));
+    }
+    SUBCASE("few keypoints are kept") {
+        auto kept = points;
+        CHECK(partition_anms(kept, 20UL) == kept.end());
+        CHECK(kept.size() == points.size());
+    }
+}
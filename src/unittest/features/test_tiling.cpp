@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <doctest/doctest.h>
+#include <sens_loc/features/tiling.h>
+#include <vector>
+
+using namespace sens_loc::features;
+using namespace std;
+
+TEST_CASE("make tiles") {
+    const vector<tile> tiles = make_tiles(100, 50, 2, 3, 5);
+    REQUIRE(tiles.size() == 6UL);
+
+    SUBCASE("the cores partition the image") {
+        int area = 0;
+        for (const tile& t : tiles)
+            area += t.core.area();
+        CHECK(area == 100 * 50);
+
+        CHECK(tiles[0].core.x == 0);
+        CHECK(tiles[0].core.width == 33);
+        CHECK(tiles[1].core.x == 33);
+        CHECK(tiles[2].core.x + tiles[2].core.width == 100);
+        CHECK(tiles[3].core.y == 25);
+        CHECK(tiles[5].core.y + tiles[5].core.height == 50);
+    }
+    SUBCASE("the regions overlap within the image") {
+        // Top left tile.
+        CHECK(tiles[0].region.x == 0);
+        CHECK(tiles[0].region.y == 0);
+        CHECK(tiles[0].region.width == 38);
+        CHECK(tiles[0].region.height == 30);
+        // Bottom center tile.
+        CHECK(tiles[4].region.x == 28);
+        CHECK(tiles[4].region.y == 20);
+        CHECK(tiles[4].region.width == 43);
+        CHECK(tiles[4].region.height == 30);
+    }
+    SUBCASE("a single tile is the whole image") {
+        const vector<tile> single = make_tiles(100, 50, 1, 1, 5);
+        REQUIRE(single.size() == 1UL);
+        CHECK(single[0].region.area() == 100 * 50);
+        CHECK(single[0].core.area() == 100 * 50);
+    }
+}
+
+TEST_CASE("strongest keypoints") {
+    vector<cv::KeyPoint> points{{0.0F, 0.0F, 1.0F, -1.0F, 0.3F},
+                                {1.0F, 0.0F, 1.0F, -1.0F, 0.9F},
+                                {2.0F, 0.0F, 1.0F, -1.0F, 0.1F},
+                                {3.0F, 0.0F, 1.0F, -1.0F, 0.5F}};
+
+    auto strongest_end = partition_strongest(points, 2UL);
+    REQUIRE(strongest_end - points.begin() == 2);
+    vector<float> responses;
+    for (auto it = points.begin(); it != strongest_end; ++it)
+        responses.push_back(it->response);
+    sort(responses.begin(), responses.end());
+    CHECK(responses == vector<float>{0.5F, 0.9F});
+
+    CHECK(partition_strongest(points, 10UL) == points.end());
+}
+
+TEST_CASE("tiles to image coordinates") {
+    const vector<tile> tiles = make_tiles(100, 100, 1, 2, 10);
+    // The right tile starts at 'x = 40' with the core at 'x = 50'.
+    vector<cv::KeyPoint> points{{5.0F, 20.0F, 1.0F},
+                                {9.0F, 20.0F, 1.0F},
+                                {15.0F, 30.0F, 1.0F},
+                                {55.0F, 40.0F, 1.0F}};
+    to_image_coordinates(tiles[1], points, 2.0F);
+
+    REQUIRE(points.size() == 3UL);
+    CHECK(points[0].pt.x == 49.0F);
+    CHECK(points[1].pt.x == 55.0F);
+    CHECK(points[1].pt.y == 30.0F);
+    CHECK(points[2].pt.x == 95.0F);
+}
+
+TEST_CASE("merge tiles") {
+    vector<vector<cv::KeyPoint>> tile_points{
+        {{10.0F, 10.0F, 1.0F, -1.0F, 0.5F},
+         {49.5F, 10.0F, 1.0F, -1.0F, 0.8F},
+         {49.0F, 30.0F, 1.0F, -1.0F, 0.2F}},
+        {{50.0F, 10.0F, 1.0F, -1.0F, 0.6F},
+         {50.0F, 30.0F, 1.0F, -1.0F, 0.7F},
+         {51.0F, 30.0F, 1.0F, -1.0F, 0.1F},
+         {80.0F, 10.0F, 1.0F, -1.0F, 0.4F}}};
+
+    SUBCASE("duplicates of different tiles are removed") {
+        const vector<cv::KeyPoint> merged = merge_tiles(tile_points, 2.0F);
+        vector<float> responses;
+        for (const cv::KeyPoint& kp : merged)
+            responses.push_back(kp.response);
+        // The weaker duplicates '0.6' and '0.2' are removed, while '0.1'
+        // belongs to the same tile as its stronger neighbour '0.7'.
+        CHECK(responses == vector<float>{0.5F, 0.8F, 0.7F, 0.1F, 0.4F});
+    }
+    SUBCASE("without radius all keypoints are kept") {
+        CHECK(merge_tiles(tile_points, 0.0F).size() == 7UL);
+    }
+    SUBCASE("a single tile is kept as is") {
+        const gsl::span<const vector<cv::KeyPoint>> all{tile_points};
+        CHECK(merge_tiles(all.first(1)).size() == 3UL);
+    }
+}
@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+#include <sens_loc/io/feature.h>
+
+using namespace sens_loc;
+
+namespace {
+std::vector<cv::KeyPoint> make_keypoints() {
+    std::vector<cv::KeyPoint> keypoints;
+    for (int i = 0; i < 100; ++i)
+        keypoints.emplace_back(float(i % 10) * 12.5F, float(i / 10) * 7.25F,
+                               float(8 + i % 4), float(i * 3), 0.01F * i,
+                               i % 3, -1);
+    return keypoints;
+}
+}  // namespace
+
+TEST_CASE("Feature file paths") {
+    REQUIRE(io::is_binary_feature_path("sift-0001.slfeat"));
+    REQUIRE(!io::is_binary_feature_path("sift-0001.feature"));
+    REQUIRE(!io::is_binary_feature_path(".slfeat"));
+}
+
+TEST_CASE("Binary feature files") {
+    const std::vector<cv::KeyPoint> keypoints = make_keypoints();
+    // Binary descriptors with many repeated bytes are compressible.
+    cv::Mat descriptors(100, 32, CV_8UC1);
+    for (int r = 0; r < descriptors.rows; ++r)
+        for (int c = 0; c < descriptors.cols; ++c)
+            descriptors.at<uchar>(r, c) = c < 24 ? uchar(0) : uchar(r + c);
+
+    for (io::block_codec codec :
+         {io::block_codec::none, io::block_codec::lz4}) {
+        const std::string path = codec == io::block_codec::none
+                                     ? "io/features-raw.slfeat"
+                                     : "io/features-lz4.slfeat";
+        REQUIRE(io::write_features(path, "flexion-0001.png", keypoints,
+                                   descriptors, codec));
+
+        const io::feature_file f{path};
+        REQUIRE(f.is_open());
+        REQUIRE(f.source_path() == "flexion-0001.png");
+
+        const std::vector<cv::KeyPoint> loaded_kp = f.keypoints();
+        REQUIRE(loaded_kp.size() == keypoints.size());
+        for (std::size_t i = 0; i < keypoints.size(); ++i) {
+            CHECK(loaded_kp[i].pt.x == keypoints[i].pt.x);
+            CHECK(loaded_kp[i].pt.y == keypoints[i].pt.y);
+            CHECK(loaded_kp[i].size == keypoints[i].size);
+            CHECK(loaded_kp[i].angle == keypoints[i].angle);
+            CHECK(loaded_kp[i].response == keypoints[i].response);
+            CHECK(loaded_kp[i].octave == keypoints[i].octave);
+            CHECK(loaded_kp[i].class_id == keypoints[i].class_id);
+        }
+
+        const cv::Mat loaded_desc = f.descriptors();
+        REQUIRE(loaded_desc.type() == descriptors.type());
+        REQUIRE(cv::norm(loaded_desc, descriptors, cv::NORM_INF) == 0.);
+    }
+
+    SUBCASE("Keypoints without descriptors") {
+        REQUIRE(io::write_features("io/features-no-desc.slfeat", "",
+                                   keypoints, cv::Mat{}));
+        const io::feature_file f{"io/features-no-desc.slfeat"};
+        REQUIRE(f.is_open());
+        REQUIRE(f.source_path().empty());
+        REQUIRE(f.keypoints().size() == keypoints.size());
+        REQUIRE(f.descriptors().empty());
+    }
+    SUBCASE("Invalid files") {
+        const io::feature_file missing{"io/does-not-exist.slfeat"};
+        REQUIRE(!missing.is_open());
+        REQUIRE(missing.keypoints().empty());
+        REQUIRE(missing.descriptors().empty());
+        REQUIRE(!io::feature_file{"io/not_an_image.txt.slfeat"}.is_open());
+    }
+}
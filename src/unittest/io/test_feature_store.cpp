@@ -0,0 +1,86 @@
+#include <atomic>
+#include <doctest/doctest.h>
+#include <sens_loc/io/feature_store.h>
+#include <thread>
+
+using namespace sens_loc;
+
+namespace {
+std::vector<cv::KeyPoint> make_keypoints(int idx) {
+    std::vector<cv::KeyPoint> keypoints;
+    for (int i = 0; i < 10 * idx; ++i)
+        keypoints.emplace_back(float(i), float(idx), 4.F);
+    return keypoints;
+}
+cv::Mat make_descriptors(int idx) {
+    cv::Mat descriptors(10 * idx, 16, CV_32FC1);
+    for (int r = 0; r < descriptors.rows; ++r)
+        for (int c = 0; c < descriptors.cols; ++c)
+            descriptors.at<float>(r, c) = c < 8 ? 0.F : float(idx * r + c);
+    return descriptors;
+}
+}  // namespace
+
+TEST_CASE("Feature store paths") {
+    REQUIRE(io::is_feature_store_path("sift.slfseq"));
+    REQUIRE(!io::is_feature_store_path("sift-{}.slfeat"));
+    REQUIRE(!io::is_feature_store_path(".slfseq"));
+}
+
+TEST_CASE("Feature store") {
+    {
+        std::optional<io::feature_store_writer> writer =
+            io::feature_store_writer::create("io/features.slfseq", 1, 9);
+        REQUIRE(writer);
+
+        // Frames arrive concurrently and out of order, frame 5 is missing.
+        std::atomic<int>         failures{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t)
+            workers.emplace_back([&writer, &failures, t] {
+                for (int idx = 1 + t; idx <= 9; idx += 4)
+                    if (idx != 5 &&
+                        !writer->append(idx, "depth.slseq",
+                                        make_keypoints(idx),
+                                        make_descriptors(idx)))
+                        ++failures;
+            });
+        for (std::thread& w : workers)
+            w.join();
+        REQUIRE(failures == 0);
+
+        REQUIRE(!writer->append(3, "", {}, cv::Mat{}));
+        REQUIRE(!writer->append(10, "", {}, cv::Mat{}));
+        REQUIRE(writer->finish());
+    }
+
+    std::optional<io::feature_store> store =
+        io::feature_store::open("io/features.slfseq");
+    REQUIRE(store);
+    REQUIRE(store->first() == 1);
+    REQUIRE(store->last() == 9);
+    REQUIRE(store->size() == 9);
+    REQUIRE(!store->contains(5));
+    REQUIRE(!store->frame(5).is_open());
+    REQUIRE(!store->frame(0).is_open());
+
+    for (int idx = store->first(); idx <= store->last(); ++idx) {
+        if (idx == 5)
+            continue;
+        const io::feature_file f = store->frame(idx);
+        REQUIRE(f.is_open());
+        REQUIRE(f.source_path() == "depth.slseq");
+        const std::vector<cv::KeyPoint> keypoints = f.keypoints();
+        REQUIRE(keypoints.size() == std::size_t(10 * idx));
+        REQUIRE(keypoints.back().pt.y == float(idx));
+        REQUIRE(cv::norm(f.descriptors(), make_descriptors(idx),
+                         cv::NORM_INF) == 0.);
+    }
+
+    // Frames keep the mapping alive.
+    const io::feature_file last = store->frame(9);
+    store.reset();
+    REQUIRE(last.keypoints().size() == 90UL);
+
+    REQUIRE(!io::feature_store::open("io/not_an_image.txt"));
+}
@@ -16,3 +16,77 @@ TEST_CASE("Loading Images") {
         REQUIRE(file);
     }
 }
+
+TEST_CASE("Image formats by extension") {
+    REQUIRE(io::format_from_path("flexion-0001.png") == io::image_format::png);
+    REQUIRE(io::format_from_path("flexion-0001.PGM") == io::image_format::pnm);
+    REQUIRE(io::format_from_path("flexion-0001.ppm") == io::image_format::pnm);
+    REQUIRE(io::format_from_path("flexion-0001.pfm") == io::image_format::pfm);
+    REQUIRE(io::format_from_path("flexion-0001.slt") ==
+            io::image_format::tiles);
+    REQUIRE(io::format_from_path("flexion-0001.jpg") ==
+            io::image_format::other);
+    REQUIRE(io::format_from_path("slt") == io::image_format::other);
+}
+
+TEST_CASE("PNG encoder options") {
+    std::optional<math::image<uchar>> original =
+        io::load_image<uchar>("io/example-image.png", cv::IMREAD_UNCHANGED);
+    REQUIRE(original);
+
+    // Without options the fast defaults of OpenCV are used.
+    io::write_options options;
+    REQUIRE(!options.png_compression);
+    REQUIRE(!options.png_strategy);
+    REQUIRE(io::write_image("io/png-default.png", original->data(), options));
+
+    options.png_compression = 9;
+    options.png_strategy    = cv::IMWRITE_PNG_STRATEGY_FILTERED;
+    REQUIRE(io::write_image("io/png-options.png", original->data(), options));
+
+    for (const char* path : {"io/png-default.png", "io/png-options.png"}) {
+        std::optional<math::image<uchar>> loaded =
+            io::load_image<uchar>(path, cv::IMREAD_UNCHANGED);
+        REQUIRE(loaded);
+        REQUIRE(cv::norm(loaded->data(), original->data(), cv::NORM_INF) ==
+                0.);
+    }
+}
+
+TEST_CASE("Tile images") {
+    // The last tile is incomplete and the content is partially compressible.
+    cv::Mat original(101, 67, CV_16UC1);
+    for (int v = 0; v < original.rows; ++v)
+        for (int u = 0; u < original.cols; ++u)
+            original.at<ushort>(v, u) =
+                v < 50 ? ushort(1000) : ushort((v * 131 + u * 7919) % 65536);
+
+    io::write_options options;
+    options.tile_rows = 16;
+
+    SUBCASE("LZ4 compression") {
+        options.tile_compression = io::block_codec::lz4;
+        REQUIRE(io::write_image("io/tiles-lz4.slt", original, options));
+        std::optional<math::image<ushort>> loaded =
+            io::load_image<ushort>("io/tiles-lz4.slt", cv::IMREAD_UNCHANGED);
+        REQUIRE(loaded);
+        REQUIRE(cv::norm(loaded->data(), original, cv::NORM_INF) == 0.);
+    }
+    SUBCASE("Uncompressed region of interest") {
+        options.tile_compression = io::block_codec::none;
+        const cv::Mat roi = original(cv::Rect(3, 5, 40, 60));
+        REQUIRE(io::write_image("io/tiles-raw.slt", roi, options));
+        std::optional<math::image<ushort>> loaded =
+            io::load_image<ushort>("io/tiles-raw.slt");
+        REQUIRE(loaded);
+        REQUIRE(cv::norm(loaded->data(), roi, cv::NORM_INF) == 0.);
+    }
+    SUBCASE("Wrong pixel type") {
+        REQUIRE(io::write_image("io/tiles-type.slt", original, options));
+        REQUIRE(!io::load_image<float>("io/tiles-type.slt"));
+    }
+    SUBCASE("Not a tile image") {
+        REQUIRE(!io::load_image<ushort>("io/not_an_image.txt"));
+        REQUIRE(io::read_image("io/example-image.png.slt").empty());
+    }
+}
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sens_loc/io/pose.h>
 #include <sstream>
+#include <vector>
 
 using namespace sens_loc;
 using namespace std;
@@ -56,3 +57,108 @@ TEST_CASE("Loading Pose") {
         REQUIRE(!io::load_pose(fake_file));
     }
 }
+
+TEST_CASE("Loading Trajectory") {
+    SUBCASE("TUM format") {
+        string trajectory = "# ground truth trajectory\n"
+                            "# timestamp tx ty tz qx qy qz qw\n"
+                            "1305031102.1758 1.3405 0.6266 1.6575 0 0 0 1\n"
+                            "\n"
+                            "1305031102.1858 1.3303 0.6256 1.6464 "
+                            "0 0 0.7071068 0.7071068\n";
+        istringstream fake_file{trajectory};
+
+        optional<io::trajectory> t =
+            io::load_trajectory(fake_file, io::trajectory_format::tum);
+        REQUIRE(t);
+        REQUIRE(t->poses.size() == 2UL);
+        REQUIRE(t->timestamps.size() == 2UL);
+        CHECK(t->timestamps[1] == Approx(1305031102.1858));
+
+        CHECK(t->poses[0].isApprox(Eigen::Matrix4f{
+            (Eigen::Matrix4f() << 1.0F, 0.0F, 0.0F, 1.3405F, 0.0F, 1.0F, 0.0F,
+             0.6266F, 0.0F, 0.0F, 1.0F, 1.6575F, 0.0F, 0.0F, 0.0F, 1.0F)
+                .finished()}));
+        // Rotation by 90 degrees around the z-axis.
+        CHECK(t->poses[1](0, 1) == Approx(-1.0F));
+        CHECK(t->poses[1](1, 0) == Approx(+1.0F));
+        CHECK(t->poses[1](2, 2) == Approx(+1.0F));
+        CHECK(t->poses[1](2, 3) == Approx(+1.6464F));
+    }
+
+    SUBCASE("KITTI format") {
+        string trajectory = "1 0 0 0 0 1 0 0 0 0 1 0\n"
+                            "0.998332 -0.001389 -0.057713 -0.013973 "
+                            "0.001450 0.999998 0.001005 -0.006388 "
+                            "0.057711 -0.001087 0.998333 0.102325\n";
+        istringstream fake_file{trajectory};
+
+        optional<io::trajectory> t =
+            io::load_trajectory(fake_file, io::trajectory_format::kitti);
+        REQUIRE(t);
+        REQUIRE(t->poses.size() == 2UL);
+        CHECK(t->timestamps.empty());
+        CHECK(t->poses[0].isIdentity());
+        CHECK(t->poses[1](0, 0) == Approx(+0.998332F));
+        CHECK(t->poses[1](1, 3) == Approx(-0.006388F));
+        CHECK(t->poses[1](2, 3) == Approx(+0.102325F));
+        CHECK(t->poses[1](3, 3) == Approx(+1.0F));
+    }
+
+    SUBCASE("Malformed lines") {
+        istringstream missing_column{"1.0 1 2 3 0 0 0\n"};
+        CHECK(!io::load_trajectory(missing_column, io::trajectory_format::tum));
+
+        istringstream trailing_text{"1 0 0 0 0 1 0 0 0 0 1 0 pose\n"};
+        CHECK(
+            !io::load_trajectory(trailing_text, io::trajectory_format::kitti));
+
+        istringstream shearing{"10 0 0 0 0 1 0 0 0 0 1 0\n"};
+        CHECK(!io::load_trajectory(shearing, io::trajectory_format::kitti));
+
+        istringstream descending{"2.0 0 0 0 0 0 0 1\n"
+                                 "1.0 0 0 0 0 0 0 1\n"};
+        CHECK(!io::load_trajectory(descending, io::trajectory_format::tum));
+    }
+}
+
+TEST_CASE("Loading Timestamps") {
+    istringstream fake_file{"# depth maps\n"
+                            "1305031102.160407 depth/1305031102.160407.png\n"
+                            "1305031102.194330 depth/1305031102.194330.png\n"};
+    optional<vector<double>> times = io::load_timestamps(fake_file);
+    REQUIRE(times);
+    REQUIRE(times->size() == 2UL);
+    CHECK((*times)[0] == Approx(1305031102.160407));
+    CHECK((*times)[1] == Approx(1305031102.194330));
+
+    istringstream no_number{"depth/1305031102.160407.png\n"};
+    CHECK(!io::load_timestamps(no_number));
+}
+
+TEST_CASE("Associate Poses") {
+    io::trajectory t;
+    for (int i = 0; i < 5; ++i) {
+        math::pose_t p = math::pose_t::Identity();
+        p(0, 3)        = float(i);
+        t.poses.push_back(p);
+        t.timestamps.push_back(10.0 + 0.01 * i);
+    }
+
+    SUBCASE("Closest pose in time") {
+        const vector<double> frames{10.004, 10.026, 9.995, 10.049};
+        optional<vector<math::pose_t>> poses = io::associate_poses(t, frames);
+        REQUIRE(poses);
+        REQUIRE(poses->size() == frames.size());
+        CHECK((*poses)[0](0, 3) == 0.0F);
+        CHECK((*poses)[1](0, 3) == 3.0F);
+        CHECK((*poses)[2](0, 3) == 0.0F);
+        CHECK((*poses)[3](0, 3) == 4.0F);
+    }
+
+    SUBCASE("No pose within the time difference") {
+        const vector<double> frames{10.0, 10.5};
+        CHECK(!io::associate_poses(t, frames));
+        CHECK(io::associate_poses(t, frames, 1.0));
+    }
+}
@@ -0,0 +1,88 @@
+#include <doctest/doctest.h>
+#include <sens_loc/io/sequence.h>
+
+using namespace sens_loc;
+
+namespace {
+cv::Mat make_frame(int idx) {
+    cv::Mat frame(48, 64, CV_16UC1);
+    for (int v = 0; v < frame.rows; ++v)
+        for (int u = 0; u < frame.cols; ++u)
+            // Invalid depth values compress well.
+            frame.at<ushort>(v, u) =
+                v < 30 ? ushort(0) : ushort(idx * 1000 + v * 64 + u);
+    return frame;
+}
+}  // namespace
+
+TEST_CASE("Sequence container paths") {
+    REQUIRE(io::is_sequence_path("recording.slseq"));
+    REQUIRE(io::is_sequence_path("data/recording.slseq"));
+    REQUIRE(!io::is_sequence_path("depth-{:04d}.png"));
+    REQUIRE(!io::is_sequence_path(".slseq"));
+}
+
+TEST_CASE("Sequence container") {
+    const std::string intrinsic = "960 540\n519.4 519.4 480.0 270.0\n";
+
+    for (io::block_codec codec :
+         {io::block_codec::none, io::block_codec::lz4}) {
+        const std::string path = codec == io::block_codec::none
+                                     ? "io/sequence-raw.slseq"
+                                     : "io/sequence-lz4.slseq";
+        {
+            std::optional<io::sequence_writer> writer =
+                io::sequence_writer::create(path, 3, 7, intrinsic, codec);
+            REQUIRE(writer);
+            // Frames may arrive in any order and may be missing.
+            REQUIRE(writer->append(5, make_frame(5)));
+            REQUIRE(writer->append(3, make_frame(3)));
+            REQUIRE(writer->append(7, make_frame(7)));
+            REQUIRE(writer->append(4, make_frame(4)));
+
+            REQUIRE(!writer->append(4, make_frame(4)));
+            REQUIRE(!writer->append(8, make_frame(8)));
+            REQUIRE(!writer->append(2, make_frame(2)));
+            REQUIRE(!writer->append(6, cv::Mat(48, 64, CV_32FC1)));
+            REQUIRE(!writer->append(6, cv::Mat(24, 64, CV_16UC1)));
+            REQUIRE(writer->finish());
+        }
+
+        std::optional<io::depth_sequence> sequence =
+            io::depth_sequence::open(path);
+        REQUIRE(sequence);
+        REQUIRE(sequence->w() == 64);
+        REQUIRE(sequence->h() == 48);
+        REQUIRE(sequence->type() == CV_16UC1);
+        REQUIRE(sequence->first() == 3);
+        REQUIRE(sequence->last() == 7);
+        REQUIRE(sequence->size() == 5UL);
+        REQUIRE(sequence->intrinsic() == intrinsic);
+
+        REQUIRE(!sequence->contains(2));
+        REQUIRE(!sequence->contains(6));
+        REQUIRE(!sequence->contains(8));
+        REQUIRE(!sequence->load<ushort>(6));
+        REQUIRE(!sequence->load<float>(5));
+
+        for (int idx : {3, 4, 5, 7}) {
+            REQUIRE(sequence->contains(idx));
+            std::optional<math::image<ushort>> frame =
+                sequence->load<ushort>(idx);
+            REQUIRE(frame);
+            REQUIRE(cv::norm(frame->data(), make_frame(idx), cv::NORM_INF) ==
+                    0.);
+        }
+    }
+
+    SUBCASE("Invalid containers") {
+        REQUIRE(!io::depth_sequence::open("io/DoesNotExist.slseq"));
+        REQUIRE(!io::depth_sequence::open("io/not_an_image.txt"));
+
+        std::optional<io::sequence_writer> empty =
+            io::sequence_writer::create("io/sequence-empty.slseq", 0, 2);
+        REQUIRE(empty);
+        REQUIRE(!empty->finish());
+        REQUIRE(!io::depth_sequence::open("io/sequence-empty.slseq"));
+    }
+}
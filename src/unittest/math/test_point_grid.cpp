@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <doctest/doctest.h>
+#include <limits>
+#include <sens_loc/math/point_grid.h>
+#include <vector>
+
+using namespace sens_loc::math;
+using namespace std;
+
+TEST_CASE("point grid") {
+    const float         nan = numeric_limits<float>::quiet_NaN();
+    const imagepoints_t points{{10.0F, 10.0F}, {12.0F, 10.0F}, {8.0F, 10.0F},
+                               {40.0F, 40.0F}, {-3.0F, -4.0F}, {nan, 0.0F}};
+    point_grid grid{points, 5.0F};
+
+    SUBCASE("non-finite points are not inserted") {
+        CHECK(grid.size() == 5UL);
+        CHECK(!grid.erase(5));
+        CHECK(!grid.erase(-1));
+        CHECK(!grid.erase(6));
+    }
+
+    SUBCASE("nearest point within radius") {
+        CHECK(grid.nearest_within({10.5F, 10.0F}, 5.0F) == 0);
+        CHECK(grid.nearest_within({11.5F, 10.0F}, 5.0F) == 1);
+        CHECK(grid.nearest_within({39.0F, 41.0F}, 5.0F) == 3);
+        CHECK(grid.nearest_within({-1.0F, -1.0F}, 5.0F) == 4);
+        CHECK(!grid.nearest_within({25.0F, 25.0F}, 5.0F));
+    }
+
+    SUBCASE("the radius is exclusive") {
+        CHECK(!grid.nearest_within({45.0F, 40.0F}, 5.0F));
+        CHECK(grid.nearest_within({44.9F, 40.0F}, 5.0F) == 3);
+    }
+
+    SUBCASE("ties are resolved with the lowest index") {
+        CHECK(grid.nearest_within({11.0F, 10.0F}, 5.0F) == 0);
+        CHECK(grid.nearest_within({9.0F, 10.0F}, 5.0F) == 0);
+    }
+
+    SUBCASE("erased points are not found anymore") {
+        CHECK(grid.erase(0));
+        CHECK(!grid.erase(0));
+        CHECK(grid.size() == 4UL);
+        CHECK(grid.nearest_within({11.0F, 10.0F}, 5.0F) == 1);
+        CHECK(grid.nearest_within({9.0F, 10.0F}, 5.0F) == 2);
+
+        CHECK(grid.erase(1));
+        CHECK(grid.erase(2));
+        CHECK(!grid.nearest_within({10.0F, 10.0F}, 5.0F));
+    }
+
+    SUBCASE("all points within radius") {
+        vector<int> found;
+        grid.for_each_within({10.0F, 10.0F}, 2.5F,
+                             [&](int idx) { found.push_back(idx); });
+        sort(found.begin(), found.end());
+        CHECK(found == vector<int>{0, 1, 2});
+
+        // The radius is exclusive and erased points are skipped.
+        found.clear();
+        CHECK(grid.erase(2));
+        grid.for_each_within({10.0F, 10.0F}, 2.0F,
+                             [&](int idx) { found.push_back(idx); });
+        CHECK(found == vector<int>{0});
+    }
+
+    SUBCASE("nearest point without radius") {
+        CHECK(grid.nearest({10.0F, 10.0F}) == 0);
+        CHECK(grid.nearest({10.0F, 10.0F}, /*ignored=*/0) == 1);
+        CHECK(grid.nearest({40.0F, 40.0F}, /*ignored=*/3) == 1);
+        CHECK(grid.nearest({1000.0F, -1000.0F}) == 1);
+        CHECK(!grid.nearest({nan, 0.0F}));
+
+        point_grid single{imagepoints_t{{1.0F, 1.0F}}, 5.0F};
+        CHECK(single.nearest({500.0F, 500.0F}) == 0);
+        CHECK(!single.nearest({1.0F, 1.0F}, /*ignored=*/0));
+    }
+}
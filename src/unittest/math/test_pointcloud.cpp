@@ -176,3 +176,57 @@ TEST_CASE("pointcloud pose transformation") {
         REQUIRE(t[0].Z() == Approx(0.0F));
     }
 }
+
+TEST_CASE("structure of arrays pointcloud") {
+    const pointcloud_t points{
+        {2.0F, +3.0F, 31.0F},
+        {4.0F, +2.0F, 8.0F},
+        {9.0F, -2.0F, -10.0F},
+    };
+
+    SUBCASE("conversion keeps the points") {
+        const pointcloud_soa_t soa = to_soa(points);
+        REQUIRE(soa.cols() == 3);
+        CHECK(soa(0, 1) == 4.0F);
+        CHECK(soa(1, 2) == -2.0F);
+        CHECK(soa(2, 0) == 31.0F);
+
+        const pointcloud_t aos = to_aos(soa);
+        REQUIRE(aos.size() == points.size());
+        for (size_t i = 0; i < points.size(); ++i)
+            CHECK((aos[i] - points[i]).norm() == 0.0F);
+
+        const imagepoints_t     pixels{{2.0F, 3.0F}, {4.0F, 2.0F}};
+        const imagepoints_soa_t pixels_soa = to_soa(pixels);
+        REQUIRE(pixels_soa.cols() == 2);
+        CHECK(pixels_soa(0, 1) == 4.0F);
+        CHECK(pixels_soa(1, 0) == 3.0F);
+        CHECK(to_aos(pixels_soa)[1].v() == 2.0F);
+    }
+
+    SUBCASE("transformation equals the transformation of each point") {
+        string s0 = "0.956278 0.021462 -0.291671 -2.260386\n"
+                    "-0.021156 0.999767 0.004202 -0.605157\n"
+                    "0.291694 0.002153 0.956509 10.008457";
+        istringstream is0{s0};
+        auto          p = io::load_pose(is0);
+        REQUIRE(p);
+
+        const pointcloud_t     expected = *p * points;
+        const pointcloud_soa_t t        = transform(*p, to_soa(points));
+        REQUIRE(t.cols() == 3);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const auto col = Eigen::Index(i);
+            CHECK(t(0, col) == Approx(expected[i].X()));
+            CHECK(t(1, col) == Approx(expected[i].Y()));
+            CHECK(t(2, col) == Approx(expected[i].Z()));
+        }
+    }
+
+    SUBCASE("empty pointcloud") {
+        const pointcloud_soa_t t =
+            transform(pose_t::Identity(), pointcloud_soa_t(3, 0));
+        CHECK(t.cols() == 0);
+        CHECK(to_aos(t).empty());
+    }
+}